@@ -1,10 +1,11 @@
 #pragma once
 #include <string>
+#include "memtrack.h"
 
 /**
  * @brief Represents the Armor equipment
  */
-class Armor {
+class Armor : public TrackedAlloc<MemTag::ITEMS> {
 private:
 	std::string name;
 	int defenseBonus;
@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "encounter.h"
+
+/**
+ * @brief Totals of a batch of independent fights
+ */
+struct BatchResult {
+	uint64_t fights;
+	uint64_t playerWins;
+	uint64_t rounds;
+};
+
+/**
+ * @brief Resolves many independent one-on-one fights of the same matchup in lockstep
+ *
+ * Uses the same rules as combat() with the player always attacking:
+ * D20 hit checks against Encounter::PLAYER_HIT_ROLL / ENEMY_HIT_ROLL, damage of
+ * attack plus a D6 (player) or D4 (enemy), reduced by defense to a minimum of 1.
+ *
+ * Every lane of an AVX2 (8 lanes) or SSE4.1 (4 lanes) vector runs its own fight with
+ * its own xorshift stream. Finished lanes are masked out and refilled with the next
+ * fight. The scalar fallback runs the same lanes one by one and produces identical
+ * results for the same seed.
+ *
+ * @param player - Player stats including equipment bonuses; an opening bonus is not applied
+ * @param enemy - Enemy stats
+ * @param fights - Number of fights to resolve
+ * @param seed - Seed for the per-lane random streams
+ * @return BatchResult Totals over all fights
+ */
+BatchResult simulateBatch(const CombatStats& player, const CombatStats& enemy, uint64_t fights, uint64_t seed);
+
+/**
+ * @brief Name of the instruction set the batch kernel was compiled for
+ */
+const char* batchKernelName();
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "encounter.h"
+
+/**
+ * @brief Prototype of a kind of combatant
+ */
+struct Creature {
+	std::string name;
+	int hitPoints;   // Hit points of a fresh instance
+	int attack;
+	int defense;
+	Side side;
+	int mindAttack = 0;   // Attack penalty its mind attack puts on foes without a Mindshield
+};
+
+/**
+ * @brief Process-wide registry of creature prototypes
+ *
+ * Story definitions and encounters refer to creatures by ID, so a creature
+ * used in many scenes or many sessions is stored once, and an encounter slot
+ * only holds an ID and the hit points of its instance.
+ *
+ * Defining a creature identical to an existing one returns the existing ID.
+ * Prototypes are never removed or moved, so lookups need no lock while
+ * story reloads define new creatures on other threads.
+ */
+class Bestiary {
+public:
+	static constexpr size_t CHUNK_SIZE = 256;
+	static constexpr size_t MAX_CREATURES = size_t(1) << 20;
+	static constexpr CreatureID NONE = ~CreatureID(0);
+
+	/**
+	 * @brief Gets the ID of a creature, adding the prototype on first use
+	 *
+	 * @return CreatureID ID of the prototype, or NONE if the bestiary is full
+	 */
+	static CreatureID define(const std::string& name, int hitPoints, int attack, int defense, Side side, int mindAttack = 0);
+
+	/**
+	 * @brief Gets a prototype
+	 *
+	 * @param id - ID returned by define()
+	 */
+	static const Creature& get(CreatureID id);
+
+	/**
+	 * @brief Number of prototypes defined so far
+	 */
+	static size_t size();
+};
\ No newline at end of file
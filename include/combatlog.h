@@ -0,0 +1,146 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <span>
+#include <string>
+#include <vector>
+#include "encounter.h"
+
+/**
+ * @brief Kind of a combat event
+ */
+enum class CombatEventType : uint8_t {
+	BEGIN = 1,         // value = number of combatants
+	JOIN = 2,          // actor = combatant, value = its hit points, remaining = creature (log files only)
+	MINDBLAST = 3,     // value = attack bonus, remaining = rounds it lasts
+	MIND_ATTACK = 4,   // actor = attacker, value = attack penalty (0 = held off by a Mindshield)
+	HIT = 5,           // actor hits target: roll, value = damage dealt, remaining = target hit points
+	MISS = 6,          // actor misses target: roll
+	FLED = 7,          // Escape roll succeeded: roll
+	FLEE_FAILED = 8,   // Escape roll failed: roll
+	VICTORY = 9,
+	DEFEAT = 10,
+	CREATURE = 11      // Log files only: defines a creature, see CombatLog
+};
+
+/**
+ * @brief One thing that happened in a fight, 8 bytes in memory and in log files
+ *
+ * Actors and targets are combatant indices of the encounter, or PLAYER.
+ */
+struct CombatEvent {
+	static constexpr uint8_t PLAYER = 0xFF;
+
+	CombatEventType type;
+	uint8_t actor = 0;
+	uint8_t target = 0;
+	uint8_t roll = 0;      // D20 roll behind an attack or escape
+	int16_t value = 0;
+	int16_t remaining = 0;
+};
+static_assert(sizeof(CombatEvent) == 8, "combat events are written to log files as they are");
+
+/**
+ * @brief Receives the events of a fight as they happen
+ */
+class CombatSink {
+public:
+	virtual ~CombatSink() = default;
+	virtual void onEvent(const CombatEvent& event) = 0;
+};
+
+/**
+ * @brief Event stream of one fight
+ *
+ * Combat only emits events. A sink turns them into text when someone reads
+ * it; headless fights have no sink and never format anything. While a
+ * combat log is open the events are also kept and appended to the log as
+ * one fight when the stream is destroyed.
+ */
+class CombatStream {
+private:
+	const Encounter& encounter;
+	CombatSink* sink;
+	bool keep;
+	std::vector<CombatEvent> events;
+
+public:
+	/**
+	 * @brief Starts a fight and announces the combatants still standing
+	 *
+	 * @param fight - Encounter being fought, must outlive the stream
+	 * @param output - Sink for the events, or nullptr
+	 */
+	CombatStream(const Encounter& fight, CombatSink* output);
+
+	// Destructor
+	~CombatStream();
+
+	// Delete Copy Constructor - prevent copying
+	CombatStream(const CombatStream&) = delete;
+
+	// Delete Copy Assignment Operator - prevent assignment
+	CombatStream& operator=(const CombatStream&) = delete;
+
+	void emit(const CombatEvent& event);
+
+	/**
+	 * @brief Emits a HIT or MISS
+	 *
+	 * @param actor, target - Actor IDs of the attacker and the attacked
+	 * @param damage - Damage dealt after defense
+	 * @param remaining - Hit points of the target after the hit
+	 */
+	void attack(uint8_t actor, uint8_t target, int roll, bool hit, int damage = 0, int remaining = 0);
+
+	/**
+	 * @brief Emits a FLED or FLEE_FAILED
+	 */
+	void flee(int roll, bool escaped);
+
+	/**
+	 * @brief Emits a VICTORY or DEFEAT
+	 */
+	void end(bool won);
+
+	/**
+	 * @brief Actor ID of a combatant; encounters are far smaller than 255 combatants
+	 */
+	static uint8_t actorOf(size_t index);
+};
+
+/**
+ * @brief Binary log of every fight of the process
+ *
+ * A log starts with a header and holds the events of one fight after the
+ * other, each fight starting with a BEGIN event. The first time a creature
+ * appears, a CREATURE event (actor = side, roll = name length, value =
+ * attack, remaining = defense) followed by its hit points as int32 and its
+ * name defines it. JOIN events carry the number of their creature in the
+ * log, counting from 0 in the order of definition. Fights from several
+ * threads are appended whole.
+ */
+class CombatLog {
+public:
+	/**
+	 * @brief Starts logging fights to a file, replacing its contents
+	 *
+	 * @return bool False if the file could not be created
+	 */
+	static bool open(const std::string& path);
+	static void close();
+	static bool isOpen();
+
+	/**
+	 * @brief Appends one fight
+	 */
+	static void write(const Encounter& encounter, std::span<const CombatEvent> events);
+
+	/**
+	 * @brief Reads a log and prints the outcome of the fights per creature
+	 *
+	 * @param error - Receives the reason if the file is not a valid log
+	 */
+	static bool summarize(const std::string& path, std::ostream& out, std::string& error);
+};
\ No newline at end of file
@@ -0,0 +1,108 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <istream>
+#include <span>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief One command typed by the player
+ *
+ * A bare number ("2"), a word ("inv") or a word with a number ("equip 3").
+ */
+struct Command {
+	std::string verb;         // Lower case; empty for a bare number
+	long long number = 0;
+	bool hasNumber = false;
+	bool argument = false;    // Number given after a verb, answering the prompt that verb opens
+};
+
+/**
+ * @brief How a menu treats a verb
+ */
+enum class VerbUse {
+	OPTION,     // Selects the option; a number after the verb answers the prompt that follows
+	NUMBERED,   // The number after the verb is the option itself ("go 2")
+	FORWARD     // Selects the option and stays queued for the menu that option opens
+};
+
+/**
+ * @brief Word a menu understands in place of an option number
+ *
+ * The name "*" matches every verb the menu does not list.
+ */
+struct CommandVerb {
+	std::string_view name;
+	size_t option;
+	VerbUse use = VerbUse::OPTION;
+};
+
+/**
+ * @brief Splits the input of one session into commands
+ *
+ * Reads whole lines and parses them with std::from_chars. Commands on one
+ * line are separated by ';', ',' or plain spaces ("equip 3; drink 1; attack"
+ * or "1 1 2"), so scripted clients and remote players can send a whole
+ * turn at once. Commands left over from a line answer the next prompts
+ * before anything more is read; a line holds at most MAX_LINE_COMMANDS, so a
+ * client cannot queue prompts without bound.
+ */
+class CommandReader {
+public:
+	static constexpr size_t MAX_LINE_COMMANDS = 64;   // More on one line and the whole line is dropped
+
+private:
+	std::deque<Command> pending;
+	std::string line;
+	std::chrono::steady_clock::duration inputWait{};   // Time blocked reading lines
+
+public:
+	/**
+	 * @brief Parses one line into commands
+	 *
+	 * @param text - Line without its line break
+	 * @param out - Receives the commands in order
+	 * @return bool False if the line contains something that is not a command, or more than MAX_LINE_COMMANDS
+	 */
+	static bool parse(std::string_view text, std::deque<Command>& out);
+
+	/**
+	 * @brief Takes the next command, reading lines as needed
+	 *
+	 * Blank lines are skipped. A line that does not parse is dropped as a whole.
+	 *
+	 * @param in - Input stream of the session
+	 * @param command - Receives the command
+	 * @param malformed - Set when a line was dropped; the caller reports it
+	 * @return bool False at the end of input or after a dropped line
+	 */
+	bool next(std::istream& in, Command& command, bool& malformed);
+
+	/**
+	 * @brief Queues a command in front of the others
+	 */
+	void pushFront(Command command);
+
+	/**
+	 * @brief Drops the rest of the current line, e.g. after an invalid command
+	 */
+	void discard();
+
+	/**
+	 * @brief Total time next() spent waiting for lines, so callers can leave the player's think time out
+	 */
+	std::chrono::steady_clock::duration waited() const;
+};
+
+/**
+ * @brief Resolves a command against the verbs of a menu
+ *
+ * @param reader - Reader the command came from; receives a verb's argument or a forwarded command
+ * @param command - Command to resolve
+ * @param verbs - Verbs the menu understands
+ * @param option - Receives the selected option
+ * @return bool False if the menu does not understand the command
+ */
+bool resolveCommand(CommandReader& reader, const Command& command, std::span<const CommandVerb> verbs, size_t& option);
\ No newline at end of file
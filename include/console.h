@@ -0,0 +1,68 @@
+#pragma once
+#include <chrono>
+#include <istream>
+#include <ostream>
+#include "command.h"
+#include "gameevent.h"
+
+/**
+ * @brief Input, output and pacing of one player session
+ *
+ * The default host is the process terminal (std::cin / std::cout).
+ * Network sessions provide their own host while their game logic runs.
+ */
+class ConsoleHost {
+private:
+	CommandReader reader;
+
+public:
+	virtual ~ConsoleHost() = default;
+
+	virtual std::istream& in() = 0;
+	virtual std::ostream& out() = 0;
+
+	/**
+	 * @brief Waits without holding up other sessions
+	 */
+	virtual void pause(std::chrono::milliseconds duration) = 0;
+
+	/**
+	 * @brief Whether other sessions run on the same thread, so waits must go through pause()
+	 */
+	virtual bool sharesThread() const {
+		return false;
+	}
+
+	/**
+	 * @brief Tells the player about an event; formats it into out() unless the host presents it elsewhere
+	 */
+	virtual void publish(GameEvent&& event);
+
+	/**
+	 * @brief Commands the player of this session typed ahead
+	 */
+	CommandReader& commands();
+};
+
+/**
+ * @brief Access to the console of the session running on the calling thread
+ *
+ * Game code reads and writes through Console instead of std::cin and std::cout
+ * so the same code can serve a terminal or many network clients.
+ */
+class Console {
+public:
+	static std::istream& in();
+	static std::ostream& out();
+	static void pause(std::chrono::milliseconds duration);
+	static bool sharesThread();
+	static void publish(GameEvent event);
+	static CommandReader& commands();
+
+	/**
+	 * @brief Sets the host of the calling thread
+	 *
+	 * @param host - Session host, or nullptr for the process terminal
+	 */
+	static void setHost(ConsoleHost* host);
+};
\ No newline at end of file
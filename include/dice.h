@@ -0,0 +1,244 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "smallvector.h"
+#include "utility.h"
+
+/**
+ * @brief Test a dice expression ends with, if any
+ */
+enum class DiceCompare : uint8_t {
+	NONE = 0,
+	AT_LEAST = 1,   // >=
+	AT_MOST = 2,    // <=
+	ABOVE = 3,      // >
+	BELOW = 4,      // <
+	EQUAL = 5       // =
+};
+
+/**
+ * @brief Exact chance of every total of a dice expression
+ */
+struct DiceDistribution {
+	int minimum = 0;
+	std::vector<double> chances;   // chances[i] is the chance of a total of minimum + i
+
+	int maximum() const;
+	double chance(int total) const;
+	double mean() const;
+};
+
+/**
+ * @brief Rolls through rollDice(), the per-thread generator of played games
+ */
+struct ThreadDice {
+	int roll(int sides) const {
+		return rollDice(sides);
+	}
+};
+
+/**
+ * @brief Dice roll written in a small rules language, compiled once and rolled many times
+ *
+ * An expression sums terms and may end with a test:
+ *   1d20>=12    one twenty-sided die, passes on 12 or more
+ *   2d6+atk     two six-sided dice plus a variable bound when rolling
+ *   3d4kh2      three four-sided dice, keeping the highest two (kl keeps the lowest)
+ *   d8-1        a single die may leave out its count
+ * Tests are >=, <=, >, < and =, against a number or a variable.
+ *
+ * Compiling folds the constant terms and the variables and checks every
+ * limit, so rolling is a short loop over the dice terms, or a single call
+ * for the common expressions with one die. Rolls take any generator with an
+ * int roll(int sides) member, such as FastRng or ThreadDice; a batch roll
+ * fills an array of totals from one generator, a term at a time.
+ */
+class DiceExpression {
+public:
+	static constexpr int MAX_DICE = 32;          // Dice of one term
+	static constexpr int MAX_SIDES = 100;
+	static constexpr size_t MAX_TERMS = 16;
+	static constexpr size_t MAX_VARIABLES = 8;
+
+private:
+	/**
+	 * @brief Dice added or subtracted
+	 */
+	struct Term {
+		int8_t sign;         // 1 or -1
+		bool keepHighest;
+		int8_t count;        // Dice rolled
+		int8_t keep;         // Dice that count towards the total
+		int16_t sides;
+	};
+
+	std::string text;
+	int offset = 0;                   // Sum of the constant terms
+	SmallVector<Term, 2> terms;
+	int16_t singleDie = 0;            // Sides when the only term is one die added, else 0
+	DiceCompare compare = DiceCompare::NONE;
+	int threshold = 0;
+	int thresholdVariable = -1;       // Variable the test compares against, or -1 for threshold
+	size_t variableCount = 0;
+	std::array<int8_t, MAX_VARIABLES> weights{};   // Times each variable is added, less the times it is subtracted
+
+	int fixedPart(const int* values) const {
+		int total = offset;
+		for (size_t i = 0; i < variableCount; ++i) {
+			total += weights[i] * values[i];
+		}
+		return total;
+	}
+
+	template <typename Rng>
+	static int rollTerm(Rng& rng, const Term& term) {
+		if (term.keep == term.count) {
+			int sum = 0;
+			for (int i = 0; i < term.count; ++i) {
+				sum += rng.roll(term.sides);
+			}
+			return sum;
+		}
+		int rolls[MAX_DICE];
+		for (int i = 0; i < term.count; ++i) {
+			rolls[i] = rng.roll(term.sides);
+		}
+		if (term.keepHighest) {
+			std::nth_element(rolls, rolls + term.keep, rolls + term.count, std::greater<int>());
+		}
+		else {
+			std::nth_element(rolls, rolls + term.keep, rolls + term.count);
+		}
+		int sum = 0;
+		for (int i = 0; i < term.keep; ++i) {
+			sum += rolls[i];
+		}
+		return sum;
+	}
+
+	template <typename Rng>
+	int rollTerms(Rng& rng) const {
+		int total = 0;
+		for (const Term& term : terms) {
+			total += term.sign * rollTerm(rng, term);
+		}
+		return total;
+	}
+
+	/**
+	 * @brief Exact distribution of one term's dice before its sign
+	 */
+	static DiceDistribution termDistribution(const Term& term);
+
+public:
+	/**
+	 * @brief Parses an expression
+	 *
+	 * @param source - Expression as written
+	 * @param variables - Names the expression may use, bound in this order when rolling
+	 * @param expression - Receives the compiled expression
+	 * @param error - Receives a description of the problem on failure
+	 * @return bool True on success
+	 */
+	static bool compile(std::string_view source, std::initializer_list<std::string_view> variables,
+		DiceExpression& expression, std::string& error);
+
+	const std::string& getText() const;
+	bool hasTest() const;
+
+	/**
+	 * @brief Sides of the largest die the expression rolls
+	 */
+	int largestDie() const;
+
+	/**
+	 * @brief Rolls the expression once
+	 *
+	 * @param values - Values of the variables, in the order they were compiled with
+	 * @return int Total of the terms; the test is left to succeeds()
+	 */
+	template <typename Rng>
+	int roll(Rng&& rng, std::initializer_list<int> values = {}) const {
+		assert(values.size() >= variableCount);
+		int total = fixedPart(values.begin());
+		if (singleDie > 0) {
+			return total + rng.roll(singleDie);
+		}
+		return total + rollTerms(rng);
+	}
+
+	/**
+	 * @brief Rolls the expression once for every total, consuming the generator a term at a time
+	 */
+	template <typename Rng>
+	void rollBatch(Rng&& rng, std::span<int> totals, std::initializer_list<int> values = {}) const {
+		assert(values.size() >= variableCount);
+		int fixed = fixedPart(values.begin());
+		if (singleDie > 0) {
+			for (int& total : totals) {
+				total = fixed + rng.roll(singleDie);
+			}
+			return;
+		}
+		std::fill(totals.begin(), totals.end(), fixed);
+		for (const Term& term : terms) {
+			for (int& total : totals) {
+				total += term.sign * rollTerm(rng, term);
+			}
+		}
+	}
+
+	/**
+	 * @brief Whether a total passes the expression's test; always true without one
+	 */
+	bool succeeds(int total, std::initializer_list<int> values = {}) const {
+		int target = thresholdVariable >= 0 ? values.begin()[thresholdVariable] : threshold;
+		switch (compare) {
+		case DiceCompare::AT_LEAST:
+			return total >= target;
+		case DiceCompare::AT_MOST:
+			return total <= target;
+		case DiceCompare::ABOVE:
+			return total > target;
+		case DiceCompare::BELOW:
+			return total < target;
+		case DiceCompare::EQUAL:
+			return total == target;
+		default:
+			return true;
+		}
+	}
+
+	/**
+	 * @brief Exact chance of every total
+	 *
+	 * Sums are convolved a die at a time; kept dice are counted by how many
+	 * dice show each face, so no roll is ever enumerated.
+	 */
+	DiceDistribution distribution(std::initializer_list<int> values = {}) const;
+
+	/**
+	 * @brief Exact chance that a roll passes the test
+	 */
+	double successChance(std::initializer_list<int> values = {}) const;
+};
+
+/**
+ * @brief Prints the exact distribution of an expression next to the totals of a batch of rolls
+ *
+ * @param source - Expression without variables
+ * @param rolls - Rolls of the batch
+ * @param error - Receives a description of the problem on failure
+ * @return bool True on success
+ */
+bool printDiceReport(std::string_view source, size_t rolls, std::ostream& out, std::string& error);
\ No newline at end of file
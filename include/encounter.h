@@ -0,0 +1,165 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "dice.h"
+#include "memtrack.h"
+
+// Forward declarations
+class FastRng;
+class CombatStream;
+
+/**
+ * @brief Which side of an encounter a combatant fights on
+ */
+enum class Side : uint8_t {
+	ALLY = 0,
+	ENEMY = 1
+};
+
+/**
+ * @brief Index of a creature prototype in the Bestiary
+ */
+using CreatureID = uint32_t;
+
+/**
+ * @brief Combat stats of a single fighter
+ */
+struct CombatStats {
+	int hitPoints;
+	int attack;
+	int defense;
+	int openingBonus = 0;    // Attack added in the first openingRounds rounds, e.g. by Mindblast
+	int openingRounds = 0;
+};
+
+/**
+ * @brief Rolls of every combat resolver, compiled once from the Encounter rules
+ *
+ * Hit rolls total a D20 and pass on the hit thresholds; damage rolls add the
+ * attacker's attack, bound as "atk".
+ */
+struct CombatDice {
+	DiceExpression playerHit;      // 1d20>=PLAYER_HIT_ROLL, also for allies
+	DiceExpression enemyHit;       // 1d20>=ENEMY_HIT_ROLL
+	DiceExpression flee;           // 1d20>=FLEE_ROLL
+	DiceExpression playerDamage;   // 1dPLAYER_DAMAGE_DIE+atk, also for allies
+	DiceExpression enemyDamage;    // 1dENEMY_DAMAGE_DIE+atk
+};
+
+/**
+ * @brief Result of a headless encounter simulation
+ */
+struct EncounterResult {
+	bool playerWon;
+	int rounds;
+	int playerHitPoints;
+};
+
+/**
+ * @brief Group of combatants fighting alongside or against the player
+ *
+ * Each combatant is an instance of a Bestiary prototype: the encounter stores
+ * only the prototype ID and the instance's hit points, as parallel arrays, so
+ * respawning or resetting a combatant is a single write. Names, stats and sides
+ * are read from the prototype. The player is not stored here; allies fight on
+ * the player's side.
+ *
+ * Round order: player, then every living ally, then every living enemy.
+ * Allies focus the weakest living enemy. Enemies spread their attacks over
+ * the player and the living allies.
+ */
+class Encounter {
+private:
+	TrackedVector<CreatureID, MemTag::WORLD> creatures;
+	TrackedVector<int, MemTag::WORLD> hitPoints;
+
+public:
+	// Hit thresholds on a D20 and damage dice shared by every combat resolver
+	static constexpr int PLAYER_HIT_ROLL = 5;
+	static constexpr int ENEMY_HIT_ROLL = 8;
+	static constexpr int FLEE_ROLL = 12;
+	static constexpr int PLAYER_DAMAGE_DIE = 6;
+	static constexpr int ENEMY_DAMAGE_DIE = 4;
+
+	/**
+	 * @brief The rules above as dice expressions
+	 */
+	static const CombatDice& dice();
+
+	/**
+	 * @brief Adds a fresh instance of a creature to the encounter
+	 *
+	 * @param creature - Prototype from the Bestiary
+	 * @return size_t Index of the new combatant
+	 */
+	size_t addCombatant(CreatureID creature);
+
+	size_t size() const;
+	CreatureID getCreature(size_t index) const;
+	const std::string& getName(size_t index) const;
+	int getHitPoints(size_t index) const;
+	int getMaxHitPoints(size_t index) const;
+	int getAttackValue(size_t index) const;
+	int getDefenseValue(size_t index) const;
+	Side getSide(size_t index) const;
+	bool isAlive(size_t index) const;
+
+	/**
+	 * @brief Applies damage to a combatant after defense calculation
+	 *
+	 * @return int Damage actually dealt
+	 */
+	int takeDamage(size_t index, int damage);
+
+	/**
+	 * @brief Sets hit points directly, e.g. when restoring a saved game
+	 */
+	void setHitPoints(size_t index, int hp);
+
+	/**
+	 * @brief Brings every combatant back at full hit points
+	 */
+	void reset();
+
+	/**
+	 * @brief Counts combatants of a side that are still standing
+	 */
+	size_t countLiving(Side side) const;
+
+	/**
+	 * @brief Finds the living enemy with the lowest hit points
+	 *
+	 * @return size_t Combatant index, or size() if no enemy is alive
+	 */
+	size_t weakestEnemy() const;
+
+	/**
+	 * @brief Finds the living enemy with the strongest mind attack
+	 *
+	 * @return size_t Combatant index, or size() if no living enemy has a mind attack
+	 */
+	size_t mindAttacker() const;
+	int getMindAttack(size_t index) const;
+
+	/**
+	 * @brief Picks the target of an enemy attack
+	 *
+	 * @param attacker - Index of the attacking enemy
+	 * @return size_t Index of an ally, or size() when the player is targeted
+	 */
+	size_t enemyTarget(size_t attacker) const;
+
+	/**
+	 * @brief Resolves the whole encounter without any output or pacing
+	 *
+	 * The player attacks the weakest enemy every round. The encounter itself is
+	 * left untouched so it can be simulated repeatedly.
+	 *
+	 * @param player - Player stats including equipment bonuses and the opening bonus of a skill
+	 * @param rng - Random source for every roll
+	 * @param events - Receives every attack and the outcome, or nullptr
+	 * @return EncounterResult Outcome of the fight
+	 */
+	EncounterResult simulate(const CombatStats& player, FastRng& rng, CombatStream* events = nullptr) const;
+};
\ No newline at end of file
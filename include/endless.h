@@ -0,0 +1,77 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "encounter.h"
+#include "story.h"
+
+/**
+ * @brief Endless lands beyond the end of a story, generated from a seed
+ *
+ * Scene numbers from FIRST_SCENE on are coordinates: every depth has LANES
+ * scenes, and every choice leads one depth further. A scene is a pure
+ * function of the seed and its number, so a scene that was thrown away is
+ * generated again exactly as it was, and a game keeps only the scenes near
+ * the player however far it goes.
+ *
+ * Enemies are the story's own creatures, made stronger every TIER_DEPTH scenes.
+ */
+class EndlessRealm {
+public:
+	static constexpr int FIRST_SCENE = 1'000'000;   // Numbers below belong to stories
+	static constexpr int LANES = 3;
+	static constexpr int TIER_DEPTH = 25;           // Depths between two strength tiers
+	static constexpr int MAX_TIER = 20;
+
+private:
+	uint64_t seed;
+	std::vector<CreatureID> pool;     // Enemies of the story, in scene order
+	std::vector<CreatureID> scaled;   // Prototype per tier and pool entry, defined on first use
+
+	/**
+	 * @brief Gets an enemy of the pool made stronger for a tier
+	 */
+	CreatureID scaledEnemy(size_t index, int tier);
+
+public:
+	/**
+	 * @brief Prepares the lands beyond a story
+	 *
+	 * @param seed - Seed every scene is generated from
+	 * @param story - Story whose enemies roam the lands
+	 */
+	EndlessRealm(uint64_t seed, const Story& story);
+
+	// Delete Copy Constructor - prevent copying
+	EndlessRealm(const EndlessRealm&) = delete;
+
+	// Delete Copy Assignment Operator - prevent assignment
+	EndlessRealm& operator=(const EndlessRealm&) = delete;
+
+	/**
+	 * @brief Whether a scene number belongs to the generated lands
+	 */
+	static bool contains(int number);
+
+	/**
+	 * @brief Number of scenes between the first generated scene and this one
+	 */
+	static int depthOf(int number);
+
+	/**
+	 * @brief Scene number of a coordinate, or 0 past the last representable depth
+	 */
+	static int sceneAt(int depth, int lane);
+
+	/**
+	 * @brief Generates the definition of a scene
+	 *
+	 * Reuses the buffers of the definition, so generating into the same
+	 * definition over and over allocates little.
+	 *
+	 * @param number - Scene number inside the generated lands
+	 * @param def - Receives the definition
+	 */
+	void generate(int number, SceneDef& def);
+};
\ No newline at end of file
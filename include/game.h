@@ -1,21 +1,138 @@
 #pragma once
+#include <deque>
 #include <map>
+#include <memory>
 #include <string>
-#include "SceneID.h"
-#include "Scene.h"
-#include "Player.h"
+#include <vector>
+#include "sceneID.h"
+#include "scene.h"
+#include "player.h"
+#include "story.h"
+#include "gamestate.h"
+
+// Forward declarations
+class StoryFile;
+class Journal;
+class EndlessRealm;
+class JournalSession;
+class RunStore;
+class Leaderboard;
+struct SavedGame;
+struct RunRecord;
 
 /**
  * @brief Main game controller class
  *
  * Manages all game scenes, the player character, and the game loop.
  * Responsible for setting up the game world and orchestrating gameplay flow.
+ * Scenes are built from the story the first time they are entered or a
+ * choice leading to them is followed.
  */
-class Game {
+class Game : public SceneDirectory {
 private:
-	std::map<SceneID, Scene*> scenes;
+	std::map<int, Scene*> scenes;   // Scenes built so far
 	Scene* currentScene = nullptr;
 	Player* player = nullptr;
+	std::shared_ptr<const Story> story;
+	StoryFile* storySource = nullptr;
+	Journal* journal = nullptr;
+	std::unique_ptr<JournalSession> journalSession;
+	std::deque<GameState> history;   // State at the start of each recent turn, oldest first
+	size_t rewindLimit = 0;          // Turns that can be rewound (0 = rewinding disabled)
+	std::unique_ptr<EndlessRealm> endless;   // Generated lands past the story (nullptr = off)
+	uint64_t endlessSeed = 0;
+	bool endlessMode = false;
+	int endlessGate = 0;             // Ending that leads into the generated lands (0 = none)
+	SceneDef generated;              // Definition of the last generated scene, reused
+	RunStore* runStore = nullptr;    // History every finished run is added to (nullptr = none)
+	Leaderboard* leaderboard = nullptr;   // Live rankings shared with other sessions (nullptr = none)
+	int rankedEnding = 0;            // Ending a run must reach alive to be ranked (0 = any)
+
+	/**
+	 * @brief Looks up the definition of a scene of the story or the generated lands
+	 *
+	 * @return const SceneDef* Definition valid until the next call, or nullptr if there is no such scene
+	 */
+	const SceneDef* findDef(int id);
+
+	/**
+	 * @brief Destroys generated scenes too far behind the player
+	 *
+	 * They are generated again from the seed if the game ever returns to them.
+	 * Their world state goes too, from the journal and from the history entry
+	 * the next turns fork, so neither grows with the depth reached. Older
+	 * history entries keep it until they are dropped, so rewinding to them
+	 * still restores those scenes.
+	 */
+	void evictBehind();
+
+	/**
+	 * @brief Moves the session to the latest published story version
+	 *
+	 * Only happens when the current scene still exists in the new version;
+	 * otherwise the session keeps playing the version it started with.
+	 * Scenes that did not change keep their world state.
+	 */
+	void refreshStory();
+
+	/**
+	 * @brief Builds a scene with its encounter, loot and choices from its definition
+	 */
+	Scene* buildScene(const SceneDef& def);
+
+	/**
+	 * @brief Recreates the player and the world state of an unfinished journaled game
+	 *
+	 * @param saved - Recovered state of the game
+	 */
+	void resumePlayer(const SavedGame& saved);
+
+	/**
+	 * @brief Brings one scene to a saved world state, refilling loot taken since
+	 */
+	void restoreScene(Scene& scene, const SceneState& state);
+
+	/**
+	 * @brief Adds the state at the start of the current turn to the history
+	 *
+	 * Forks the previous entry and updates only what the last turn could change:
+	 * the player and the scene that was played, so each entry costs a few nodes.
+	 *
+	 * @param playedScene - Number of the scene played last turn (0 = none)
+	 */
+	void recordTurn(int playedScene);
+
+	/**
+	 * @brief Goes back to a history entry and forgets the turns after it
+	 *
+	 * Only scenes that differ from the target are restored.
+	 *
+	 * @param index - History entry to return to
+	 * @param playedScene - Number of the scene played since the latest entry
+	 */
+	void rewindTo(size_t index, int playedScene);
+
+	/**
+	 * @brief Offers to rewind after the player died or reached an ending
+	 *
+	 * @param playedScene - Number of the scene whose turn ended the game
+	 * @return bool True if turns were rewound and the game goes on
+	 */
+	bool offerRewind(int playedScene);
+
+	/**
+	 * @brief Adds the enemies a turn killed to the kills of a run and, if the player died, who did it to the run
+	 *
+	 * @param kills - Names of the enemies killed so far, in order
+	 * @param played - Scene of the turn
+	 * @param living - Enemies of the scene alive before the turn
+	 */
+	void tallyTurn(RunRecord& run, std::vector<std::string>& kills, const Scene& played, const std::vector<size_t>& living) const;
+
+	/**
+	 * @brief Ranks a finished run and shows the top of every leaderboard with the player's rank
+	 */
+	void rankRun(const RunRecord& run);
 
 public:
 	// Constructor
@@ -30,9 +147,21 @@ public:
 	// Delete Copy Assignment Operator - prevent assignment
 	Game& operator=(const Game&) = delete;
 
-	Scene* createScene(SceneID id, const std::string& description);
-	Scene* getScene(SceneID id);
-	void setStartScene(SceneID id);
+	Scene* createScene(int id, const std::string& description);
+
+	/**
+	 * @brief Gets a scene of the current story, building it on first use
+	 *
+	 * @param id - Scene number
+	 * @return Scene* The scene, or nullptr if the story has no such scene
+	 */
+	Scene* getScene(int id) override;
+
+	/**
+	 * @brief Links to generated scenes are not cached, as those scenes may be evicted
+	 */
+	bool keepsScene(int id) const override;
+	void setStartScene(int id);
 
 	/**
 	 * @brief Creates the player character with starting equipment
@@ -46,11 +175,99 @@ public:
 	/**
 	 * @brief Sets up the entire game storyline
 	 *
-	 * Creates all scenes, enemies, items, and establishes the connections
-	 * between different scenes. Implemented in Game.cpp.
+	 * Defines all scenes, enemies, items, and the connections between
+	 * different scenes, then builds the game world from them. Implemented in Game.cpp.
 	 */
 	void setStoryline();
 
+	/**
+	 * @brief Definitions of the built-in storyline, built on first use and shared by every game of the process
+	 */
+	static std::shared_ptr<const Story> builtinStoryline();
+
+	/**
+	 * @brief Builds the game world from a story definition
+	 *
+	 * @param newStory - Story version to play
+	 */
+	void applyStory(std::shared_ptr<const Story> newStory);
+
+	/**
+	 * @brief Plays a story loaded from a file and follows its hot reloads
+	 *
+	 * @param source - Loaded story file, must outlive the game
+	 */
+	void setStorySource(StoryFile* source);
+
+	const Story* getStory() const;
+
+	/**
+	 * @brief Records the game in a journal so it can be resumed after a crash
+	 *
+	 * A player entering the name of an unfinished journaled game continues it.
+	 *
+	 * @param target - Open journal, must outlive the game
+	 */
+	void setJournal(Journal* target);
+
+	/**
+	 * @brief Lets the player rewind recent turns
+	 *
+	 * The history shares everything that did not change between turns, so
+	 * keeping many turns costs far less than as many copies of the game.
+	 *
+	 * @param turns - Number of turns that can be rewound (0 = disabled)
+	 */
+	void setRewindLimit(size_t turns);
+
+	/**
+	 * @brief Continues the game past the story's ending into endlessly generated lands
+	 *
+	 * Only scenes near the player are kept, so memory stays the same however
+	 * far the player travels.
+	 *
+	 * @param seed - Seed the lands are generated from; the same seed gives the same lands
+	 */
+	void setEndless(uint64_t seed);
+
+	/**
+	 * @brief Adds every finished run to a history of runs
+	 *
+	 * @param store - Open store, must outlive the game
+	 */
+	void setRunStore(RunStore* store);
+
+	/**
+	 * @brief Ranks every run that reaches the end of the story alive
+	 *
+	 * @param board - Rankings shared by the sessions of the process, must outlive the game
+	 */
+	void setLeaderboard(Leaderboard* board);
+
+	/**
+	 * @brief Prints the highlights of a run history for the current story
+	 *
+	 * Endings the player has not seen yet, the best and fastest run to every
+	 * ending and the deadliest enemies and scenes, all from indexes.
+	 *
+	 * @param player - Name of the player whose unseen endings are listed
+	 */
+	void reportRuns(const RunStore& store, const std::string& player) const;
+
+	/**
+	 * @brief Takes a forkable snapshot of the player, the current scene and the world
+	 *
+	 * @return GameState Snapshot that shares nothing mutable with the game
+	 */
+	GameState captureState() const;
+
+	/**
+	 * @brief Puts the player and the world back into a captured state
+	 *
+	 * @param state - State captured from this game or forked from such a state
+	 */
+	void restoreState(const GameState& state);
+
 	/**
 	 * @brief Executes the main game loop
 	 *
@@ -61,4 +278,26 @@ public:
 	 * 4. Continues until game end or player death
 	 */
 	void run();
+
+	/**
+	 * @brief Resolves every encounter of the storyline headless and prints win rates
+	 *
+	 * Uses a fresh character with starting equipment and no output or pacing.
+	 * One-on-one encounters are also run through the batch combat kernel.
+	 *
+	 * @param trials - Number of fights simulated per encounter
+	 */
+	void simulateEncounters(int trials);
+
+	/**
+	 * @brief Explores what could happen from the start of the storyline
+	 *
+	 * Walks the story breadth first with a fresh character. Every choice, both
+	 * outcomes of a roll check and several sampled outcomes of each fight fork
+	 * the game state, so all branches are alive at once and share what they
+	 * have in common. Prints how the branches ended.
+	 *
+	 * @param maxBranches - Number of branches to explore before stopping
+	 */
+	void exploreBranches(size_t maxBranches);
 };
\ No newline at end of file
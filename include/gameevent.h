@@ -0,0 +1,39 @@
+#pragma once
+#include <ostream>
+#include <string>
+#include "story.h"
+
+/**
+ * @brief Kind of something the game tells the player
+ */
+enum class GameEventType {
+	TEXT,            // text = output as it was written
+	PAUSE,           // value = milliseconds of dramatic pause
+	SCENE_ENTERED,   // value = scene number, text = the laid out scene
+	LOOT_RECEIVED,   // Loot follows
+	ITEM_FOUND,      // kind, text = item name, value = bonus
+	ITEM_ADDED,      // kind, text = item name
+	ITEM_EQUIPPED,   // kind, text = item name
+	DAMAGE_TAKEN,    // text = player name, value = damage, hitPoints / maxHitPoints after it
+	HEALED           // text = player name, value = amount, hitPoints / maxHitPoints after it
+};
+
+/**
+ * @brief Something the game tells the player, formatted only when presented
+ *
+ * Events carry copies of everything they show, so they can be presented
+ * on another thread while the game goes on changing its state.
+ */
+struct GameEvent {
+	GameEventType type = GameEventType::TEXT;
+	std::string text{};
+	int value = 0;
+	ItemKind kind = ItemKind::WEAPON;
+	int hitPoints = 0;
+	int maxHitPoints = 0;
+};
+
+/**
+ * @brief Formats an event as text; pauses are left to the host
+ */
+void presentEvent(const GameEvent& event, std::ostream& out);
\ No newline at end of file
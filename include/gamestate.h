@@ -0,0 +1,110 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "persistent.h"
+#include "story.h"
+
+/**
+ * @brief Item held by the player
+ */
+struct ItemState {
+	std::string name;
+	int value;   // Attack, defense or heal amount depending on the inventory
+};
+
+/**
+ * @brief World state of one scene that differs from its definition
+ */
+struct SceneState {
+	std::vector<int> hitPoints;   // Combatant hit points by index (-1 = untouched)
+	bool looted = false;
+
+	bool operator==(const SceneState&) const = default;
+};
+
+/**
+ * @brief Stats, inventory and equipment of the player
+ *
+ * Inventories are shared between copies until one of them changes.
+ */
+struct PlayerState {
+	int hitPoints = 0;
+	int maxHitPoints = 0;
+	int attack = 0;
+	int defense = 0;
+	CowPtr<std::vector<ItemState>> weapons;
+	CowPtr<std::vector<ItemState>> armor;
+	CowPtr<std::vector<ItemState>> potions;
+	int equippedWeapon = -1;   // Index into weapons (-1 = none)
+	int equippedArmor = -1;    // Index into armor (-1 = none)
+	uint32_t skills = 0;       // Learned skills, one bit per Skill
+	int potionsUsed = 0;       // Potions drunk so far; not journaled, so a resumed game counts from 0
+
+	const std::vector<ItemState>& inventory(ItemKind kind) const;
+	std::vector<ItemState>& editInventory(ItemKind kind);
+
+	/**
+	 * @brief Equipped index of an inventory, or nullptr for potions
+	 */
+	int* equippedSlot(ItemKind kind);
+
+	int totalAttack() const;
+	int totalDefense() const;
+};
+
+/**
+ * @brief Value snapshot of a game that can be forked cheaply
+ *
+ * Copying a GameState is O(1): the player and every scene state are shared
+ * with the original until one side changes them, and a change copies only
+ * the changed player or scene plus a few small index nodes. Many branches of
+ * one game can therefore be kept at once for previews, solvers or history.
+ */
+class GameState {
+private:
+	int scene = 0;
+	CowPtr<PlayerState> player;
+	PersistentArray<SceneState> world;   // By scene number; scenes never changed read as untouched
+	size_t routeLength = 0;              // Scenes the run had played when the state was taken
+	size_t killCount = 0;                // Enemies the run had killed when the state was taken
+
+public:
+	int getScene() const;
+	void setScene(int number);
+
+	size_t getRouteLength() const;
+	size_t getKillCount() const;
+
+	/**
+	 * @brief Records how far the run had got, so going back to the state can forget what came after
+	 */
+	void setRunProgress(size_t scenesPlayed, size_t enemiesKilled);
+
+	const PlayerState& getPlayer() const;
+	PlayerState& editPlayer();
+
+	const SceneState& getSceneState(int number) const;
+	void setSceneState(int number, SceneState state);
+
+	/**
+	 * @brief Forgets the state of the scenes numbered [first, last), as if they were never changed
+	 */
+	void clearSceneStates(int first, int last);
+
+	/**
+	 * @brief Calls visit(sceneNumber) for every scene whose state differs from another state
+	 *
+	 * Scenes both states still share are skipped, so comparing two states of the
+	 * same game costs time proportional to what changed between them.
+	 */
+	template <typename Visit>
+	void forEachChangedScene(const GameState& other, Visit&& visit) const {
+		world.forEachDifference(other.world, [&](size_t index) {
+			visit(static_cast<int>(index));
+		});
+	}
+
+	bool sharesPlayerWith(const GameState& other) const;
+};
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Name of an item, interned in a table shared by the whole process
+ *
+ * An item carries only the four-byte number of its name, so carried items
+ * stay small enough to keep inline. The table only grows: item names come
+ * from the story, the endless generator and saved games, so it stays as
+ * small as the set of distinct names. Interning takes a lock; reading a name
+ * does not.
+ */
+class ItemName {
+private:
+	uint32_t id = 0;   // 0 is the empty name
+
+public:
+	// Constructor
+	ItemName() = default;
+
+	/**
+	 * @brief Interns a name, reusing the number of an equal name
+	 */
+	explicit ItemName(std::string_view name);
+
+	const std::string& str() const;
+
+	bool operator==(const ItemName& other) const = default;
+};
\ No newline at end of file
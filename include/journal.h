@@ -0,0 +1,239 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "gamestate.h"
+#include "story.h"
+
+/**
+ * @brief Everything needed to continue an unfinished game
+ */
+struct SavedGame {
+	std::string name;
+	int scene = 0;   // 0 until the first scene is entered
+	PlayerState player;
+	std::map<int, SceneState> world;
+};
+
+/**
+ * @brief Kind of a journal record
+ */
+enum class RecordType : uint8_t {
+	BEGIN = 1,          // text = player name, values = hp, attack, defense
+	SCENE = 2,          // values[0] = scene entered
+	CHOICE = 3,         // values[0] = scene, values[1] = choice index
+	ROLL = 4,           // values[0] = die, values[1] = result
+	PLAYER_HP = 5,      // values[0] = hit points after the change
+	COMBATANT_HP = 6,   // values[0] = combatant of the current scene, values[1] = hit points
+	ITEM_GAINED = 7,    // values[0] = ItemKind, values[1] = bonus, text = item name
+	ITEM_REMOVED = 8,   // values[0] = ItemKind, values[1] = inventory index
+	EQUIP = 9,          // values[0] = ItemKind, values[1] = inventory index (-1 = unequip)
+	LOOTED = 10,        // Loot of the current scene was taken
+	END = 11,           // Game finished; it can no longer be resumed
+	RESTORE = 12,       // text = encoded scene, player and world replacing the current ones (rewind)
+	SKILL = 13,         // values[0] = Skill learned
+	FORGET = 14         // values[0], values[1] = scenes [first, last) whose world state is dropped
+};
+
+/**
+ * @brief One state change of one game
+ */
+struct JournalRecord {
+	RecordType type;
+	uint32_t game = 0;
+	int32_t values[3] = { 0, 0, 0 };
+	std::string text;
+};
+
+// Forward declaration
+class JournalSession;
+
+/**
+ * @brief Write-ahead log of every game played by the process, for crash recovery
+ *
+ * Sessions append records for each state change before carrying on. Appends
+ * only copy the record into a shared buffer; a background thread writes and
+ * syncs whatever accumulated while the previous sync ran, so concurrent games
+ * share one fsync (group commit).
+ *
+ * The journal also keeps the latest state of every unfinished game in memory.
+ * Once enough log has been written, that state is saved as a snapshot next to
+ * the log (<path>.snap) and the log is truncated, so recovery only replays the
+ * records written since the last snapshot.
+ */
+class Journal {
+private:
+	std::string path;
+	int fd = -1;
+
+	std::mutex mutex;
+	std::condition_variable wakeFlusher;
+	std::string pending;                    // Encoded records not written yet
+	uint64_t nextSequence = 1;
+	uint64_t snapshotSequence = 0;          // Last record contained in the snapshot file
+	size_t logBytes = 0;                    // Size of the log since the last snapshot
+	uint32_t nextGame = 1;
+	std::unordered_map<uint32_t, SavedGame> games;
+	std::unordered_set<uint32_t> attached;  // Games currently played by a session
+	bool stopping = false;
+	bool failed = false;                    // Writing failed; records are no longer queued
+	std::atomic<uint64_t> durableSequence{ 0 };
+	std::atomic<uint64_t> commits{ 0 };
+	std::thread flusher;
+
+	void flushLoop();
+	bool writeSnapshot(const std::string& image, std::string& error);
+	void recover();
+
+public:
+	// Log size after which the next commit also writes a snapshot
+	static constexpr size_t SNAPSHOT_INTERVAL = 4 * 1024 * 1024;
+
+	// Constructor
+	Journal();
+
+	// Destructor
+	~Journal();
+
+	// Delete Copy Constructor - prevent copying
+	Journal(const Journal&) = delete;
+
+	// Delete Copy Assignment Operator - prevent assignment
+	Journal& operator=(const Journal&) = delete;
+
+	/**
+	 * @brief Opens the log, recovers the saved games and starts committing
+	 *
+	 * A torn record at the end of the log (crash during a write) is discarded.
+	 *
+	 * @param logPath - Path of the log file; the snapshot is stored next to it
+	 * @param error - Receives a description of the problem on failure
+	 * @return bool True on success
+	 */
+	bool open(const std::string& logPath, std::string& error);
+
+	/**
+	 * @brief Commits all appended records, writes a final snapshot and closes the log
+	 */
+	void close();
+
+	/**
+	 * @brief Starts journaling a new game
+	 */
+	std::unique_ptr<JournalSession> begin(const std::string& name, int hitPoints, int attack, int defense);
+
+	/**
+	 * @brief Continues the most recent unfinished game of a player
+	 *
+	 * @param name - Player name
+	 * @param saved - Receives the state of the game
+	 * @return Session of the game, or nullptr if the player has no game to continue
+	 */
+	std::unique_ptr<JournalSession> resume(const std::string& name, SavedGame& saved);
+
+	/**
+	 * @brief Applies a record to the in-memory state and queues it for the next commit
+	 *
+	 * @return uint64_t Sequence number of the record
+	 */
+	uint64_t append(const JournalRecord& record);
+
+	bool isDurable(uint64_t sequence) const;
+
+	/**
+	 * @brief Blocks until a record is on disk, woken by the commit that writes it
+	 */
+	void waitDurable(uint64_t sequence) const;
+
+	size_t unfinishedGames();
+	uint64_t commitCount() const;
+
+	/**
+	 * @brief Called by a session when its game object goes away
+	 */
+	void detach(uint32_t game);
+};
+
+/**
+ * @brief Journal handle of one game
+ *
+ * Recording methods describe the change that just happened to the player or
+ * the world; scene-relative records refer to the last scene entered.
+ */
+class JournalSession {
+private:
+	Journal& journal;
+	uint32_t game;
+	uint64_t lastSequence = 0;
+
+	void record(RecordType type, int32_t a = 0, int32_t b = 0, int32_t c = 0, const std::string& text = {});
+
+public:
+	// Time between two durability checks while a network session waits for a commit
+	static constexpr int COMMIT_POLL_MS = 1;
+
+	// Constructor
+	JournalSession(Journal& owner, uint32_t gameId);
+
+	// Destructor
+	~JournalSession();
+
+	// Delete Copy Constructor - prevent copying
+	JournalSession(const JournalSession&) = delete;
+
+	// Delete Copy Assignment Operator - prevent assignment
+	JournalSession& operator=(const JournalSession&) = delete;
+
+	void recordScene(int sceneNumber);
+	void recordChoice(int sceneNumber, size_t choiceIndex);
+	void recordRoll(int die, int result);
+	void recordPlayerHitPoints(int hitPoints);
+	void recordCombatantHitPoints(size_t index, int hitPoints);
+	void recordItemGained(ItemKind kind, const std::string& name, int value);
+	void recordItemRemoved(ItemKind kind, size_t index);
+
+	/**
+	 * @param index - Inventory index of the equipped item, or -1 when unequipping
+	 */
+	void recordEquip(ItemKind kind, int index);
+
+	void recordLooted();
+	void recordSkill(int skill);
+
+	/**
+	 * @brief Drops the world state of scenes the game threw away, such as generated scenes left far behind
+	 *
+	 * @param first - First scene number dropped
+	 * @param last - Scene number after the last one dropped
+	 */
+	void recordForget(int first, int last);
+
+	/**
+	 * @brief Replaces the saved state of the game, e.g. after the player rewound turns
+	 *
+	 * @param state - New scene, player and world; the name is ignored
+	 */
+	void recordRestore(const SavedGame& state);
+
+	/**
+	 * @brief Marks the game as finished so it is not resumed
+	 */
+	void recordEnd();
+
+	/**
+	 * @brief Waits until every record of this game is on disk
+	 *
+	 * Blocks until the commit is done; network sessions wait through
+	 * Console::pause instead, so the other sessions of their thread run meanwhile.
+	 */
+	void sync();
+};
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Word wrapping and output width of the current player
+ *
+ * Width 0 means unlimited: text keeps its hand-placed line breaks.
+ * Each thread can use its own width (one per connected client); threads
+ * without one use the process default.
+ */
+class Layout {
+public:
+	static void setWidth(size_t columns);
+	static void setThreadWidth(size_t columns);
+
+	/**
+	 * @brief Output width of the calling thread (0 = unlimited)
+	 */
+	static size_t width();
+
+	/**
+	 * @brief Detects the width of the terminal attached to standard output
+	 *
+	 * @return size_t Columns, or 0 if output is not a terminal
+	 */
+	static size_t terminalWidth();
+
+	/**
+	 * @brief Number of columns text occupies (UTF-8 code points)
+	 */
+	static size_t displayWidth(std::string_view text);
+
+	/**
+	 * @brief Appends text word-wrapped to a width
+	 *
+	 * Paragraphs whose lines all fit keep their line breaks. Paragraphs with a
+	 * longer line are reflowed; words longer than the width are split.
+	 *
+	 * @param out - Buffer to append to
+	 * @param text - Text with '\n' line breaks and blank lines between paragraphs
+	 * @param width - Maximum columns per line (0 = no wrapping)
+	 * @param indent - Columns of indentation for continuation lines
+	 */
+	static void wrap(std::string& out, std::string_view text, size_t width, size_t indent = 0);
+};
+
+/**
+ * @brief Rendered output kept per width, so redraws only copy bytes
+ *
+ * Clients rarely change width, so a few entries are enough.
+ */
+class LayoutCache {
+private:
+	static constexpr size_t MAX_ENTRIES = 4;
+	std::vector<std::pair<size_t, std::string>> entries;
+
+public:
+	/**
+	 * @brief Gets the rendering for a width, rendering it on first use
+	 *
+	 * @param width - Output width the rendering is for
+	 * @param render - Callable appending the output for that width to a std::string&
+	 * @return const std::string& Cached rendering
+	 */
+	template <typename Render>
+	const std::string& get(size_t width, Render&& render) {
+		for (const auto& entry : entries) {
+			if (entry.first == width) {
+				return entry.second;
+			}
+		}
+		if (entries.size() == MAX_ENTRIES) {
+			entries.erase(entries.begin());
+		}
+		entries.emplace_back(width, std::string());
+		render(entries.back().second);
+		return entries.back().second;
+	}
+
+	void clear();
+};
\ No newline at end of file
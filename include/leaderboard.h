@@ -0,0 +1,134 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief What a leaderboard ranks runs by
+ */
+enum class LeaderboardCategory {
+	FEWEST_TURNS = 0,
+	MOST_HIT_POINTS = 1,
+	FEWEST_POTIONS = 2,
+	COUNT
+};
+
+/**
+ * @brief One ranked run
+ */
+struct LeaderboardEntry {
+	int64_t key;      // Lower ranks higher
+	uint64_t seq;     // Order of submission, breaks ties in favour of the earlier run
+	std::string player;
+	int value;        // Score as shown
+
+	bool operator<(const LeaderboardEntry& other) const {
+		return key != other.key ? key < other.key : seq < other.seq;
+	}
+};
+
+/**
+ * @brief Live rankings shared by every session of the process
+ *
+ * Each category keeps its fresh entries in SHARDS small arrays, each with
+ * its own lock; a session only locks the shard of its thread. Once a
+ * shard holds MERGE_THRESHOLD entries, the fresh entries are merged into an
+ * immutable ranking made of a few sorted runs, halving in size from the
+ * oldest, so a merge only rewrites the small runs. Rankings are published
+ * through an atomic pointer and retired once no reader can still see them,
+ * so queries read the bulk of the entries without taking any lock. Queries
+ * add the few entries the ranking does not cover yet, so they are exact at
+ * all times.
+ */
+class Leaderboard {
+public:
+	static constexpr size_t SHARDS = 16;
+	static constexpr size_t MERGE_THRESHOLD = 256;
+
+private:
+	using Run = std::vector<LeaderboardEntry>;
+
+	/**
+	 * @brief Merged entries and, per shard, the newest entry they include
+	 */
+	struct Ranking {
+		std::vector<std::shared_ptr<const Run>> runs;   // Sorted runs, largest first; shared between rankings
+		std::array<uint64_t, SHARDS> covered{};
+		size_t size = 0;
+	};
+
+	struct alignas(64) Shard {
+		mutable std::mutex mutex;
+		std::vector<LeaderboardEntry> pending;   // Unsorted; may still hold entries the ranking covers
+	};
+
+	struct Board {
+		std::atomic<const Ranking*> ranking{ nullptr };
+		std::atomic<uint64_t> epoch{ 0 };
+		mutable std::array<std::atomic<size_t>, 2> readers{};   // Readers per epoch parity
+		std::array<Shard, SHARDS> shards;
+		std::mutex mergeMutex;   // Only one merge at a time; submitters never wait for it
+	};
+
+	std::array<Board, static_cast<size_t>(LeaderboardCategory::COUNT)> boards;
+	std::atomic<uint64_t> nextSeq{ 1 };
+
+	static size_t shardOfThread();
+
+	/**
+	 * @brief Publishes a ranking that covers every shard's entries, unless another merge runs
+	 *
+	 * The previous ranking is deleted once the readers of its epoch are done.
+	 */
+	void merge(Board& board);
+
+	/**
+	 * @brief Calls fn with the published ranking and a function visiting the entries it does not cover
+	 *
+	 * Calls fn again when a merge publishes in between, so no entry is missed or seen twice;
+	 * fn must start its answer over on every call.
+	 */
+	template <typename Fn>
+	void read(const Board& board, Fn&& fn) const;
+
+public:
+	// Constructor
+	Leaderboard();
+
+	// Destructor
+	~Leaderboard();
+
+	// Delete Copy Constructor - prevent copying
+	Leaderboard(const Leaderboard&) = delete;
+
+	// Delete Copy Assignment Operator - prevent assignment
+	Leaderboard& operator=(const Leaderboard&) = delete;
+
+	/**
+	 * @brief Ranks a run
+	 *
+	 * @param value - Turns, hit points or potions, depending on the category
+	 * @return LeaderboardEntry The entry, to look up its rank later
+	 */
+	LeaderboardEntry submit(LeaderboardCategory category, const std::string& player, int value);
+
+	/**
+	 * @brief Best entries of a category, best first
+	 */
+	std::vector<LeaderboardEntry> top(LeaderboardCategory category, size_t count) const;
+
+	/**
+	 * @brief Current rank of an entry, 1 being the best
+	 */
+	size_t rank(LeaderboardCategory category, const LeaderboardEntry& entry) const;
+
+	/**
+	 * @brief Number of entries in a category
+	 */
+	size_t size(LeaderboardCategory category) const;
+};
\ No newline at end of file
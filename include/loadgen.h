@@ -0,0 +1,32 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Settings of a load test against a running server
+ */
+struct LoadConfig {
+	std::string address;                          // Server to drive, as given to --serve
+	size_t clients = 0;                           // Clients of the last step; steps double from one
+	std::chrono::milliseconds thinkTime{ 1000 };  // Mean pause of a client before each answer
+	std::chrono::seconds stepDuration{ 10 };      // Time measured at each number of clients
+	double latencyBudget = 0;                     // p99 in milliseconds a step may not exceed (0 = none)
+};
+
+/**
+ * @brief Drives a server with simulated clients and prints how it holds up as they grow in number
+ *
+ * Every client plays real games over the socket protocol: it waits for a
+ * prompt, thinks for a while and answers with one of the options the prompt
+ * offers, now and then as a command word, and starts a new game when the
+ * server ends one. A turn lasts from an answer to the next prompt, so it
+ * includes the game's pacing pauses. Each step prints throughput, turn
+ * latency percentiles and, for servers on a unix socket, memory per session
+ * counted across the server's worker processes, shared pages in proportion.
+ *
+ * Linux only.
+ *
+ * @return int Process exit code; 1 if a step went over the latency budget
+ */
+int runLoad(const LoadConfig& config);
\ No newline at end of file
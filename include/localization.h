@@ -0,0 +1,147 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include "stringID.h"
+
+/**
+ * @brief One compiled string table mapped read-only into memory
+ *
+ * Binary layout: a 16 byte header (magic "LWST", format version, entry count,
+ * schema hash of the string ID list), one {offset, length} entry per string ID,
+ * then the UTF-8 text of all strings. Strings are read straight from the mapping,
+ * so only the pages holding strings that are actually shown become resident.
+ */
+class StringTable {
+private:
+	struct Entry {
+		uint32_t offset;
+		uint32_t length;
+	};
+
+	const char* data = nullptr;
+	size_t size = 0;
+	const Entry* entries = nullptr;
+	uint32_t count = 0;
+	const char* text = nullptr;
+	size_t textSize = 0;
+	void* mapping = nullptr;   // Platform handle of the mapping
+
+	StringTable() = default;
+
+public:
+	/** Entry length marking a string the table does not translate */
+	static constexpr uint32_t MISSING = 0xFFFFFFFFu;
+
+	~StringTable();
+
+	// Delete Copy Constructor - prevent copying
+	StringTable(const StringTable&) = delete;
+
+	// Delete Copy Assignment Operator - prevent assignment
+	StringTable& operator=(const StringTable&) = delete;
+
+	/**
+	 * @brief Maps a compiled table and validates its header and entries
+	 *
+	 * @param path - Path of the .lwst file
+	 * @param error - Receives a description of the problem on failure
+	 * @return std::unique_ptr<StringTable> Table, or nullptr on failure
+	 */
+	static std::unique_ptr<StringTable> open(const std::string& path, std::string& error);
+
+	/**
+	 * @brief Looks up a string by ID
+	 *
+	 * @return std::string_view Translated text, or a null view if the table has none
+	 */
+	std::string_view get(StringID id) const;
+};
+
+/**
+ * @brief Selects string tables and compiles them from translator source files
+ *
+ * Tables live in <directory>/<locale>.lwst and are mapped the first time a
+ * thread using that locale looks up a string. Each thread can play in its own
+ * locale; threads without one use the process default. Strings missing from a
+ * table fall back to English.
+ *
+ * Source files hold one KEY = "text" line per string, where KEY is the string ID
+ * name and \n, \t, \\ and \" are escapes. Lines starting with '#' are comments.
+ */
+class Localization {
+public:
+	static void setDirectory(const std::string& directory);
+
+	/**
+	 * @brief Sets the locale of threads that did not choose one (empty for English)
+	 */
+	static void setLocale(const std::string& locale);
+
+	/**
+	 * @brief Sets the locale of the calling thread (empty to follow the default)
+	 */
+	static void setThreadLocale(const std::string& locale);
+
+	/**
+	 * @brief Gets the table of a locale, mapping it on first use
+	 *
+	 * @return const StringTable* Table, or nullptr if it cannot be loaded
+	 */
+	static const StringTable* table(const std::string& locale);
+
+	/**
+	 * @brief Looks up a string in the calling thread's locale
+	 */
+	static std::string_view get(StringID id);
+
+	/**
+	 * @brief Writes the English strings as a source file for translators
+	 */
+	static void exportSource(std::ostream& out);
+
+	/**
+	 * @brief Compiles a source file into a binary string table
+	 *
+	 * @param sourcePath - Translator source file
+	 * @param tablePath - Output .lwst file
+	 * @param error - Receives a description of the problem on failure
+	 * @return bool True on success
+	 */
+	static bool compile(const std::string& sourcePath, const std::string& tablePath, std::string& error);
+};
+
+/**
+ * @brief Replaces {0}..{9} placeholders in a pattern
+ */
+std::string formatText(std::string_view pattern, const std::string* values, size_t count);
+
+template <typename T>
+std::string toText(const T& value) {
+	if constexpr (std::is_arithmetic_v<T>) {
+		return std::to_string(value);
+	}
+	else {
+		return std::string(std::string_view(value));
+	}
+}
+
+/**
+ * @brief Gets a user interface string in the current locale
+ */
+inline std::string_view tr(StringID id) {
+	return Localization::get(id);
+}
+
+/**
+ * @brief Gets a user interface string with its placeholders filled in
+ */
+template <typename... Args>
+std::string tr(StringID id, const Args&... args) {
+	const std::string values[] = { toText(args)... };
+	return formatText(Localization::get(id), values, sizeof...(Args));
+}
\ No newline at end of file
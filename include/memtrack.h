@@ -0,0 +1,113 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Allocation tracking is a debug aid; it compiles out in release (NDEBUG) builds
+#if !defined(NDEBUG) && !defined(LONEWOLF_NO_MEMTRACK)
+#define LONEWOLF_MEMTRACK 1
+#endif
+
+/**
+ * @brief Subsystems that allocations are accounted to
+ */
+enum class MemTag {
+	STORY = 0,   // Scenes, choices and their containers
+	WORLD = 1,   // Mutable world state such as enemies
+	PLAYER = 2,  // Player object and inventories
+	ITEMS = 3,   // Weapons, armor and potions
+	TEXT = 4,    // Narrative text and choice labels
+	COUNT = 5
+};
+
+/**
+ * @brief Per-subsystem allocation counters
+ *
+ * Tracks current bytes, peak bytes and allocation counts for every MemTag.
+ * In release builds every recording call is an empty inline function.
+ */
+class MemTracker {
+public:
+#ifdef LONEWOLF_MEMTRACK
+	static void recordAlloc(MemTag tag, size_t bytes);
+	static void recordFree(MemTag tag, size_t bytes);
+
+	/**
+	 * @brief Accounts the heap buffer of a string (if any) to MemTag::TEXT
+	 */
+	static void trackText(const std::string& text);
+	static void releaseText(const std::string& text);
+#else
+	static void recordAlloc(MemTag, size_t) {}
+	static void recordFree(MemTag, size_t) {}
+	static void trackText(const std::string&) {}
+	static void releaseText(const std::string&) {}
+#endif
+
+	/**
+	 * @brief Prints current/peak bytes and allocation counts per subsystem
+	 */
+	static void report(std::ostream& out);
+};
+
+/**
+ * @brief Base class that routes heap allocations of the derived class through MemTracker
+ *
+ * Empty in release builds, so it adds no size or cost to the derived class.
+ */
+template <MemTag Tag>
+class TrackedAlloc {
+public:
+#ifdef LONEWOLF_MEMTRACK
+	static void* operator new(size_t size) {
+		MemTracker::recordAlloc(Tag, size);
+		return ::operator new(size);
+	}
+
+	static void operator delete(void* ptr, size_t size) {
+		MemTracker::recordFree(Tag, size);
+		::operator delete(ptr);
+	}
+#endif
+};
+
+/**
+ * @brief Standard allocator that accounts container storage to a subsystem
+ */
+template <typename T, MemTag Tag>
+struct TrackingAllocator {
+	using value_type = T;
+
+	TrackingAllocator() = default;
+
+	template <typename U>
+	TrackingAllocator(const TrackingAllocator<U, Tag>&) {}
+
+	T* allocate(size_t count) {
+		MemTracker::recordAlloc(Tag, count * sizeof(T));
+		return std::allocator<T>().allocate(count);
+	}
+
+	void deallocate(T* ptr, size_t count) {
+		MemTracker::recordFree(Tag, count * sizeof(T));
+		std::allocator<T>().deallocate(ptr, count);
+	}
+
+	template <typename U>
+	struct rebind {
+		using other = TrackingAllocator<U, Tag>;
+	};
+
+	friend bool operator==(const TrackingAllocator&, const TrackingAllocator&) { return true; }
+};
+
+#ifdef LONEWOLF_MEMTRACK
+template <typename T, MemTag Tag>
+using TrackedVector = std::vector<T, TrackingAllocator<T, Tag>>;
+#else
+template <typename T, MemTag Tag>
+using TrackedVector = std::vector<T>;
+#endif
\ No newline at end of file
@@ -0,0 +1,145 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Character statistic that modifiers apply to
+ */
+enum class Stat {
+	ATTACK = 0,
+	DEFENSE = 1,
+	COUNT
+};
+
+/**
+ * @brief Where a modifier comes from
+ */
+enum class ModifierSource {
+	SKILL,       // Kai discipline, lasts the whole game
+	EQUIPMENT,   // Equipped weapon or armor
+	EFFECT       // Temporary buff or debuff, ends with the fight at the latest
+};
+
+/**
+ * @brief Kai discipline a character can learn
+ */
+enum class Skill {
+	WEAPONSKILL = 0,   // Permanent attack bonus
+	MINDBLAST = 1,     // Attack bonus for the first rounds of every fight
+	MINDSHIELD = 2,    // Protection from mind attacks
+	COUNT
+};
+
+constexpr int WEAPONSKILL_BONUS = 2;
+constexpr int MINDBLAST_BONUS = 3;
+constexpr int MINDBLAST_ROUNDS = 3;
+
+/**
+ * @brief Change of one stat from one source
+ */
+struct Modifier {
+	Stat stat;
+	int amount;
+	ModifierSource source;
+	std::string label;   // Shown in the status, e.g. the skill or the creature
+	int rounds = 0;      // Combat rounds left for an effect (0 = until removed)
+};
+
+using ModifierID = uint32_t;
+
+/**
+ * @brief Base stats of a character with every modifier applied to them
+ *
+ * Totals are cached and only summed again after a modifier was added,
+ * removed or changed, so reading a stat in a combat round is O(1) however
+ * many modifiers are active.
+ */
+class StatBlock {
+public:
+	static constexpr size_t STAT_COUNT = static_cast<size_t>(Stat::COUNT);
+	static constexpr ModifierID NONE = 0;
+
+private:
+	struct Entry {
+		ModifierID id;
+		Modifier modifier;
+	};
+
+	std::array<int, STAT_COUNT> base{};
+	std::vector<Entry> modifiers;
+	ModifierID nextId = 1;
+	mutable std::array<int, STAT_COUNT> totals{};
+	mutable bool dirty = true;   // Totals must be summed again before the next read
+
+	Entry* find(ModifierID id);
+
+public:
+	int getBase(Stat stat) const;
+	void setBase(Stat stat, int value);
+
+	/**
+	 * @brief Final value of a stat with all modifiers
+	 */
+	int get(Stat stat) const;
+
+	/**
+	 * @brief Sum of the modifiers of one source on a stat
+	 */
+	int sum(Stat stat, ModifierSource source) const;
+
+	/**
+	 * @brief Adds a modifier
+	 *
+	 * @return ModifierID Handle to change or remove the modifier later
+	 */
+	ModifierID add(Modifier modifier);
+
+	/**
+	 * @brief Removes a modifier; unknown handles are ignored
+	 */
+	void remove(ModifierID id);
+
+	/**
+	 * @brief Changes the amount of a modifier, e.g. when other equipment is put on
+	 */
+	void setAmount(ModifierID id, int amount);
+
+	/**
+	 * @brief Counts down the rounds of timed effects and removes those that ran out
+	 *
+	 * @return bool True if an effect ended
+	 */
+	bool tickRounds();
+
+	/**
+	 * @brief Removes every temporary effect
+	 */
+	void clearEffects();
+
+	/**
+	 * @brief Calls a function with every modifier in the order they were added
+	 */
+	template <typename Fn>
+	void forEach(Fn&& fn) const {
+		for (const Entry& entry : modifiers) {
+			fn(entry.modifier);
+		}
+	}
+};
+
+/**
+ * @brief Permanent stat bonus a set of skills gives
+ *
+ * @param skills - Bit set of learned skills (bit = Skill value)
+ */
+int skillBonus(uint32_t skills, Stat stat);
+
+/**
+ * @brief Bit of a skill in a skill set
+ */
+constexpr uint32_t skillBit(Skill skill) {
+	return 1u << static_cast<uint32_t>(skill);
+}
\ No newline at end of file
@@ -0,0 +1,201 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+/**
+ * @brief Shared immutable value that is copied on the first write through a shared handle
+ *
+ * Copying a CowPtr only bumps a reference count. write() clones the value first
+ * when another handle still refers to it, so copies never see each other's changes.
+ * An empty handle reads as a default-constructed value.
+ */
+template <typename T>
+class CowPtr {
+private:
+	std::shared_ptr<const T> value;
+
+public:
+	const T& get() const {
+		static const T empty{};
+		return value ? *value : empty;
+	}
+
+	const T& operator*() const {
+		return get();
+	}
+
+	const T* operator->() const {
+		return &get();
+	}
+
+	/**
+	 * @brief Mutable access, cloning the value if it is shared
+	 */
+	T& write() {
+		if (!value) {
+			value = std::make_shared<T>();
+		}
+		else if (value.use_count() > 1) {
+			value = std::make_shared<T>(*value);
+		}
+		// Values are always created as mutable T above, so dropping const is safe
+		return const_cast<T&>(*value);
+	}
+
+	bool sharesWith(const CowPtr& other) const {
+		return value == other.value;
+	}
+};
+
+/**
+ * @brief Immutable sparse array with structural sharing
+ *
+ * Elements live in a radix trie of small fixed-size nodes, like the chunks of a
+ * Story but with every level shared. Copying the array is O(1); set() copies only
+ * the nodes on the path to the element, so two arrays that differ in one element
+ * share everything else. Missing elements read as a default-constructed value.
+ */
+template <typename T>
+class PersistentArray {
+public:
+	static constexpr size_t BITS = 3;
+	static constexpr size_t WIDTH = size_t(1) << BITS;
+
+private:
+	static constexpr size_t MASK = WIDTH - 1;
+
+	// Slots of the bottom level hold elements; slots above hold child nodes
+	using Slot = std::shared_ptr<const void>;
+
+	struct Node {
+		std::array<Slot, WIDTH> slots;
+	};
+
+	Slot root;
+	size_t shift = 0;   // Index bits below the root level
+
+	static const T& empty() {
+		static const T value{};
+		return value;
+	}
+
+	static Slot setIn(const Slot& slot, size_t level, size_t index, Slot value) {
+		auto copy = slot ? std::make_shared<Node>(*static_cast<const Node*>(slot.get())) : std::make_shared<Node>();
+		size_t i = (index >> level) & MASK;
+		copy->slots[i] = level == 0 ? std::move(value) : setIn(copy->slots[i], level - BITS, index, std::move(value));
+		return copy;
+	}
+
+	/**
+	 * @brief Copy of a subtree without the elements in [first, last); emptied nodes become null
+	 *
+	 * @param base - First index the subtree covers
+	 */
+	static Slot clearIn(const Slot& slot, size_t level, size_t base, size_t first, size_t last) {
+		size_t span = WIDTH << level;
+		if (!slot || last <= base || first >= base + span) {
+			return slot;   // Nothing of the range below, so the subtree stays shared
+		}
+		if (first <= base && base + span <= last) {
+			return nullptr;
+		}
+		const Node& node = *static_cast<const Node*>(slot.get());
+		auto copy = std::make_shared<Node>(node);
+		bool changed = false;
+		bool empty = true;
+		for (size_t i = 0; i < WIDTH; ++i) {
+			size_t childBase = base + (i << level);
+			if (level == 0) {
+				if (childBase >= first && childBase < last) copy->slots[i].reset();
+			}
+			else {
+				copy->slots[i] = clearIn(node.slots[i], level - BITS, childBase, first, last);
+			}
+			changed = changed || copy->slots[i] != node.slots[i];
+			empty = empty && !copy->slots[i];
+		}
+		if (empty) return nullptr;
+		return changed ? Slot(std::move(copy)) : slot;
+	}
+
+	/**
+	 * @brief Child of a node as seen from a level that may be above the tree's real root
+	 *
+	 * @param top - Level at which node is a real node; above it, node stands in for its own ancestors
+	 */
+	static const void* childAt(const void* node, size_t top, size_t level, size_t i) {
+		if (!node) return nullptr;
+		if (level > top) return i == 0 ? node : nullptr;
+		return static_cast<const Node*>(node)->slots[i].get();
+	}
+
+	template <typename Visit>
+	static void diffIn(const void* a, size_t aTop, const void* b, size_t bTop, size_t level, size_t base, Visit& visit) {
+		if (a == b && (aTop == bTop || !a)) {
+			return;   // Shared subtree
+		}
+		size_t nextATop = level > aTop ? aTop : level - BITS;
+		size_t nextBTop = level > bTop ? bTop : level - BITS;
+		for (size_t i = 0; i < WIDTH; ++i) {
+			const void* childA = childAt(a, aTop, level, i);
+			const void* childB = childAt(b, bTop, level, i);
+			if (level == 0) {
+				if (childA != childB) visit(base + i);
+			}
+			else {
+				diffIn(childA, nextATop, childB, nextBTop, level - BITS, base + (i << level), visit);
+			}
+		}
+	}
+
+public:
+	const T& get(size_t index) const {
+		if (!root || (index >> shift) >= WIDTH) {
+			return empty();
+		}
+		const void* node = root.get();
+		for (size_t level = shift; node && level > 0; level -= BITS) {
+			node = static_cast<const Node*>(node)->slots[(index >> level) & MASK].get();
+		}
+		const void* value = node ? static_cast<const Node*>(node)->slots[index & MASK].get() : nullptr;
+		return value ? *static_cast<const T*>(value) : empty();
+	}
+
+	void set(size_t index, T value) {
+		if (!root) {
+			shift = 0;
+		}
+		// Grow upwards until the index fits; the old root becomes the first child
+		while ((index >> shift) >= WIDTH) {
+			if (root) {
+				auto grown = std::make_shared<Node>();
+				grown->slots[0] = std::move(root);
+				root = std::move(grown);
+			}
+			shift += BITS;
+		}
+		root = setIn(root, shift, index, std::make_shared<const T>(std::move(value)));
+	}
+
+	/**
+	 * @brief Resets the elements in [first, last) to the default value and frees the nodes that held them
+	 */
+	void clear(size_t first, size_t last) {
+		root = clearIn(root, shift, 0, first, last);
+	}
+
+	/**
+	 * @brief Calls visit(index) for every element that differs between two arrays
+	 *
+	 * Subtrees the arrays still share are skipped without being visited, so
+	 * comparing an array with a recent copy of itself is cheap.
+	 */
+	template <typename Visit>
+	void forEachDifference(const PersistentArray& other, Visit&& visit) const {
+		size_t top = std::max(root ? shift : 0, other.root ? other.shift : 0);
+		diffIn(root.get(), shift, other.root.get(), other.shift, top, 0, visit);
+	}
+};
\ No newline at end of file
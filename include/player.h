@@ -1,28 +1,82 @@
 #pragma once
+#include <array>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 #include "weapon.h"
 #include "armor.h"
 #include "potion.h"
+#include "memtrack.h"
+#include "modifier.h"
+#include "itemname.h"
+#include "smallstring.h"
+#include "smallvector.h"
+
+// Forward declarations
+class JournalSession;
+struct PlayerState;
+
+/**
+ * @brief Item as the player carries it, by value inside an inventory
+ */
+struct CarriedItem {
+	ItemName name;
+	int bonus;   // Attack, defense or heal amount depending on the inventory
+};
+static_assert(sizeof(CarriedItem) == 8, "Carried items are kept inline and must stay small");
 
 /**
  * @brief Represents the player character with inventory and status management
  *
  * Handles player stats, equipment, and interactions with the game world.
  * Manages inventory operations (equip/unequip/use/drop items).
+ *
+ * A player is one fixed-size record: the name and up to INLINE_ITEMS items
+ * of each kind live inside it and only longer names or larger inventories
+ * reach the heap, so a server with many sessions keeps its players dense.
+ * Equipped items are indices into their inventory.
  */
-class Player {
+class Player : public TrackedAlloc<MemTag::PLAYER> {
+public:
+	static constexpr size_t INLINE_ITEMS = 2;   // Items of each kind carried without an allocation
+	static constexpr int16_t NOTHING = -1;      // Equipped index when no item is equipped
+
 private:
-	std::string name;
+	using Inventory = SmallVector<CarriedItem, INLINE_ITEMS, TrackingAllocator<CarriedItem, MemTag::PLAYER>>;
+
+	SmallString name;
 	int hitPoints;
 	int maxHitPoints;
-	int baseAttack;
-	int baseDefense;
-	std::vector<Weapon*> weaponInventory;
-	std::vector<Armor*> armorInventory;
-	std::vector<Potion*> potionInventory;
-	Weapon* equippedWeapon = nullptr;
-	Armor* equippedArmor = nullptr;
+	StatBlock stats;                     // Base attack and defense with skills, equipment and effects
+	ModifierID weaponModifier;
+	ModifierID armorModifier;
+	std::array<ModifierID, static_cast<size_t>(Skill::COUNT)> skillModifiers{};
+	uint32_t skills = 0;                 // Learned skills, one bit per Skill
+	Inventory weaponInventory;
+	Inventory armorInventory;
+	Inventory potionInventory;
+	int16_t equippedWeapon = NOTHING;
+	int16_t equippedArmor = NOTHING;
+	int potionsUsed = 0;                 // Potions drunk this game; rewinding gives back those of the rewound turns
+	JournalSession* journal = nullptr;   // Receives every state change when the game is journaled
+
+	/**
+	 * @brief Changes the equipped items and the modifiers they give
+	 * @param index - Index in the inventory, or NOTHING
+	 */
+	void setEquippedWeapon(int16_t index);
+	void setEquippedArmor(int16_t index);
+
+	/**
+	 * @brief Removes an item, keeping the equipped index on the same item
+	 */
+	static void removeItem(Inventory& items, int16_t& equipped, size_t index);
+
+	/**
+	 * @brief Adds or removes skill modifiers to match the learned skills
+	 */
+	void applySkills();
 
 	/**
 	 * @brief Handles equipping or unequipping weapons from inventory
@@ -51,35 +105,72 @@ public:
 	// Constructor
 	Player(const std::string& playerName, int hp, int atk, int def);
 
-	// Destructor
-	~Player();
-
 	// Delete Copy Constructor - prevent copying
 	Player(const Player&) = delete;
 
 	// Delete Copy Assignment Operator - prevent assignment
 	Player& operator=(const Player&) = delete;
 
+	std::string_view getName() const;
 	int getHitPoints() const;
 	int getMaxHitPoints() const;
+	int getPotionsUsed() const;
+	/**
+	 * @brief Final stats with skills, equipment and active effects; O(1) unless a modifier changed
+	 */
 	int getTotalAttack() const;
 	int getTotalDefense() const;
 
+	/**
+	 * @brief Learns a Kai discipline
+	 */
+	void learnSkill(Skill skill);
+	bool hasSkill(Skill skill) const;
+
+	/**
+	 * @brief Puts a temporary buff or debuff on the player
+	 *
+	 * @param stat - Stat that changes
+	 * @param amount - Change of the stat, negative for a debuff
+	 * @param label - Shown in the status
+	 * @param rounds - Combat rounds it lasts (0 = until the fight ends)
+	 */
+	void addEffect(Stat stat, int amount, const std::string& label, int rounds = 0);
+
+	/**
+	 * @brief Counts down timed effects at the end of a combat round
+	 */
+	void endCombatRound();
+
+	/**
+	 * @brief Removes every temporary effect when a fight is over
+	 */
+	void endCombat();
+
 	/**
 	 * @brief Applies damage to the player after defense calculations
 	 * @param damage - damage amount before defense reduction
+	 * @return int Damage actually taken; telling the player is up to the caller
 	 */
-	void takeDamage(int damage);
+	int takeDamage(int damage);
 
 	void heal(int amount);
 	bool isAlive() const;
 
-	void addWeapon(Weapon* weapon);
-	void addArmor(Armor* armor);
-	void addPotion(Potion* item);
+	/**
+	 * @brief Copies an item into the inventory of its kind
+	 * @return size_t Index of the item in that inventory
+	 */
+	size_t addWeapon(const Weapon& weapon);
+	size_t addArmor(const Armor& armor);
+	size_t addPotion(const Potion& item);
 
-	void equipWeapon(Weapon* weapon);
-	void equipArmor(Armor* armor);
+	/**
+	 * @brief Equips a carried item
+	 * @param index - Index of the item in its inventory
+	 */
+	void equipWeapon(size_t index);
+	void equipArmor(size_t index);
 
 	/**
 	 * @brief Consumes a potion from inventory and applies its healing effect
@@ -87,6 +178,29 @@ public:
 	 */
 	void usePotion(size_t index);
 
+	/**
+	 * @brief Records every later state change of the player
+	 * @param session - Journal of the game, or nullptr to stop recording
+	 */
+	void setJournal(JournalSession* session);
+	JournalSession* getJournal() const;
+
+	/**
+	 * @brief Replaces hit points, stats, inventory and equipment without any output
+	 * @param state - Saved or earlier state of the player
+	 */
+	void restore(const PlayerState& state);
+
+	/**
+	 * @brief Checks whether a state still describes the player exactly
+	 */
+	bool matchesState(const PlayerState& state) const;
+
+	/**
+	 * @brief Writes the player into a state, keeping unchanged inventories shared
+	 */
+	void captureState(PlayerState& state) const;
+
 	/**
 	 * @brief Displays detailed player information including equipment and stats
 	 */
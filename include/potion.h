@@ -1,10 +1,11 @@
 #pragma once
 #include <string>
+#include "memtrack.h"
 
 /**
  * @brief Represents the Potion recovery
  */
-class Potion {
+class Potion : public TrackedAlloc<MemTag::ITEMS> {
 private:
 	std::string name;
 	int healAmount;
@@ -0,0 +1,140 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <utility>
+#include "console.h"
+#include "gameevent.h"
+
+/**
+ * @brief Fixed size single-producer/single-consumer queue without locks
+ *
+ * The producer only writes the tail and the consumer only writes the head,
+ * each on its own cache line. A side that finds the ring empty or full
+ * sleeps on the other side's index instead of spinning.
+ */
+template <typename T, size_t CAPACITY>
+class SpscRing {
+	static_assert(CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0, "ring capacity must be a power of two");
+
+private:
+	static constexpr size_t MASK = CAPACITY - 1;
+
+	std::array<T, CAPACITY> slots{};
+	alignas(64) std::atomic<size_t> head{ 0 };   // Next slot to read, consumer only
+	alignas(64) std::atomic<size_t> tail{ 0 };   // Next slot to write, producer only
+
+public:
+	/**
+	 * @brief Moves a value in, waiting while the ring is full
+	 */
+	void push(T&& value) {
+		size_t next = tail.load(std::memory_order_relaxed);
+		while (next - head.load(std::memory_order_acquire) == CAPACITY) {
+			head.wait(next - CAPACITY, std::memory_order_acquire);
+		}
+		slots[next & MASK] = std::move(value);
+		tail.store(next + 1, std::memory_order_release);
+		tail.notify_one();
+	}
+
+	/**
+	 * @brief Moves the oldest value out
+	 *
+	 * @return bool False if the ring was empty
+	 */
+	bool tryPop(T& value) {
+		size_t first = head.load(std::memory_order_relaxed);
+		if (first == tail.load(std::memory_order_acquire)) {
+			return false;
+		}
+		value = std::move(slots[first & MASK]);
+		head.store(first + 1, std::memory_order_release);
+		head.notify_one();
+		return true;
+	}
+
+	/**
+	 * @brief Sleeps until the producer pushes, consumer only
+	 */
+	void waitWhileEmpty() const {
+		tail.wait(head.load(std::memory_order_relaxed), std::memory_order_acquire);
+	}
+};
+
+/**
+ * @brief Terminal host that presents the game on a thread of its own
+ *
+ * Everything the game writes or publishes, and every pause, becomes an
+ * event in a lock-free ring. The presentation thread formats the events,
+ * waits out the pauses and writes the terminal, so the game never sleeps
+ * or blocks on output; it only waits for the screen to catch up before
+ * it reads the player's next answer.
+ */
+class PresentationHost : public ConsoleHost {
+public:
+	static constexpr size_t QUEUE_SIZE = 1024;
+
+private:
+	/**
+	 * @brief Collects written text until the next event goes out
+	 */
+	class TextBuffer : public std::streambuf {
+	private:
+		PresentationHost& host;
+
+	public:
+		std::string pending;
+
+		explicit TextBuffer(PresentationHost& owner) : host(owner) {
+		}
+
+	protected:
+		int_type overflow(int_type c) override;
+		std::streamsize xsputn(const char* text, std::streamsize count) override;
+		int sync() override;
+	};
+
+	SpscRing<GameEvent, QUEUE_SIZE> queue;
+	TextBuffer textBuffer;
+	std::ostream output;
+	size_t published = 0;                // Game thread only
+	std::atomic<size_t> presented{ 0 };  // Events the terminal has caught up with
+	std::atomic<bool> stopping{ false };
+	std::thread presenter;
+
+	void enqueue(GameEvent&& event);
+	void flushText();
+	void present();
+
+public:
+	// Constructor
+	PresentationHost();
+
+	// Destructor
+	~PresentationHost() override;
+
+	// Delete Copy Constructor - prevent copying
+	PresentationHost(const PresentationHost&) = delete;
+
+	// Delete Copy Assignment Operator - prevent assignment
+	PresentationHost& operator=(const PresentationHost&) = delete;
+
+	/**
+	 * @brief Terminal input, once everything published so far is on screen
+	 */
+	std::istream& in() override;
+	std::ostream& out() override;
+	void pause(std::chrono::milliseconds duration) override;
+	void publish(GameEvent&& event) override;
+
+	/**
+	 * @brief Waits until the terminal shows everything published so far
+	 */
+	void drain();
+};
\ No newline at end of file
@@ -0,0 +1,174 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief How a run ended
+ */
+enum class RunOutcome : uint8_t {
+	ENDING = 0,   // Reached an ending of the story alive
+	DIED = 1,
+	QUIT = 2      // Input ran out or the client left
+};
+
+/**
+ * @brief Everything kept about one finished game
+ */
+struct RunRecord {
+	std::string player;
+	int64_t finishedAt = 0;   // Seconds since the epoch
+	RunOutcome outcome = RunOutcome::QUIT;
+	int ending = 0;           // Last scene played: the ending, or where the player died
+	int hitPoints = 0;
+	int maxHitPoints = 0;
+	int turns = 0;            // Scenes entered
+	std::string killer;       // Enemy that killed the player, empty if none
+	std::vector<int> route;   // Scenes in the order they were played
+	std::vector<std::pair<std::string, int>> slain;   // Enemies killed, by name
+	bool resumed = false;     // Continued from the journal: turns, route and slain cover only the part played since
+};
+
+/**
+ * @brief History of every run, kept across games and processes
+ *
+ * Runs are appended to a record file with a length and checksum each, like
+ * the journal. Next to it, <path>.idx holds secondary indexes as sorted
+ * 16-byte entries: a composite key (index kind in the top byte) and the
+ * offset of the run in the record file. New entries go to an unsorted tail,
+ * sorted in memory when a query needs it, and are merged into the sorted
+ * part once the tail grows past an eighth of it. Appending stays cheap and
+ * a query is a few binary searches over the file, never a scan of the runs.
+ *
+ * A run whose index entries were lost in a crash is indexed again on open.
+ * Every method locks, so games of several sessions may share a store.
+ */
+class RunStore {
+public:
+	/**
+	 * @brief Kind of a secondary index
+	 */
+	enum class Index : uint8_t {
+		PLAYER = 1,          // Name hash
+		PLAYER_ENDING = 2,   // Name hash and ending reached
+		ENDING_HP = 3,       // Ending reached and hit points left
+		ENDING_TURNS = 4,    // Ending reached and scenes it took
+		KILLER = 5,          // Name hash of the enemy that killed the player
+		DEATH_SCENE = 6,     // Scene the player died in
+		DATE = 7             // Time the run finished
+	};
+
+	struct IndexEntry {
+		uint64_t key;
+		uint64_t offset;
+
+		bool operator<(const IndexEntry& other) const {
+			return key != other.key ? key < other.key : offset < other.offset;
+		}
+	};
+
+private:
+	mutable std::mutex mutex;
+	std::string path;
+	std::string indexPath;
+	mutable std::fstream data;
+	mutable std::fstream index;
+	uint64_t dataEnd = 0;        // Bytes of the record file that are indexed
+	uint64_t sortedCount = 0;    // Entries in the sorted part of the index file
+	mutable std::vector<IndexEntry> tail;   // Entries after the sorted part
+	mutable bool tailSorted = true;
+	size_t runs = 0;
+
+	/**
+	 * @brief Sorts the tail once before it is searched, so appending stays O(1)
+	 */
+	void sortTail() const;
+
+	bool readRun(uint64_t offset, RunRecord& run) const;
+	IndexEntry sortedEntry(uint64_t position) const;
+	uint64_t sortedLowerBound(uint64_t key) const;
+
+	/**
+	 * @brief Calls fn with the offset of every run whose key is in [first, last] until fn returns false
+	 */
+	template <typename Fn>
+	void forEachInRange(uint64_t first, uint64_t last, Fn&& fn) const;
+
+	size_t countRange(uint64_t first, uint64_t last) const;
+	std::optional<IndexEntry> firstInRange(uint64_t first, uint64_t last) const;
+	std::optional<IndexEntry> lastInRange(uint64_t first, uint64_t last) const;
+
+	void addEntries(const RunRecord& run, uint64_t offset, std::vector<IndexEntry>& entries) const;
+	bool appendEntries(const std::vector<IndexEntry>& entries, std::string& error);
+	bool writeHeader(std::string& error);
+	bool merge(std::string& error);
+	bool openIndex(std::string& error);
+	bool catchUp(std::string& error);
+
+public:
+	RunStore() = default;
+
+	// Destructor
+	~RunStore();
+
+	// Delete Copy Constructor - prevent copying
+	RunStore(const RunStore&) = delete;
+
+	// Delete Copy Assignment Operator - prevent assignment
+	RunStore& operator=(const RunStore&) = delete;
+
+	/**
+	 * @brief Opens or creates a store, indexing runs the index misses
+	 *
+	 * @return bool False with error set if the files cannot be used
+	 */
+	bool open(const std::string& recordPath, std::string& error);
+	void close();
+
+	/**
+	 * @brief Appends a finished run and indexes it
+	 */
+	bool append(const RunRecord& run, std::string& error);
+
+	size_t runCount() const;
+
+	/**
+	 * @brief Number of runs a player finished
+	 */
+	size_t countRuns(const std::string& player) const;
+
+	/**
+	 * @brief Number of runs finished in [from, to], in seconds since the epoch
+	 */
+	size_t countBetween(int64_t from, int64_t to) const;
+
+	/**
+	 * @brief Endings of a list the player has never reached alive
+	 */
+	std::vector<int> unseenEndings(const std::string& player, const std::vector<int>& endings) const;
+
+	/**
+	 * @brief Run that reached an ending with the most hit points left
+	 */
+	std::optional<RunRecord> bestHitPoints(int ending) const;
+
+	/**
+	 * @brief Run that reached an ending in the fewest scenes
+	 */
+	std::optional<RunRecord> fastestRoute(int ending) const;
+
+	/**
+	 * @brief Deaths per enemy name, most deadly first
+	 */
+	std::vector<std::pair<std::string, size_t>> deathsByEnemy() const;
+
+	/**
+	 * @brief Deaths per scene number, most deadly first
+	 */
+	std::vector<std::pair<int, size_t>> deathsByScene() const;
+};
\ No newline at end of file
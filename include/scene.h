@@ -2,56 +2,113 @@
 #include <string>
 #include <vector>
 #include "player.h"
-#include "enemy.h"
+#include "encounter.h"
 #include "weapon.h"
 #include "armor.h"
 #include "potion.h"
+#include "memtrack.h"
+#include "layout.h"
 
 // Forward declartion
 class Choice;
+class Scene;
+struct SceneState;
+
+/**
+ * @brief Owner of the scenes of a game, building each one when it is first needed
+ */
+class SceneDirectory {
+public:
+	virtual ~SceneDirectory() = default;
+
+	/**
+	 * @brief Gets a scene, building it on first use
+	 *
+	 * @param id - Scene number
+	 * @return Scene* The scene, or nullptr if the story has no such scene
+	 */
+	virtual Scene* getScene(int id) = 0;
+
+	/**
+	 * @brief Whether a scene stays alive for the rest of the game once built
+	 *
+	 * Links only cache scenes that do.
+	 */
+	virtual bool keepsScene(int) const { return true; }
+};
+
+/**
+ * @brief Link to a scene by number that is resolved the first time it is followed
+ *
+ * Lets choices point at scenes that have not been built yet, so a game only
+ * builds the scenes the player actually reaches.
+ */
+class SceneRef {
+private:
+	int number = 0;                        // 0 = no scene
+	SceneDirectory* directory = nullptr;
+	mutable Scene* scene = nullptr;        // Cached once resolved, if the directory keeps it
+
+public:
+	SceneRef() = default;
+	SceneRef(int sceneNumber, SceneDirectory* owner);
+
+	/**
+	 * @brief Resolves the link, building the scene if needed
+	 *
+	 * @return Scene* The scene, or nullptr for an empty link or a missing scene
+	 */
+	Scene* get() const;
+
+	int getNumber() const;
+};
 
 /**
  * @brief Represents location in the story
  *
- * Manages scene description, choices, enemies, and loot.
+ * Manages scene description, choices, encounter, and loot.
  * Handles player interaction and progression to next scenes.
  */
-class Scene {
+class Scene : public TrackedAlloc<MemTag::STORY> {
 private:
 	int sceneNumber;
 	std::string description;
-	std::vector<Choice*> choices;
-	Enemy* enemy = nullptr;
-	std::vector<Weapon*> weaponLoot;
-	std::vector<Armor*> armorLoot;
-	std::vector<Potion*> potionLoot;
+	TrackedVector<Choice*, MemTag::STORY> choices;
+	Encounter encounter;
+	TrackedVector<Weapon*, MemTag::WORLD> weaponLoot;
+	TrackedVector<Armor*, MemTag::WORLD> armorLoot;
+	TrackedVector<Potion*, MemTag::WORLD> potionLoot;
+	bool looted = false;   // Loot was handed to the player
+	mutable LayoutCache pageCache;   // Title and wrapped description per output width
+	mutable LayoutCache menuCache;   // Wrapped choice list and prompt per output width
 
 	/**
 	 * @brief Processes roll check for a choice
 	 *
 	 * @param choice - Pointer to the chosen option
+	 * @param player - Pointer to the player object
 	 * @return bool True if check succeeds or no check needed, false if check fails
 	 */
-	bool processRollCheck(const Choice* choice) const;
+	bool processRollCheck(const Choice* choice, Player* player) const;
 
 	/**
-	 * @brief Handles combat with an enemy
+	 * @brief Handles combat with the scene's encounter
 	 *
 	 * @param player - Pointer to the player object
-	 * @param enemy - Pointer to the enemy object
 	 * @param currentScene - Pointer to current scene
 	 * @return Scene* Next scene to continue
 	 */
-	Scene* handleCombatOutcome(Player* player, Enemy* enemy, Scene* currentScene);
+	Scene* handleCombatOutcome(Player* player, Scene* currentScene);
 
 	/**
 	 * @brief Handles player choice selection
 	 *
 	 * @param player - Pointer to the player object
 	 * @param choices - Vector of available choices
+	 * @param offerRewind - Also offer to rewind one turn, as the option after the inventory
 	 * @return Index of the chosen option (1-based)
 	 */
-	size_t getPlayerChoice(Player* player, const std::vector<Choice*>& choices);
+	size_t getPlayerChoice(Player* player, const TrackedVector<Choice*, MemTag::STORY>& choices, bool offerRewind);
 
 public:
 	// Constructor
@@ -74,17 +131,17 @@ public:
 	 * @param minRoll - Minimum dice roll needed (0 = no roll required)
 	 * @param failScene - Scene to continue to if roll check fails
 	 */
-	void addChoice(const std::string& choiceDescription, Scene* nextScene, int minRoll = 0, Scene* failScene = nullptr);
+	void addChoice(const std::string& choiceDescription, SceneRef nextScene, int minRoll = 0, SceneRef failScene = {});
 
 	/**
-	 * @brief Sets an enemy for this scene
+	 * @brief Adds fresh instances of a creature to this scene's encounter
 	 *
-	 * @param name - Enemy name
-	 * @param hp - Enemy hit points
-	 * @param atk - Enemy attack value
-	 * @param def - Enemy defense value
+	 * The creature's side decides whether they fight against or alongside the player.
+	 *
+	 * @param creature - Prototype from the Bestiary
+	 * @param count - Number of instances to add
 	 */
-	void setEnemy(const std::string& name, int hp, int atk, int def);
+	void addCombatants(CreatureID creature, int count = 1);
 
 	/**
 	 * @brief Adds a weapon to the scene's loot
@@ -112,6 +169,8 @@ public:
 
 	/**
 	 * @brief Displays scene details to player
+	 *
+	 * The static part is laid out once per output width and reused on redraws.
 	 */
 	void display() const;
 
@@ -126,27 +185,66 @@ public:
 	 * @brief Processes player input and handles scene progression
 	 *
 	 * @param player - Pointer to the player object
+	 * @param rewindRequested - If set, the menu also offers to rewind one turn; choosing it
+	 *                          sets the flag and returns nullptr without playing the turn
 	 * @return Pointer to the next scene, or nullptr if game ends
 	 */
-	Scene* processInput(Player* player);
+	Scene* processInput(Player* player, bool* rewindRequested = nullptr);
 
 	/**
-	 * @brief Check enemy existence and whether its alive
+	 * @brief Check whether any enemy of the encounter is still alive
 	 *
-	 * @return bool True if enemy exists and is alive
+	 * @return bool True if at least one enemy is alive
 	 */
 	bool hasEnemy() const;
+
+	int getSceneNumber() const;
+	const Encounter& getEncounter() const;
+
+	/**
+	 * @brief Takes over the encounter and remaining loot of an equivalent scene
+	 *
+	 * Used when a newer story version replaces the scene object.
+	 *
+	 * @param previous - Scene built from the same definition
+	 */
+	void takeStateFrom(Scene& previous);
+
+	/**
+	 * @brief Applies a saved world state of this scene (enemy HP, loot taken)
+	 *
+	 * Combatants the state does not mention get their full hit points back.
+	 * Loot that was taken is removed; refilling loot is up to the caller.
+	 *
+	 * @param state - Saved or earlier state of the scene
+	 */
+	void restoreState(const SceneState& state);
+
+	/**
+	 * @brief Writes the world state of this scene
+	 *
+	 * @param state - Receives enemy HP and whether the loot was taken
+	 * @return bool False if the scene is still as its definition describes it
+	 */
+	bool captureState(SceneState& state) const;
+
+	bool isLooted() const;
+
+	/**
+	 * @brief Check whether the scene ends the game (no choices)
+	 */
+	bool isEnding() const;
 };
 
 /**
  * @brief Represents a branching story option with optional skill check
  */
-class Choice {
+class Choice : public TrackedAlloc<MemTag::STORY> {
 private:
 	std::string description;
-	Scene* nextScene;
-	int minRoll;         // Minimum dice roll needed (0 = no roll required)
-	Scene* failScene;    // Scene to go to if roll check fails
+	SceneRef nextScene;
+	int minRoll;          // Minimum dice roll needed (0 = no roll required)
+	SceneRef failScene;   // Scene to go to if roll check fails
 
 public:
 	/**
@@ -155,9 +253,18 @@ public:
 	 * @param desc - Description text for the choice
 	 * @param next - Scene to continue
 	 * @param min - Minimum roll required (default 0 = no roll required)
-	 * @param fail - Scene to continue to if roll fails (default nullptr)
+	 * @param fail - Scene to continue to if roll fails (default none)
 	 */
-	Choice(const std::string& desc, Scene* next, int min = 0, Scene* fail = nullptr);
+	Choice(const std::string& desc, SceneRef next, int min = 0, SceneRef fail = {});
+
+	// Destructor
+	~Choice();
+
+	// Delete Copy Constructor - prevent copying
+	Choice(const Choice&) = delete;
+
+	// Delete Copy Assignment Operator - prevent assignment
+	Choice& operator=(const Choice&) = delete;
 
 	/**
 	 * @brief Gets the description of the choice
@@ -167,7 +274,7 @@ public:
 	const std::string& getDescription() const;
 
 	/**
-	 * @brief Gets the next scene if choice is successful
+	 * @brief Gets the next scene if choice is successful, building it on first use
 	 *
 	 * @return Scene* - Pointer to the next scene
 	 */
@@ -181,7 +288,7 @@ public:
 	int getMinRoll() const;
 
 	/**
-	 * @brief Gets the fail scene if roll check fails
+	 * @brief Gets the fail scene if roll check fails, building it on first use
 	 *
 	 * @return Scene* - Pointer to the fail scene
 	 */
@@ -189,10 +296,10 @@ public:
 };
 
 /**
- * @brief Manages a turn-based combat encounter between player and enemy
+ * @brief Manages a turn-based combat encounter between the player's side and the enemies
  *
  * @param player Pointer to the player object
- * @param enemy Pointer to the enemy object
+ * @param encounter Combatants fighting with and against the player
  * @return bool True if player won, false if player lost or fled
  */
-bool combat(Player* player, Enemy* enemy);
\ No newline at end of file
+bool combat(Player* player, Encounter& encounter);
\ No newline at end of file
@@ -0,0 +1,140 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Settings of the multiplayer server
+ */
+struct ServerConfig {
+	std::string address;   // "unix:<path>", "tcp:<port>" or "<port>" (TCP on loopback only)
+	int workers = 0;       // Worker threads running game logic (0 = one per core)
+	int processes = 0;     // Worker processes sharing the listening socket (0 = serve from this process)
+	size_t width = 0;      // Word-wrap width for clients (0 = original line breaks)
+};
+
+/**
+ * @brief Serves games to many clients over a line-based socket protocol
+ *
+ * One event loop thread (epoll) accepts connections, reads input into
+ * per-session buffers and writes pending output. Each session plays its game
+ * in a fiber with its own stack, pinned to one worker thread. When the game
+ * waits for input or pauses for pacing, the fiber yields and the worker runs
+ * other sessions, so idle connections only cost memory.
+ *
+ * With several processes, the process that started the server only
+ * supervises: it forks workers that each run the loop above on the shared
+ * listening socket. Workers are forked from a process that already built the
+ * story, so they share its pages and only session state is private to each.
+ * A worker that crashes takes its own sessions down and is forked again.
+ *
+ * Linux only; start() fails elsewhere.
+ */
+class GameServer {
+public:
+	using SessionMain = std::function<void()>;
+
+private:
+	struct Session;
+	struct Worker;
+
+	ServerConfig config;
+	SessionMain sessionMain;
+	int listenFd = -1;
+	int epollFd = -1;
+	int wakeFd = -1;
+	int spareFd = -1;   // Reserved descriptor to refuse clients when out of descriptors
+	bool isUnixSocket = false;
+	std::atomic<bool> stopRequested{ false };
+	std::vector<std::unique_ptr<Worker>> workers;
+	std::vector<int> processes;   // Worker process ids, supervising process only
+	bool workerProcess = false;
+	std::unordered_map<int, std::unique_ptr<Session>> sessions;   // Owned by the event loop thread
+	size_t nextWorker = 0;
+
+	std::mutex writeMutex;
+	std::deque<Session*> writeQueue;   // Sessions with new output or that finished
+
+	/**
+	 * @brief Sets up the event loop and the worker threads on the listening socket
+	 */
+	bool startWorkers(std::string& error);
+
+	/**
+	 * @brief Forks a worker process that serves until stopped, then exits
+	 */
+	void spawnProcess();
+
+	/**
+	 * @brief Respawns worker processes that end until stop is requested, then stops them all
+	 */
+	void superviseProcesses();
+
+	void acceptClients();
+	void readClient(Session& session);
+	void writeClient(Session& session);
+	void processWriteQueue();
+	void queueWrite(Session* session);
+	void markClosed(Session& session);
+	void closeSession(Session& session);
+	void wake();
+
+public:
+	/**
+	 * @param serverConfig - Address and threading settings
+	 * @param main - Plays one game; runs once per connection with its console bound to the client
+	 */
+	GameServer(const ServerConfig& serverConfig, SessionMain main);
+	~GameServer();
+
+	// Delete Copy Constructor - prevent copying
+	GameServer(const GameServer&) = delete;
+
+	// Delete Copy Assignment Operator - prevent assignment
+	GameServer& operator=(const GameServer&) = delete;
+
+	/**
+	 * @brief Opens the listening socket and starts the worker threads, or processes
+	 *
+	 * @param error - Receives a description of the problem on failure
+	 * @return bool True on success
+	 */
+	bool start(std::string& error);
+
+	/**
+	 * @brief Runs the event loop until stop is requested and all sessions ended
+	 *
+	 * With worker processes, forks them and supervises them until they all stopped.
+	 */
+	void run();
+
+	/**
+	 * @brief Asks the server to disconnect all clients and return from run()
+	 *
+	 * Async-signal-safe, so it can be called from a signal handler.
+	 */
+	void requestStop();
+};
+
+/**
+ * @brief Opens a blocking connection to a server
+ *
+ * @param address - Server address in the same format as ServerConfig::address
+ * @param error - Receives a description of the problem on failure
+ * @return int File descriptor, or -1 on failure
+ */
+int connectToServer(const std::string& address, std::string& error);
+
+/**
+ * @brief Minimal interactive client: forwards standard input to the server and prints its output
+ *
+ * @param address - Server address in the same format as ServerConfig::address
+ * @return int Process exit code
+ */
+int runClient(const std::string& address);
\ No newline at end of file
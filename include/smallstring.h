@@ -0,0 +1,116 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+/**
+ * @brief Sixteen-byte string that holds up to 15 characters inside the object
+ *
+ * Longer strings spill to an exactly sized heap buffer. The last byte holds
+ * the length of an inline string, or SPILLED, so the string costs half of a
+ * std::string while nearly every name stays within it.
+ */
+class SmallString {
+private:
+	static constexpr size_t INLINE_CAPACITY = 15;
+	static constexpr unsigned char SPILLED = 0xFF;
+
+	union {
+		char local[INLINE_CAPACITY + 1];   // Characters, then the length in the last byte
+		struct {
+			char* data;
+			uint32_t size;
+		} heap;
+	};
+
+	bool spilled() const {
+		return static_cast<unsigned char>(local[INLINE_CAPACITY]) == SPILLED;
+	}
+
+	void release() {
+		if (spilled()) {
+			delete[] heap.data;
+		}
+		local[INLINE_CAPACITY] = 0;
+	}
+
+	void set(std::string_view text) {
+		if (text.size() <= INLINE_CAPACITY) {
+			std::memcpy(local, text.data(), text.size());
+			local[INLINE_CAPACITY] = static_cast<char>(text.size());
+		}
+		else {
+			char* data = new char[text.size()];
+			std::memcpy(data, text.data(), text.size());
+			heap.data = data;
+			heap.size = static_cast<uint32_t>(text.size());
+			local[INLINE_CAPACITY] = static_cast<char>(SPILLED);
+		}
+	}
+
+public:
+	// Constructor
+	SmallString() {
+		local[INLINE_CAPACITY] = 0;
+	}
+
+	explicit SmallString(std::string_view text) {
+		set(text);
+	}
+
+	// Destructor
+	~SmallString() {
+		release();
+	}
+
+	SmallString(const SmallString& other) {
+		set(other.view());
+	}
+
+	SmallString& operator=(const SmallString& other) {
+		if (this != &other) {
+			assign(other.view());
+		}
+		return *this;
+	}
+
+	SmallString(SmallString&& other) noexcept {
+		std::memcpy(static_cast<void*>(this), &other, sizeof(SmallString));
+		other.local[INLINE_CAPACITY] = 0;
+	}
+
+	SmallString& operator=(SmallString&& other) noexcept {
+		if (this != &other) {
+			release();
+			std::memcpy(static_cast<void*>(this), &other, sizeof(SmallString));
+			other.local[INLINE_CAPACITY] = 0;
+		}
+		return *this;
+	}
+
+	void assign(std::string_view text) {
+		// Text may point into this string, so the old buffer goes only once the new one is set
+		SmallString replaced(text);
+		*this = std::move(replaced);
+	}
+
+	std::string_view view() const {
+		if (spilled()) {
+			return { heap.data, heap.size };
+		}
+		return { local, static_cast<size_t>(local[INLINE_CAPACITY]) };
+	}
+
+	operator std::string_view() const {
+		return view();
+	}
+
+	size_t size() const {
+		return view().size();
+	}
+
+	bool empty() const {
+		return size() == 0;
+	}
+};
\ No newline at end of file
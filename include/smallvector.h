@@ -0,0 +1,176 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+/**
+ * @brief Vector that keeps up to N elements inside the object and spills to the heap beyond
+ *
+ * Meant for small records such as inventories, where nearly every instance
+ * stays within N and so never allocates. Past N every element moves to a heap
+ * buffer that grows by doubling; it is kept until the vector is destroyed.
+ * Elements must be trivially copyable, as they are moved bytewise.
+ */
+template <typename T, size_t N, typename Allocator = std::allocator<T>>
+class SmallVector {
+	static_assert(std::is_trivially_copyable_v<T>, "SmallVector moves its elements bytewise");
+	static_assert(N > 0, "SmallVector needs room for at least one element");
+
+	using Traits = std::allocator_traits<Allocator>;
+
+	union {
+		alignas(T) unsigned char local[N * sizeof(T)];
+		T* heap;
+	};
+	uint32_t count = 0;
+	uint32_t capacity = N;   // Above N once the elements live on the heap
+
+	bool spilled() const {
+		return capacity > N;
+	}
+
+	void release() {
+		if (spilled()) {
+			Allocator allocator;
+			Traits::deallocate(allocator, heap, capacity);
+		}
+		capacity = N;
+	}
+
+	void copyFrom(const SmallVector& other) {
+		if (other.count > capacity) {
+			Allocator allocator;
+			T* grown = Traits::allocate(allocator, other.capacity);
+			release();
+			heap = grown;
+			capacity = other.capacity;
+		}
+		count = other.count;
+		if (count > 0) {
+			std::memcpy(static_cast<void*>(data()), other.data(), count * sizeof(T));
+		}
+	}
+
+	void moveFrom(SmallVector& other) {
+		if (other.spilled()) {
+			heap = other.heap;
+			capacity = other.capacity;
+			count = other.count;
+			other.capacity = N;
+		}
+		else {
+			count = other.count;
+			std::memcpy(local, other.local, count * sizeof(T));
+		}
+		other.count = 0;
+	}
+
+	void grow() {
+		Allocator allocator;
+		uint32_t grownCapacity = capacity * 2;
+		T* grown = Traits::allocate(allocator, grownCapacity);
+		std::memcpy(static_cast<void*>(grown), data(), count * sizeof(T));
+		release();
+		heap = grown;
+		capacity = grownCapacity;
+	}
+
+public:
+	// Constructor
+	SmallVector() {}
+
+	// Destructor
+	~SmallVector() {
+		release();
+	}
+
+	SmallVector(const SmallVector& other) {
+		copyFrom(other);
+	}
+
+	SmallVector& operator=(const SmallVector& other) {
+		if (this != &other) {
+			copyFrom(other);
+		}
+		return *this;
+	}
+
+	SmallVector(SmallVector&& other) noexcept {
+		moveFrom(other);
+	}
+
+	SmallVector& operator=(SmallVector&& other) noexcept {
+		if (this != &other) {
+			release();
+			moveFrom(other);
+		}
+		return *this;
+	}
+
+	size_t size() const {
+		return count;
+	}
+
+	bool empty() const {
+		return count == 0;
+	}
+
+	T* data() {
+		return spilled() ? heap : std::launder(reinterpret_cast<T*>(local));
+	}
+
+	const T* data() const {
+		return spilled() ? heap : std::launder(reinterpret_cast<const T*>(local));
+	}
+
+	T& operator[](size_t index) {
+		return data()[index];
+	}
+
+	const T& operator[](size_t index) const {
+		return data()[index];
+	}
+
+	T* begin() {
+		return data();
+	}
+
+	T* end() {
+		return data() + count;
+	}
+
+	const T* begin() const {
+		return data();
+	}
+
+	const T* end() const {
+		return data() + count;
+	}
+
+	void push_back(const T& value) {
+		if (count == capacity) {
+			grow();
+		}
+		::new (static_cast<void*>(data() + count)) T(value);
+		count++;
+	}
+
+	/**
+	 * @brief Removes one element, keeping the order of the others
+	 */
+	void erase(size_t index) {
+		T* items = data();
+		std::memmove(static_cast<void*>(items + index), items + index + 1, (count - index - 1) * sizeof(T));
+		count--;
+	}
+
+	/**
+	 * @brief Removes every element; a heap buffer stays for reuse
+	 */
+	void clear() {
+		count = 0;
+	}
+};
\ No newline at end of file
@@ -0,0 +1,152 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "encounter.h"
+#include "memtrack.h"
+
+/**
+ * @brief Kind of a loot item in a scene definition
+ */
+enum class ItemKind {
+	WEAPON = 0,
+	ARMOR = 1,
+	POTION = 2
+};
+
+/**
+ * @brief Definition of a branching option
+ */
+struct ChoiceDef {
+	std::string label;
+	int next;
+	int minRoll;   // Minimum dice roll needed (0 = no roll required)
+	int fail;      // Scene to go to if roll check fails (0 = none)
+};
+
+/**
+ * @brief Definition of one or more identical combatants
+ */
+struct CombatantDef {
+	CreatureID creature;   // Prototype in the Bestiary
+	int count;
+};
+
+/**
+ * @brief Definition of a loot item
+ */
+struct LootDef {
+	ItemKind kind;
+	std::string name;
+	int bonus;     // Attack, defense or heal amount depending on kind
+};
+
+/**
+ * @brief Immutable definition of a scene, shared by every session playing the story
+ *
+ * Helper methods mirror the Scene API so storylines read the same way they did
+ * when they built Scene objects directly.
+ */
+struct SceneDef {
+	int number = 0;
+	std::string name;
+	std::string description;
+	std::vector<ChoiceDef> choices;
+	std::vector<CombatantDef> combatants;
+	std::vector<LootDef> loot;
+
+	void addChoice(const std::string& choiceDescription, int nextScene, int minRoll = 0, int failScene = 0);
+	// Combatants are defined in the Bestiary; false if it is full
+	bool addEnemy(const std::string& enemyName, int hp, int atk, int def, int count = 1, int mindAttack = 0);
+	bool addAlly(const std::string& allyName, int hp, int atk, int def);
+	void addNewWeapon(const std::string& itemName, int attackBonus);
+	void addNewArmor(const std::string& itemName, int defenseBonus);
+	void addPotionLoot(const std::string& itemName, int healAmount);
+};
+
+/**
+ * @brief One published version of a storyline
+ *
+ * Scene definitions are kept in fixed-size chunks indexed by scene number.
+ * A new version copies only the chunk directory and the chunks it changes,
+ * so publishing an edit costs time proportional to the edit.
+ */
+class Story {
+public:
+	static constexpr size_t CHUNK_SIZE = 256;
+
+private:
+	using Chunk = std::array<std::shared_ptr<const SceneDef>, CHUNK_SIZE>;
+
+	std::vector<std::shared_ptr<const Chunk>> chunks;
+	int startScene = 0;
+	size_t sceneCount = 0;
+	uint64_t version = 0;
+
+public:
+	/**
+	 * @brief Looks up a scene definition
+	 *
+	 * @param number - Scene number
+	 * @return const SceneDef* Definition, or nullptr if the story has no such scene
+	 */
+	const SceneDef* find(int number) const;
+	std::shared_ptr<const SceneDef> findShared(int number) const;
+
+	int getStartScene() const;
+	size_t size() const;
+	uint64_t getVersion() const;
+
+	/**
+	 * @brief Lists every scene number in ascending order
+	 */
+	std::vector<int> sceneNumbers() const;
+
+	/**
+	 * @brief Creates the next version of the story
+	 *
+	 * @param changed - Scene definitions to add or replace
+	 * @param removed - Scene numbers to remove
+	 * @param newStartScene - Start scene of the new version
+	 * @return std::shared_ptr<const Story> New version sharing all untouched chunks
+	 */
+	std::shared_ptr<const Story> update(const std::vector<std::shared_ptr<const SceneDef>>& changed,
+		const std::vector<int>& removed, int newStartScene) const;
+};
+
+/**
+ * @brief Collects scene definitions for a built-in storyline
+ */
+class StoryBuilder {
+private:
+	std::map<int, SceneDef> scenes;
+	int startScene = 0;
+
+public:
+	/**
+	 * @brief Defines a new scene
+	 *
+	 * @param number - Scene number
+	 * @param description - Narrative text of the scene
+	 * @return SceneDef& Definition to add choices, combatants and loot to
+	 */
+	SceneDef& createScene(int number, const std::string& description);
+
+	/**
+	 * @brief Gets a scene defined earlier
+	 */
+	SceneDef& scene(int number);
+
+	void setStartScene(int number);
+
+	std::shared_ptr<const Story> build() const;
+};
+
+/**
+ * @brief Allocates a scene definition accounted to the story subsystem
+ */
+std::shared_ptr<const SceneDef> makeSceneDef(SceneDef&& def);
\ No newline at end of file
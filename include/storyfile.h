@@ -0,0 +1,107 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "story.h"
+
+/**
+ * @brief Statistics of the last story (re)load
+ */
+struct ReloadStats {
+	size_t scenesParsed = 0;
+	size_t scenesRemoved = 0;
+	long long microseconds = 0;
+};
+
+/**
+ * @brief Story loaded from an external text file, with incremental hot reload
+ *
+ * File format (one directive per line, '#' starts a comment line):
+ *
+ *     start: 1
+ *
+ *     [1 START]
+ *     text: First line of the description
+ *     text: Second line of the description
+ *     enemy: 20 6 2 | Kraan              (hp atk def [xCount] [mMindAttack] | name)
+ *     ally: 25 6 3 | Prince Pelathar     (hp atk def | name)
+ *     weapon: 3 | Dagger                 (bonus | name; also armor: and potion:)
+ *     choice: 2 | Take the right path    (next [minRoll failScene] | label)
+ *
+ * On reload only the region of the file that differs from the previous version
+ * is split and parsed again. Unchanged scenes keep their SceneDef objects so
+ * sessions can tell which scenes were edited. Each successful (re)load atomically
+ * publishes a new Story version.
+ */
+class StoryFile {
+private:
+	/**
+	 * @brief Byte range of one scene (or the header when number is 0) in the file
+	 */
+	struct Block {
+		size_t offset;
+		size_t length;
+		int number;
+	};
+
+	std::string path;
+	std::string text;
+	std::vector<Block> blocks;   // blocks[0] is always the header
+	std::shared_ptr<const Story> latest;
+	std::atomic<std::shared_ptr<const Story>> published;
+	std::jthread watcher;
+
+public:
+	explicit StoryFile(const std::string& filePath);
+	~StoryFile();
+
+	// Delete Copy Constructor - prevent copying
+	StoryFile(const StoryFile&) = delete;
+
+	// Delete Copy Assignment Operator - prevent assignment
+	StoryFile& operator=(const StoryFile&) = delete;
+
+	/**
+	 * @brief Re-reads the file and publishes a new version if it changed
+	 *
+	 * The previous version stays published if the file cannot be read or parsed.
+	 *
+	 * @param error - Receives a description of the problem on failure
+	 * @param stats - Optional statistics of the reload
+	 * @return bool True if the current file content is published
+	 */
+	bool reload(std::string& error, ReloadStats* stats = nullptr);
+
+	/**
+	 * @brief Latest successfully published version (nullptr before the first load)
+	 */
+	std::shared_ptr<const Story> current() const;
+
+	/**
+	 * @brief Starts a background thread that reloads the story whenever the file changes
+	 *
+	 * Uses inotify on Linux and polls the modification time elsewhere.
+	 */
+	void watch();
+	void stopWatching();
+};
+
+/**
+ * @brief Parses the directives of one scene block
+ *
+ * @param block - Text from the scene header line up to the next header
+ * @param def - Receives the parsed definition
+ * @param error - Receives a description of the problem on failure
+ * @return bool True on success
+ */
+bool parseSceneBlock(std::string_view block, SceneDef& def, std::string& error);
+
+/**
+ * @brief Writes a story in the story file format
+ */
+void writeStory(const Story& story, std::ostream& out);
\ No newline at end of file
@@ -0,0 +1,171 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * @brief Every user interface string with its English text
+ *
+ * Placeholders {0}..{9} are replaced by the arguments given to tr().
+ * The order of this list defines the index of each string in compiled
+ * string tables, so tables must be recompiled when entries are added.
+ */
+#define LONEWOLF_STRINGS(STRING) \
+	STRING(BANNER, "~ Inspired by the Lone Wolf: Flight from the Dark ~\n~ A simplified version of text RPG ~") \
+	STRING(ASK_NAME, "What is your name: ") \
+	STRING(INTRO, \
+		"On this fateful morning, you, {0}, have been sent to collect firewood in the forest as a punishment\n" \
+		"for your inattention in class. As you are preparing to return, you see to your horror a vast cloud of black\n" \
+		"leathery creatures swoop down and engulf the monastery. Dropping the wood, you race to the battle. You grabbed\n" \
+		"your equipments but in the unnatural dark, you stumble and strike your head on a low tree branch. As you lose\n" \
+		"consciousness, the last thing that you see in the poor light are the walls of the monastery crashing to the ground.") \
+	STRING(JOURNEY_RESUMED, "\nWelcome back, {0}. Your journey continues where you left it.\n") \
+	STRING(MISSION_ENDS, "\nYour life and your mission end here.\n") \
+	STRING(REWIND_PROMPT, "\nRewind how many turns? (1-{0}, 0 to let it end): ") \
+	STRING(TURNS_REWOUND, "\nTime flows backwards... {0} turn(s) undone.\n") \
+	STRING(STARTER_WEAPON, "Wooden Sword") \
+	STRING(STARTER_ARMOR, "Leather Armor") \
+	STRING(STARTER_POTION, "Healing Potion") \
+	STRING(SKILL_WEAPONSKILL, "Weaponskill") \
+	STRING(SKILL_MINDBLAST, "Mindblast") \
+	STRING(SKILL_MINDSHIELD, "Mindshield") \
+	STRING(SKILL_MENU, \
+		"\nOf all the Kai disciplines, your masters taught you one above the others:\n" \
+		"1. Weaponskill (+{0} attack)\n" \
+		"2. Mindblast (+{1} attack for the first {2} rounds of every fight)\n" \
+		"3. Mindshield (protection from mind attacks)\n" \
+		"Enter your choice (1-3, 0 for none): ") \
+	STRING(SKILL_LEARNED, " * You have mastered {0}. *\n") \
+	STRING(INVALID_INPUT, "Invalid choice. Please try again: ") \
+	STRING(TOO_MANY_ATTEMPTS, "\nToo many invalid attempts. Defaulting to 0.\n\n") \
+	STRING(TAKES_DAMAGE, "{0} takes {1} damage! ") \
+	STRING(HEALS, "{0} heals {1} HP! ") \
+	STRING(PLAYER_HP, "Player's HP: {0}/{1}\n") \
+	STRING(ENEMY_HP, "Enemy HP: {0}/{1}\n") \
+	STRING(ALLY_HP, "Ally HP: {0}/{1}\n") \
+	STRING(ITEM_ADDED, " * Added {0} to inventory. *\n") \
+	STRING(WEAPON_EQUIPPED, " * Equipped {0} as weapon. *\n") \
+	STRING(ARMOR_EQUIPPED, " * Equipped {0} as armor. *\n") \
+	STRING(INVALID_POTION, " * Invalid potion selection. *\n") \
+	STRING(POTION_CONSUMED, " * The potion has been consumed. *\n") \
+	STRING(STATUS_TITLE, "\n * * * * *\n- - - {0}'s Status - - -\n") \
+	STRING(STATUS_HP, "{0}'s HP: {1}/{2}\n") \
+	STRING(STATUS_ATTACK, "Attack: {0} (Base: {1}") \
+	STRING(STATUS_DEFENSE, "Defense: {0} (Base: {1}") \
+	STRING(STATUS_BONUS, " + {0} from {1}") \
+	STRING(STATUS_PENALTY, " - {0} from {1}") \
+	STRING(STATUS_SKILLS, "Kai disciplines: ") \
+	STRING(STATUS_WEAPONS, "Weapon: ") \
+	STRING(STATUS_ARMOR, "Armor: ") \
+	STRING(STATUS_POTIONS, "Potions: ") \
+	STRING(STATUS_NONE, "None\n") \
+	STRING(TAG_EQUIPPED, " (Equipped)") \
+	STRING(TAG_CURRENTLY_EQUIPPED, " (Currently equipped)") \
+	STRING(TAG_WEAPON, " [Weapon]") \
+	STRING(TAG_ARMOR, " [Armor]") \
+	STRING(TAG_RECOVERY, " [Recovery]") \
+	STRING(TAG_ATTACK_BONUS, " [Attack: +{0}]") \
+	STRING(TAG_DEFENSE_BONUS, " [Defense: +{0}]") \
+	STRING(TAG_HEAL_AMOUNT, " (+{0} HP)") \
+	STRING(INVENTORY_MENU, \
+		"\n * * Menu * *\n" \
+		"1. Character Status\n" \
+		"2. Equip a weapon\n" \
+		"3. Equip armor\n" \
+		"4. Use a potion\n" \
+		"5. Drop an item\n" \
+		"\n - - - - - - - - - - - - - - - - - - -" \
+		"\nEnter your choice (0 to return): ") \
+	STRING(INVALID_CHOICE, "Invalid choice.\n") \
+	STRING(INVALID_CHOICE_RETRY, "Invalid choice. Please try again.\n") \
+	STRING(PROMPT_CANCEL, "\nEnter your choice: (0 to cancel): ") \
+	STRING(NO_WEAPONS, "You have no equipment to equip.\n") \
+	STRING(SELECT_WEAPON, "\nSelect weapon to equip:\n") \
+	STRING(WEAPON_EQUIP_CANCELLED, "Cancelled weapon equip.\n") \
+	STRING(CONFIRM_UNEQUIP, "This item is currently equipped. Would you like to unequip it? (1 = Yes, 0 = No): ") \
+	STRING(WEAPON_UNEQUIPPED, "{0} has been unequipped.\n") \
+	STRING(NO_ARMOR, "You have no armor to equip.\n") \
+	STRING(SELECT_ARMOR, "\nSelect armor to equip:\n") \
+	STRING(ARMOR_EQUIP_CANCELLED, "Cancelled armor equip.\n") \
+	STRING(ARMOR_UNEQUIPPED, "Unequipped armor:{0}\n") \
+	STRING(NO_POTIONS, "You have no potions to use.\n") \
+	STRING(SELECT_POTION, "\nSelect a potion to use:\n") \
+	STRING(POTION_CANCELLED, "Cancelled potion use.\n") \
+	STRING(NOTHING_TO_DROP, "You have nothing to drop.\n") \
+	STRING(SELECT_DROP, "\nSelect item to drop:\n") \
+	STRING(DROP_CANCELLED, "Cancelled dropping item.\n") \
+	STRING(CONFIRM_DROP_EQUIPPED, "This item is currently equipped. Are you sure? (1=Yes, 0=No): ") \
+	STRING(ITEM_KEPT, "Item kept.\n") \
+	STRING(ITEM_DROPPED, "Dropped {0}.\n") \
+	STRING(SCENE_TITLE, "\n- - - Scene {0} - - -\n") \
+	STRING(ENEMY_PRESENT, "\nA {0} is here! (HP: {1})") \
+	STRING(ALLY_PRESENT, "\n{0} fights at your side. (HP: {1})") \
+	STRING(LOOT_RECEIVED, "\nYou received :\n") \
+	STRING(LOOT_WEAPON, "- {0} (Attack: +{1})\n") \
+	STRING(LOOT_ARMOR, "- {0} (Defense: +{1})\n") \
+	STRING(LOOT_POTION, "- {0} (Heals: +{1} HP)\n") \
+	STRING(OPEN_INVENTORY, "{0}. Open inventory\n") \
+	STRING(REWIND_OPTION, "{0}. Rewind one turn\n") \
+	STRING(CHOICE_PROMPT, "\nEnter your choice (1-{0}): ") \
+	STRING(ROLL_CHECK, "Rolling check (D20)...\n") \
+	STRING(YOU_ROLLED, "You rolled: {0}\n") \
+	STRING(ROLL_CHECK_PASSED, "You succeeded in roll check!\n") \
+	STRING(ROLL_CHECK_FAILED, "You failed in roll check\n") \
+	STRING(GAME_OVER_DIED, "\nGAME OVER - You died.\n") \
+	STRING(FLED_ENEMY_REMAINS, "You fled, but the enemy will remain there upon your return.\n") \
+	STRING(THE_END, "\nGame over!\n - The End - \n") \
+	STRING(CHOOSE_TARGET, "\nChoose your target:\n") \
+	STRING(TARGET_ENTRY, "{0}. {1} (HP: {2})\n") \
+	STRING(TARGET_PROMPT, "\nEnter your choice (0 to cancel): ") \
+	STRING(ENEMIES, "enemies") \
+	STRING(COMBAT_BEGINS, "\n- - - COMBAT BEGINS - - -\n") \
+	STRING(FACE_ENEMY, "You face a {0} (HP: {1})\n") \
+	STRING(ALLY_JOINS, "{0} fights at your side (HP: {1})\n") \
+	STRING(MINDBLAST_USED, "You unleash your Mindblast! (+{0} attack for {1} rounds)\n") \
+	STRING(MIND_ATTACK, "The {0} assails your mind! (-{1} attack in this fight)\n") \
+	STRING(MIND_ATTACK_BLOCKED, "The {0} assails your mind, but your Mindshield holds.\n") \
+	STRING(MIND_ATTACK_EFFECT, "{0}'s mind attack") \
+	STRING(COMBAT_MENU, \
+		"\nYour turn:\n" \
+		"1. Attack\n" \
+		"2. Check status\n" \
+		"3. Manage inventory\n" \
+		"4. Try to flee\n" \
+		"\nEnter your choice: ") \
+	STRING(ROLL_ATTACK, "Rolling attack dice (D20)...\n") \
+	STRING(YOU_STRIKE, "You strike the {0}!\n") \
+	STRING(CRITICAL_MISS, "Critical miss! You missed your attack\n") \
+	STRING(COMBATANT_HP, "{0} HP: {1}/{2}\n") \
+	STRING(NO_POTIONS_IN_COMBAT, "\nNote: Potions cannot be used during combat.\n") \
+	STRING(ROLL_ESCAPE, "Rolling escape dice (D20)...\n") \
+	STRING(ESCAPED, "You successfully escape from the {0}!\n") \
+	STRING(ESCAPE_FAILED, "You failed to escape!\n") \
+	STRING(CANNOT_CANCEL_COMBAT, "Cannot cancel during combat.\n") \
+	STRING(ALLY_ATTACKS, "\n{0} attacks the {1}!\n") \
+	STRING(ALLY_MISSES, "{0} misses.\n") \
+	STRING(ENEMY_TURN, "\nEnemy's turn:\n") \
+	STRING(ENEMY_ATTACKS_YOU, "The {0} attacks you!\n") \
+	STRING(ENEMY_ATTACKS, "The {0} attacks {1}!\n") \
+	STRING(ROLL_ENEMY_ATTACK, "Rolling enemy attack dice (D20)...\n") \
+	STRING(ENEMY_ROLLED, "Enemy rolled: {0}\n") \
+	STRING(ENEMY_HITS_YOU, "HIT! The {0} strikes you!\n") \
+	STRING(ENEMY_HITS, "HIT! The {0} strikes {1}!\n") \
+	STRING(ENEMY_MISSES, "MISS! The {0} fails to hit.\n") \
+	STRING(DEFEATED_BY, "\nYou have been defeated by the {0}.\n") \
+	STRING(VICTORY, "\nVictory! You defeated the {0}.\n") \
+	STRING(LEADERBOARD_TITLE, "\n- - - Leaderboards ({0} runs ranked) - - -\n") \
+	STRING(LEADERBOARD_FEWEST_TURNS, "Fewest scenes:\n") \
+	STRING(LEADERBOARD_MOST_HIT_POINTS, "Most HP left:\n") \
+	STRING(LEADERBOARD_FEWEST_POTIONS, "Fewest potions:\n") \
+	STRING(LEADERBOARD_ENTRY, "  {0}. {1} ({2})\n") \
+	STRING(LEADERBOARD_OWN_RANK, "  You are ranked {0} of {1} with {2}.\n")
+
+/**
+ * @brief IDs of all user interface strings
+ *
+ * Used as direct indexes into the active string table.
+ */
+enum class StringID : uint32_t {
+#define LONEWOLF_STRING_ID(id, text) id,
+	LONEWOLF_STRINGS(LONEWOLF_STRING_ID)
+#undef LONEWOLF_STRING_ID
+	COUNT
+};
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Outcome of a combat encounter as seen by telemetry
+ */
+enum class CombatOutcome {
+	WIN = 0,
+	FLEE = 1,
+	DEATH = 2
+};
+
+/**
+ * @brief Built-in gameplay counters and histograms
+ *
+ * Every recording thread owns a shard of relaxed atomic counters, so recording
+ * never takes a shared lock. An exporter thread periodically merges all shards
+ * and writes them as JSON (<prefix>.json) and Prometheus text (<prefix>.prom).
+ * Recording is always on; exporting only happens after start().
+ */
+class Telemetry {
+public:
+	static void recordSceneVisit(int sceneNumber);
+	static void recordChoice(int sceneNumber, size_t choiceIndex);
+	static void recordRollCheck(bool passed);
+
+	/**
+	 * @brief Records a finished combat encounter
+	 *
+	 * @param enemyName - Name of the enemy that was fought
+	 * @param rounds - Number of rounds played in the encounter
+	 * @param outcome - How the encounter ended for the player
+	 */
+	static void recordCombat(const std::string& enemyName, int rounds, CombatOutcome outcome);
+
+	static void recordTurnLatency(std::chrono::nanoseconds elapsed);
+
+	/**
+	 * @brief Starts the background exporter
+	 *
+	 * @param pathPrefix - Output path without extension
+	 * @param interval - Time between two exports
+	 */
+	static void start(const std::string& pathPrefix, std::chrono::seconds interval);
+
+	/**
+	 * @brief Stops the background exporter after a final export
+	 */
+	static void stop();
+
+	/**
+	 * @brief Merges all shards and writes the metric files immediately
+	 */
+	static void exportNow();
+};
\ No newline at end of file
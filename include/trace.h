@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Optional Chrome/Perfetto trace-event output
+ *
+ * Spans are pushed into a lock-free ring owned by the recording thread and
+ * drained by a background flusher that appends them to a trace-event JSON file.
+ * The file can be opened in chrome://tracing or ui.perfetto.dev.
+ * When tracing is not started, spans cost a single relaxed load.
+ */
+class Trace {
+public:
+	/**
+	 * @brief Starts tracing and the background flusher
+	 * @param path - Output file for the trace-event JSON
+	 * @return bool True if the output file could be opened
+	 */
+	static bool start(const std::string& path);
+
+	/**
+	 * @brief Drains all pending events, closes the JSON array and the file
+	 */
+	static void stop();
+
+	static bool enabled();
+
+	/**
+	 * @brief Current trace clock in nanoseconds
+	 */
+	static int64_t now();
+
+	/**
+	 * @brief Records a finished span
+	 *
+	 * @param name - Span name, must be a string literal
+	 * @param category - Span category, must be a string literal
+	 * @param startNs - Start timestamp from now()
+	 * @param endNs - End timestamp from now()
+	 */
+	static void complete(const char* name, const char* category, int64_t startNs, int64_t endNs);
+};
+
+/**
+ * @brief RAII span covering the lifetime of the object
+ *
+ * Categories used by the game: "engine" for game logic, "combat" for combat
+ * rounds, "inventory" for menus, "input" for time spent waiting on the player
+ * and "pacing" for deliberate sleeps.
+ */
+class TraceSpan {
+private:
+	const char* name;
+	const char* category;
+	int64_t startNs;
+
+public:
+	TraceSpan(const char* spanName, const char* spanCategory);
+	~TraceSpan();
+
+	TraceSpan(const TraceSpan&) = delete;
+	TraceSpan& operator=(const TraceSpan&) = delete;
+};
\ No newline at end of file
@@ -1,13 +1,28 @@
 #pragma once
+#include <cstdint>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
+#include "command.h"
 
 /**
  * @brief Displays text content with horizontal borders
+ *
+ * Entries are word-wrapped to the output width; an entry holding several
+ * lines is reflowed as one paragraph when it does not fit.
+ *
  * @param content - Vector of strings to display
  */
 void printBorderedText(const std::vector<std::string>& content);
 
+/**
+ * @brief Splits text into its lines
+ * @param text - Text separated by '\n'
+ * @return Lines without the separators
+ */
+std::vector<std::string> splitLines(std::string_view text);
+
 /**
  * @brief Generates a random integer between 1 and the specified number of nax
  * @param max - The maximum number (inclusive) that can be rolled
@@ -15,9 +30,52 @@ void printBorderedText(const std::vector<std::string>& content);
  */
 int rollDice(int max);
 
+/**
+ * @brief Small, fast and seedable random generator for headless simulations
+ *
+ * xorshift64* generator; cheap enough to roll millions of dice per second.
+ * Rolling is inline, as dice expressions and simulations call it in their
+ * innermost loops.
+ */
+class FastRng {
+private:
+	uint64_t state;
+
+public:
+	explicit FastRng(uint64_t seed);
+
+	uint32_t next() {
+		state ^= state >> 12;
+		state ^= state << 25;
+		state ^= state >> 27;
+		return static_cast<uint32_t>((state * 0x2545F4914F6CDD1DULL) >> 32);
+	}
+
+	/**
+	 * @brief Rolls a die with the given number of sides
+	 * @return A random integer in the range [1, max]
+	 */
+	int roll(int max) {
+		// Multiply-shift maps 32 random bits onto [0, max) without a division
+		return 1 + static_cast<int>((static_cast<uint64_t>(next()) * static_cast<uint64_t>(max)) >> 32);
+	}
+};
+
 /**
  * @brief Validates user input to ensure it's within acceptable range
+ *
+ * Takes the next command of the session, so commands typed ahead on one
+ * line answer the following prompts. Verb arguments left over when a menu
+ * with verbs comes up are dropped; their prompt never appeared.
+ *
  * @param choice Reference to the user's input choice
  * @param maxSize The maximum acceptable value (0 is always valid as cancel)
+ * @param verbs Words accepted in place of option numbers
+ */
+void validateInput(size_t& choice, size_t maxSize, std::span<const CommandVerb> verbs = {});
+
+/**
+ * @brief Pauses the game for dramatic pacing
+ * @param milliseconds - Duration of the pause
  */
-void validateInput(size_t& choice, size_t maxSize);
+void pacingDelay(int milliseconds);
@@ -1,10 +1,11 @@
 #pragma once
 #include <string>
+#include "memtrack.h"
 
 /**
  * @brief Represents the Weapon equipment
  */
-class Weapon {
+class Weapon : public TrackedAlloc<MemTag::ITEMS> {
 private:
 	std::string name;
 	int attackBonus;
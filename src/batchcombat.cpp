@@ -0,0 +1,260 @@
+#include <bit>
+#include "batchcombat.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+
+namespace {
+
+// Every kernel runs 8 lanes so all instruction sets produce the same results for a seed
+constexpr unsigned LANES = 8;
+constexpr uint32_t ALL_LANES = (1u << LANES) - 1;
+
+#if defined(__AVX2__)
+
+struct Vec {
+	__m256i v;
+};
+
+inline Vec set1(int32_t x) { return { _mm256_set1_epi32(x) }; }
+inline Vec load(const int32_t* p) { return { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)) }; }
+inline Vec add(Vec a, Vec b) { return { _mm256_add_epi32(a.v, b.v) }; }
+inline Vec sub(Vec a, Vec b) { return { _mm256_sub_epi32(a.v, b.v) }; }
+inline Vec mul(Vec a, Vec b) { return { _mm256_mullo_epi32(a.v, b.v) }; }
+inline Vec bitXor(Vec a, Vec b) { return { _mm256_xor_si256(a.v, b.v) }; }
+inline Vec bitAnd(Vec a, Vec b) { return { _mm256_and_si256(a.v, b.v) }; }
+inline Vec greaterThan(Vec a, Vec b) { return { _mm256_cmpgt_epi32(a.v, b.v) }; }
+inline Vec maximum(Vec a, Vec b) { return { _mm256_max_epi32(a.v, b.v) }; }
+inline Vec select(Vec mask, Vec a, Vec b) { return { _mm256_blendv_epi8(b.v, a.v, mask.v) }; }
+template <int N> inline Vec shiftLeft(Vec a) { return { _mm256_slli_epi32(a.v, N) }; }
+template <int N> inline Vec shiftRight(Vec a) { return { _mm256_srli_epi32(a.v, N) }; }
+
+inline uint32_t laneBits(Vec mask) {
+	return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(mask.v)));
+}
+
+inline Vec laneMask(uint32_t bits) {
+	const __m256i laneBit = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+	__m256i selected = _mm256_and_si256(_mm256_set1_epi32(static_cast<int32_t>(bits)), laneBit);
+	return { _mm256_cmpeq_epi32(selected, laneBit) };
+}
+
+const char* KERNEL_NAME = "AVX2";
+
+#elif defined(__SSE4_1__)
+
+struct Vec {
+	__m128i lo;
+	__m128i hi;
+};
+
+inline Vec set1(int32_t x) { return { _mm_set1_epi32(x), _mm_set1_epi32(x) }; }
+inline Vec load(const int32_t* p) {
+	return { _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 4)) };
+}
+inline Vec add(Vec a, Vec b) { return { _mm_add_epi32(a.lo, b.lo), _mm_add_epi32(a.hi, b.hi) }; }
+inline Vec sub(Vec a, Vec b) { return { _mm_sub_epi32(a.lo, b.lo), _mm_sub_epi32(a.hi, b.hi) }; }
+inline Vec mul(Vec a, Vec b) { return { _mm_mullo_epi32(a.lo, b.lo), _mm_mullo_epi32(a.hi, b.hi) }; }
+inline Vec bitXor(Vec a, Vec b) { return { _mm_xor_si128(a.lo, b.lo), _mm_xor_si128(a.hi, b.hi) }; }
+inline Vec bitAnd(Vec a, Vec b) { return { _mm_and_si128(a.lo, b.lo), _mm_and_si128(a.hi, b.hi) }; }
+inline Vec greaterThan(Vec a, Vec b) { return { _mm_cmpgt_epi32(a.lo, b.lo), _mm_cmpgt_epi32(a.hi, b.hi) }; }
+inline Vec maximum(Vec a, Vec b) { return { _mm_max_epi32(a.lo, b.lo), _mm_max_epi32(a.hi, b.hi) }; }
+inline Vec select(Vec mask, Vec a, Vec b) {
+	return { _mm_blendv_epi8(b.lo, a.lo, mask.lo), _mm_blendv_epi8(b.hi, a.hi, mask.hi) };
+}
+template <int N> inline Vec shiftLeft(Vec a) { return { _mm_slli_epi32(a.lo, N), _mm_slli_epi32(a.hi, N) }; }
+template <int N> inline Vec shiftRight(Vec a) { return { _mm_srli_epi32(a.lo, N), _mm_srli_epi32(a.hi, N) }; }
+
+inline uint32_t laneBits(Vec mask) {
+	uint32_t lo = static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(mask.lo)));
+	uint32_t hi = static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(mask.hi)));
+	return lo | (hi << 4);
+}
+
+inline Vec laneMask(uint32_t bits) {
+	const __m128i laneBit = _mm_setr_epi32(1, 2, 4, 8);
+	__m128i lo = _mm_and_si128(_mm_set1_epi32(static_cast<int32_t>(bits & 0xF)), laneBit);
+	__m128i hi = _mm_and_si128(_mm_set1_epi32(static_cast<int32_t>(bits >> 4)), laneBit);
+	return { _mm_cmpeq_epi32(lo, laneBit), _mm_cmpeq_epi32(hi, laneBit) };
+}
+
+const char* KERNEL_NAME = "SSE4.1";
+
+#else
+
+// Scalar fallback: the same lane arithmetic one element at a time
+struct Vec {
+	int32_t v[LANES];
+};
+
+template <typename Op>
+inline Vec map(Vec a, Vec b, Op op) {
+	Vec r;
+	for (unsigned i = 0; i < LANES; ++i) r.v[i] = op(a.v[i], b.v[i]);
+	return r;
+}
+
+inline Vec set1(int32_t x) {
+	Vec r;
+	for (unsigned i = 0; i < LANES; ++i) r.v[i] = x;
+	return r;
+}
+inline Vec load(const int32_t* p) {
+	Vec r;
+	for (unsigned i = 0; i < LANES; ++i) r.v[i] = p[i];
+	return r;
+}
+inline Vec add(Vec a, Vec b) {
+	return map(a, b, [](int32_t x, int32_t y) { return static_cast<int32_t>(static_cast<uint32_t>(x) + static_cast<uint32_t>(y)); });
+}
+inline Vec sub(Vec a, Vec b) {
+	return map(a, b, [](int32_t x, int32_t y) { return static_cast<int32_t>(static_cast<uint32_t>(x) - static_cast<uint32_t>(y)); });
+}
+inline Vec mul(Vec a, Vec b) {
+	return map(a, b, [](int32_t x, int32_t y) { return static_cast<int32_t>(static_cast<uint32_t>(x) * static_cast<uint32_t>(y)); });
+}
+inline Vec bitXor(Vec a, Vec b) { return map(a, b, [](int32_t x, int32_t y) { return x ^ y; }); }
+inline Vec bitAnd(Vec a, Vec b) { return map(a, b, [](int32_t x, int32_t y) { return x & y; }); }
+inline Vec greaterThan(Vec a, Vec b) { return map(a, b, [](int32_t x, int32_t y) { return x > y ? -1 : 0; }); }
+inline Vec maximum(Vec a, Vec b) { return map(a, b, [](int32_t x, int32_t y) { return x > y ? x : y; }); }
+inline Vec select(Vec mask, Vec a, Vec b) {
+	Vec r;
+	for (unsigned i = 0; i < LANES; ++i) r.v[i] = mask.v[i] ? a.v[i] : b.v[i];
+	return r;
+}
+template <int N> inline Vec shiftLeft(Vec a) {
+	Vec r;
+	for (unsigned i = 0; i < LANES; ++i) r.v[i] = static_cast<int32_t>(static_cast<uint32_t>(a.v[i]) << N);
+	return r;
+}
+template <int N> inline Vec shiftRight(Vec a) {
+	Vec r;
+	for (unsigned i = 0; i < LANES; ++i) r.v[i] = static_cast<int32_t>(static_cast<uint32_t>(a.v[i]) >> N);
+	return r;
+}
+
+inline uint32_t laneBits(Vec mask) {
+	uint32_t bits = 0;
+	for (unsigned i = 0; i < LANES; ++i) bits |= (mask.v[i] ? 1u : 0u) << i;
+	return bits;
+}
+
+inline Vec laneMask(uint32_t bits) {
+	Vec r;
+	for (unsigned i = 0; i < LANES; ++i) r.v[i] = ((bits >> i) & 1u) ? -1 : 0;
+	return r;
+}
+
+const char* KERNEL_NAME = "scalar";
+
+#endif
+
+/**
+ * @brief Advances every lane's xorshift32 stream
+ */
+inline Vec nextRandom(Vec state) {
+	state = bitXor(state, shiftLeft<13>(state));
+	state = bitXor(state, shiftRight<17>(state));
+	return bitXor(state, shiftLeft<5>(state));
+}
+
+/**
+ * @brief Maps the top 16 random bits of every lane onto [1, sides]
+ */
+inline Vec dieRoll(Vec state, Vec sides, Vec one) {
+	return add(shiftRight<16>(mul(shiftRight<16>(state), sides)), one);
+}
+
+int32_t laneSeed(uint64_t seed, unsigned lane) {
+	// splitmix64 step per lane; xorshift32 must never start at zero
+	uint64_t z = seed + 0x9E3779B97F4A7C15ULL * (lane + 1);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	uint32_t state = static_cast<uint32_t>(z ^ (z >> 31));
+	return static_cast<int32_t>(state ? state : 0x6D2B79F5u);
+}
+
+} // namespace
+
+BatchResult simulateBatch(const CombatStats& player, const CombatStats& enemy, uint64_t fights, uint64_t seed) {
+	BatchResult result{ 0, 0, 0 };
+	if (fights == 0) {
+		return result;
+	}
+
+	int32_t seeds[LANES];
+	for (unsigned lane = 0; lane < LANES; ++lane) {
+		seeds[lane] = laneSeed(seed, lane);
+	}
+	Vec rng = load(seeds);
+
+	const Vec zero = set1(0);
+	const Vec one = set1(1);
+	const Vec d20 = set1(20);
+	const Vec playerDie = set1(Encounter::PLAYER_DAMAGE_DIE);
+	const Vec enemyDie = set1(Encounter::ENEMY_DAMAGE_DIE);
+	const Vec playerHitBelow = set1(Encounter::PLAYER_HIT_ROLL - 1);
+	const Vec enemyHitBelow = set1(Encounter::ENEMY_HIT_ROLL - 1);
+	const Vec playerStartHp = set1(player.hitPoints);
+	const Vec enemyStartHp = set1(enemy.hitPoints);
+	const Vec playerAttackVsDefense = set1(player.attack - enemy.defense);
+	const Vec enemyAttackVsDefense = set1(enemy.attack - player.defense);
+
+	uint64_t launched = fights < LANES ? fights : LANES;
+	uint32_t activeBits = launched == LANES ? ALL_LANES : (1u << launched) - 1;
+	Vec active = laneMask(activeBits);
+	Vec playerHp = playerStartHp;
+	Vec enemyHp = enemyStartHp;
+
+	while (activeBits != 0) {
+		result.rounds += static_cast<uint64_t>(std::popcount(activeBits));
+
+		// Player attacks
+		rng = nextRandom(rng);
+		Vec roll = dieRoll(rng, d20, one);
+		rng = nextRandom(rng);
+		Vec damage = maximum(one, add(playerAttackVsDefense, dieRoll(rng, playerDie, one)));
+		Vec hit = bitAnd(active, greaterThan(roll, playerHitBelow));
+		enemyHp = sub(enemyHp, bitAnd(hit, damage));
+		Vec enemyAlive = greaterThan(enemyHp, zero);
+
+		// Surviving enemies strike back
+		rng = nextRandom(rng);
+		roll = dieRoll(rng, d20, one);
+		rng = nextRandom(rng);
+		damage = maximum(one, add(enemyAttackVsDefense, dieRoll(rng, enemyDie, one)));
+		hit = bitAnd(bitAnd(active, enemyAlive), greaterThan(roll, enemyHitBelow));
+		playerHp = sub(playerHp, bitAnd(hit, damage));
+		Vec playerAlive = greaterThan(playerHp, zero);
+
+		uint32_t finishedBits = activeBits & ~laneBits(bitAnd(playerAlive, enemyAlive));
+		if (finishedBits == 0) {
+			continue;
+		}
+
+		result.fights += static_cast<uint64_t>(std::popcount(finishedBits));
+		result.playerWins += static_cast<uint64_t>(std::popcount(finishedBits & laneBits(playerAlive)));
+
+		// Refill finished lanes in lane order while fights remain, retire the rest
+		uint32_t refillBits = 0;
+		for (uint32_t bits = finishedBits; bits != 0 && launched < fights; bits &= bits - 1) {
+			refillBits |= bits & (~bits + 1);
+			launched++;
+		}
+		activeBits &= ~(finishedBits & ~refillBits);
+		active = laneMask(activeBits);
+
+		Vec refill = laneMask(refillBits);
+		playerHp = select(refill, playerStartHp, playerHp);
+		enemyHp = select(refill, enemyStartHp, enemyHp);
+	}
+
+	return result;
+}
+
+const char* batchKernelName() {
+	return KERNEL_NAME;
+}
\ No newline at end of file
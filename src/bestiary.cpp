@@ -0,0 +1,69 @@
+#include "bestiary.h"
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+
+using Chunk = std::array<Creature, Bestiary::CHUNK_SIZE>;
+
+// Chunks are published once and live as long as the process
+std::array<std::atomic<Chunk*>, Bestiary::MAX_CREATURES / Bestiary::CHUNK_SIZE> chunks{};
+std::atomic<size_t> count{ 0 };
+std::mutex defineMutex;
+
+/**
+ * @brief Identity of a creature for deduplication
+ */
+std::string creatureKey(const std::string& name, int hitPoints, int attack, int defense, Side side, int mindAttack) {
+	std::string key = name;
+	key += '\0';
+	for (int value : { hitPoints, attack, defense, static_cast<int>(side), mindAttack }) {
+		key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+	}
+	return key;
+}
+
+std::unordered_map<std::string, CreatureID>& knownCreatures() {
+	static std::unordered_map<std::string, CreatureID> known;
+	return known;
+}
+
+} // namespace
+
+CreatureID Bestiary::define(const std::string& name, int hitPoints, int attack, int defense, Side side, int mindAttack) {
+	std::string key = creatureKey(name, hitPoints, attack, defense, side, mindAttack);
+	std::lock_guard<std::mutex> lock(defineMutex);
+	auto& known = knownCreatures();
+	auto it = known.find(key);
+	if (it != known.end()) {
+		return it->second;
+	}
+
+	size_t index = count.load(std::memory_order_relaxed);
+	if (index >= MAX_CREATURES) {
+		return NONE;
+	}
+	std::atomic<Chunk*>& slot = chunks[index / CHUNK_SIZE];
+	Chunk* chunk = slot.load(std::memory_order_relaxed);
+	if (!chunk) {
+		chunk = new Chunk();
+		slot.store(chunk, std::memory_order_release);
+	}
+	(*chunk)[index % CHUNK_SIZE] = Creature{ name, hitPoints, attack, defense, side, mindAttack };
+
+	// Publishing the count makes the prototype visible to readers on other threads
+	count.store(index + 1, std::memory_order_release);
+	CreatureID id = static_cast<CreatureID>(index);
+	known.emplace(std::move(key), id);
+	return id;
+}
+
+const Creature& Bestiary::get(CreatureID id) {
+	return (*chunks[id / CHUNK_SIZE].load(std::memory_order_acquire))[id % CHUNK_SIZE];
+}
+
+size_t Bestiary::size() {
+	return count.load(std::memory_order_acquire);
+}
\ No newline at end of file
@@ -0,0 +1,253 @@
+#include "combatlog.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include "bestiary.h"
+
+namespace {
+
+constexpr char LOG_MAGIC[4] = { 'L', 'W', 'C', 'L' };
+constexpr uint32_t LOG_VERSION = 1;
+constexpr size_t MAX_NAME = 255;
+constexpr size_t MAX_LOGGED_CREATURES = 32768;   // JOIN events hold the creature in an int16
+
+std::atomic<bool> logOpen{ false };
+std::mutex logMutex;
+std::ofstream logFile;
+std::unordered_map<CreatureID, int16_t> loggedCreatures;   // Number of each creature in the log
+
+template <typename T>
+void writeValue(std::ofstream& out, const T& value) {
+	out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+bool readValue(std::ifstream& in, T& value) {
+	return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+/**
+ * @brief Number of a creature in the log, defining it on first use
+ */
+int16_t logCreature(CreatureID id) {
+	auto it = loggedCreatures.find(id);
+	if (it != loggedCreatures.end()) {
+		return it->second;
+	}
+	if (loggedCreatures.size() >= MAX_LOGGED_CREATURES) {
+		return -1;
+	}
+
+	const Creature& creature = Bestiary::get(id);
+	size_t nameLength = std::min(creature.name.size(), MAX_NAME);
+	CombatEvent define{ CombatEventType::CREATURE, static_cast<uint8_t>(creature.side), 0,
+		static_cast<uint8_t>(nameLength), static_cast<int16_t>(creature.attack), static_cast<int16_t>(creature.defense) };
+	writeValue(logFile, define);
+	writeValue(logFile, static_cast<int32_t>(creature.hitPoints));
+	logFile.write(creature.name.data(), static_cast<std::streamsize>(nameLength));
+
+	auto number = static_cast<int16_t>(loggedCreatures.size());
+	loggedCreatures.emplace(id, number);
+	return number;
+}
+
+/**
+ * @brief Outcome of the fights against one kind of enemy
+ */
+struct EnemyRecord {
+	long long fights = 0;
+	long long wins = 0;
+	long long deaths = 0;
+	long long escapes = 0;
+	long long rounds = 0;
+	long long damageTaken = 0;   // Damage the player took in those fights
+};
+
+} // namespace
+
+CombatStream::CombatStream(const Encounter& fight, CombatSink* output)
+	: encounter(fight), sink(output), keep(CombatLog::isOpen()) {
+	emit({ CombatEventType::BEGIN, 0, 0, 0, static_cast<int16_t>(encounter.size()) });
+	for (size_t i = 0; i < encounter.size(); ++i) {
+		if (encounter.isAlive(i)) {
+			emit({ CombatEventType::JOIN, actorOf(i), 0, 0, static_cast<int16_t>(encounter.getHitPoints(i)) });
+		}
+	}
+}
+
+CombatStream::~CombatStream() {
+	if (keep) {
+		CombatLog::write(encounter, events);
+	}
+}
+
+void CombatStream::emit(const CombatEvent& event) {
+	if (keep) {
+		events.push_back(event);
+	}
+	if (sink) {
+		sink->onEvent(event);
+	}
+}
+
+void CombatStream::attack(uint8_t actor, uint8_t target, int roll, bool hit, int damage, int remaining) {
+	emit({ hit ? CombatEventType::HIT : CombatEventType::MISS, actor, target, static_cast<uint8_t>(roll),
+		static_cast<int16_t>(std::min(damage, INT16_MAX)), static_cast<int16_t>(std::min(remaining, INT16_MAX)) });
+}
+
+void CombatStream::flee(int roll, bool escaped) {
+	emit({ escaped ? CombatEventType::FLED : CombatEventType::FLEE_FAILED, CombatEvent::PLAYER, 0, static_cast<uint8_t>(roll) });
+}
+
+void CombatStream::end(bool won) {
+	emit({ won ? CombatEventType::VICTORY : CombatEventType::DEFEAT, CombatEvent::PLAYER });
+}
+
+uint8_t CombatStream::actorOf(size_t index) {
+	return static_cast<uint8_t>(std::min<size_t>(index, CombatEvent::PLAYER - 1));
+}
+
+bool CombatLog::open(const std::string& path) {
+	std::lock_guard<std::mutex> lock(logMutex);
+	logFile.open(path, std::ios::binary | std::ios::trunc);
+	if (!logFile) {
+		return false;
+	}
+	logFile.write(LOG_MAGIC, sizeof(LOG_MAGIC));
+	writeValue(logFile, LOG_VERSION);
+	loggedCreatures.clear();
+	logOpen.store(true, std::memory_order_release);
+	return true;
+}
+
+void CombatLog::close() {
+	std::lock_guard<std::mutex> lock(logMutex);
+	logOpen.store(false, std::memory_order_release);
+	if (logFile.is_open()) {
+		logFile.close();
+	}
+}
+
+bool CombatLog::isOpen() {
+	return logOpen.load(std::memory_order_acquire);
+}
+
+void CombatLog::write(const Encounter& encounter, std::span<const CombatEvent> events) {
+	std::lock_guard<std::mutex> lock(logMutex);
+	if (!logFile.is_open()) {
+		return;
+	}
+	for (CombatEvent event : events) {
+		if (event.type == CombatEventType::JOIN && event.actor < encounter.size()) {
+			event.remaining = logCreature(encounter.getCreature(event.actor));
+		}
+		writeValue(logFile, event);
+	}
+}
+
+bool CombatLog::summarize(const std::string& path, std::ostream& out, std::string& error) {
+	std::ifstream in(path, std::ios::binary);
+	char magic[sizeof(LOG_MAGIC)];
+	uint32_t version;
+	if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, LOG_MAGIC, sizeof(magic)) != 0
+		|| !readValue(in, version) || version != LOG_VERSION) {
+		error = path + " is not a combat log";
+		return false;
+	}
+
+	std::vector<std::string> names;            // By number in the log
+	std::vector<bool> enemies;
+	std::map<std::string, EnemyRecord> records;
+	std::vector<int16_t> foes;                 // Enemy creatures of the current fight
+	long long fights = 0;
+	long long events = 0;
+	int rounds = 0;
+	int damageTaken = 0;
+
+	// Credits the fight that just ended to every kind of enemy in it
+	auto finishFight = [&](bool won, bool died) {
+		std::sort(foes.begin(), foes.end());
+		foes.erase(std::unique(foes.begin(), foes.end()), foes.end());
+		for (int16_t foe : foes) {
+			EnemyRecord& record = records[names[static_cast<size_t>(foe)]];
+			record.fights++;
+			record.wins += won;
+			record.deaths += died;
+			record.escapes += !won && !died;
+			record.rounds += rounds;
+			record.damageTaken += damageTaken;
+		}
+		foes.clear();
+	};
+
+	CombatEvent event;
+	bool inFight = false;
+	while (readValue(in, event)) {
+		events++;
+		switch (event.type) {
+		case CombatEventType::CREATURE: {
+			int32_t hitPoints;
+			std::string name(event.roll, '\0');
+			if (!readValue(in, hitPoints) || !in.read(name.data(), static_cast<std::streamsize>(name.size()))) {
+				error = path + " ends in the middle of a creature";
+				return false;
+			}
+			names.push_back(std::move(name));
+			enemies.push_back(static_cast<Side>(event.actor) == Side::ENEMY);
+			break;
+		}
+		case CombatEventType::BEGIN:
+			if (inFight) finishFight(false, false);
+			inFight = true;
+			fights++;
+			rounds = 0;
+			damageTaken = 0;
+			break;
+		case CombatEventType::JOIN:
+			if (event.remaining >= 0 && static_cast<size_t>(event.remaining) < names.size()
+				&& enemies[static_cast<size_t>(event.remaining)]) {
+				foes.push_back(event.remaining);
+			}
+			break;
+		case CombatEventType::HIT:
+		case CombatEventType::MISS:
+			if (event.actor == CombatEvent::PLAYER) rounds++;
+			if (event.type == CombatEventType::HIT && event.target == CombatEvent::PLAYER) damageTaken += event.value;
+			break;
+		case CombatEventType::FLEE_FAILED:
+			rounds++;
+			break;
+		case CombatEventType::FLED:
+			rounds++;
+			finishFight(false, false);
+			inFight = false;
+			break;
+		case CombatEventType::VICTORY:
+		case CombatEventType::DEFEAT:
+			finishFight(event.type == CombatEventType::VICTORY, event.type == CombatEventType::DEFEAT);
+			inFight = false;
+			break;
+		default:
+			break;
+		}
+	}
+	if (inFight) finishFight(false, false);
+
+	out << "\n- - - Combat Log " << path << " (" << fights << " fights, " << events << " events) - - -\n";
+	for (const auto& [name, record] : records) {
+		double count = static_cast<double>(record.fights);
+		out << std::left << std::setw(20) << name << std::right << " " << std::setw(8) << record.fights << " fights, "
+			<< std::fixed << std::setprecision(1)
+			<< 100.0 * static_cast<double>(record.wins) / count << "% won, "
+			<< 100.0 * static_cast<double>(record.deaths) / count << "% died, "
+			<< 100.0 * static_cast<double>(record.escapes) / count << "% escaped, "
+			<< static_cast<double>(record.rounds) / count << " rounds, "
+			<< static_cast<double>(record.damageTaken) / count << " damage taken\n";
+	}
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,149 @@
+#include "command.h"
+#include <charconv>
+
+namespace {
+
+bool isSpace(char c) {
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+bool isSeparator(char c) {
+	return c == ';' || c == ',';
+}
+
+bool isDigit(char c) {
+	return c >= '0' && c <= '9';
+}
+
+char lowerLetter(char c) {
+	if (c >= 'A' && c <= 'Z') return static_cast<char>(c - 'A' + 'a');
+	return c >= 'a' && c <= 'z' ? c : '\0';
+}
+
+const CommandVerb* findVerb(std::span<const CommandVerb> verbs, const std::string& name) {
+	const CommandVerb* wildcard = nullptr;
+	for (const CommandVerb& verb : verbs) {
+		if (verb.name == name) return &verb;
+		if (verb.name == "*") wildcard = &verb;
+	}
+	return wildcard;
+}
+
+} // namespace
+
+bool CommandReader::parse(std::string_view text, std::deque<Command>& out) {
+	bool verbOpen = false;   // The last command is a verb that may still take a number
+	size_t limit = out.size() + MAX_LINE_COMMANDS;
+	size_t pos = 0;
+	while (pos < text.size()) {
+		if (isSeparator(text[pos])) {
+			verbOpen = false;
+			++pos;
+			continue;
+		}
+		if (isSpace(text[pos])) {
+			++pos;
+			continue;
+		}
+
+		size_t end = pos;
+		while (end < text.size() && !isSpace(text[end]) && !isSeparator(text[end])) {
+			++end;
+		}
+		std::string_view token = text.substr(pos, end - pos);
+		pos = end;
+
+		if (isDigit(token[0]) || token[0] == '-') {
+			long long value;
+			auto [last, error] = std::from_chars(token.data(), token.data() + token.size(), value);
+			if (error != std::errc() || last != token.data() + token.size()) return false;
+			if (verbOpen) {
+				out.back().number = value;
+				out.back().hasNumber = true;
+				verbOpen = false;
+			}
+			else {
+				if (out.size() == limit) return false;
+				Command command;
+				command.number = value;
+				command.hasNumber = true;
+				out.push_back(std::move(command));
+			}
+			continue;
+		}
+
+		if (out.size() == limit) return false;
+		Command command;
+		command.verb.reserve(token.size());
+		for (char c : token) {
+			char letter = lowerLetter(c);
+			if (!letter) return false;
+			command.verb += letter;
+		}
+		out.push_back(std::move(command));
+		verbOpen = true;
+	}
+	return true;
+}
+
+bool CommandReader::next(std::istream& in, Command& command, bool& malformed) {
+	malformed = false;
+	while (pending.empty()) {
+		auto began = std::chrono::steady_clock::now();
+		bool read = static_cast<bool>(std::getline(in, line));
+		inputWait += std::chrono::steady_clock::now() - began;
+		if (!read) return false;
+		if (!parse(line, pending)) {
+			pending.clear();
+			malformed = true;
+			return false;
+		}
+	}
+	command = std::move(pending.front());
+	pending.pop_front();
+	return true;
+}
+
+void CommandReader::pushFront(Command command) {
+	pending.push_front(std::move(command));
+}
+
+void CommandReader::discard() {
+	pending.clear();
+}
+
+std::chrono::steady_clock::duration CommandReader::waited() const {
+	return inputWait;
+}
+
+bool resolveCommand(CommandReader& reader, const Command& command, std::span<const CommandVerb> verbs, size_t& option) {
+	if (command.verb.empty()) {
+		if (command.number < 0) return false;
+		option = static_cast<size_t>(command.number);
+		return true;
+	}
+
+	const CommandVerb* verb = findVerb(verbs, command.verb);
+	if (!verb) return false;
+
+	switch (verb->use) {
+	case VerbUse::NUMBERED:
+		if (!command.hasNumber || command.number < 0) return false;
+		option = static_cast<size_t>(command.number);
+		return true;
+	case VerbUse::FORWARD:
+		reader.pushFront(command);
+		break;
+	default:
+		if (command.hasNumber) {
+			Command argument;
+			argument.number = command.number;
+			argument.hasNumber = true;
+			argument.argument = true;
+			reader.pushFront(std::move(argument));
+		}
+		break;
+	}
+	option = verb->option;
+	return true;
+}
\ No newline at end of file
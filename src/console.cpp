@@ -0,0 +1,65 @@
+#include "console.h"
+#include <iostream>
+#include <thread>
+#include <utility>
+
+namespace {
+
+/**
+ * @brief Host for the terminal the process was started from
+ */
+class TerminalHost : public ConsoleHost {
+public:
+	std::istream& in() override {
+		return std::cin;
+	}
+
+	std::ostream& out() override {
+		return std::cout;
+	}
+
+	void pause(std::chrono::milliseconds duration) override {
+		std::this_thread::sleep_for(duration);
+	}
+};
+
+TerminalHost terminal;
+thread_local ConsoleHost* currentHost = &terminal;
+
+} // namespace
+
+void ConsoleHost::publish(GameEvent&& event) {
+	presentEvent(event, out());
+}
+
+CommandReader& ConsoleHost::commands() {
+	return reader;
+}
+
+std::istream& Console::in() {
+	return currentHost->in();
+}
+
+std::ostream& Console::out() {
+	return currentHost->out();
+}
+
+void Console::pause(std::chrono::milliseconds duration) {
+	currentHost->pause(duration);
+}
+
+bool Console::sharesThread() {
+	return currentHost->sharesThread();
+}
+
+void Console::publish(GameEvent event) {
+	currentHost->publish(std::move(event));
+}
+
+CommandReader& Console::commands() {
+	return currentHost->commands();
+}
+
+void Console::setHost(ConsoleHost* host) {
+	currentHost = host ? host : &terminal;
+}
\ No newline at end of file
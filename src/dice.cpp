@@ -0,0 +1,410 @@
+#include "dice.h"
+#include <chrono>
+#include <cctype>
+#include <iomanip>
+#include <random>
+#include <utility>
+
+namespace {
+
+constexpr int MAX_NUMBER = 100000;       // Largest constant or threshold, so totals never overflow
+constexpr size_t REPORT_ROWS = 100;      // Totals a report lists one by one
+constexpr size_t REPORT_BATCH = 4096;    // Totals rolled per batch
+constexpr int REPORT_BAR = 40;           // Characters of the most likely total's bar
+
+/**
+ * @brief Reads an expression left to right, skipping spaces before every token
+ */
+class Parser {
+private:
+	std::string_view source;
+	size_t pos = 0;
+
+	void skipSpaces() {
+		while (pos < source.size() && std::isspace(static_cast<unsigned char>(source[pos]))) pos++;
+	}
+
+public:
+	explicit Parser(std::string_view text) : source(text) {}
+
+	bool atEnd() {
+		skipSpaces();
+		return pos == source.size();
+	}
+
+	char peek() {
+		skipSpaces();
+		return pos < source.size() ? source[pos] : '\0';
+	}
+
+	/**
+	 * @brief Whether a die follows: a 'd' and the first digit of its sides
+	 */
+	bool atDie() {
+		skipSpaces();
+		return pos + 1 < source.size() && source[pos] == 'd' && std::isdigit(static_cast<unsigned char>(source[pos + 1]));
+	}
+
+	bool match(std::string_view token) {
+		skipSpaces();
+		if (source.substr(pos, token.size()) != token) return false;
+		pos += token.size();
+		return true;
+	}
+
+	bool number(int& value) {
+		skipSpaces();
+		size_t start = pos;
+		value = 0;
+		while (pos < source.size() && std::isdigit(static_cast<unsigned char>(source[pos]))) {
+			value = std::min(value * 10 + (source[pos] - '0'), MAX_NUMBER + 1);
+			pos++;
+		}
+		return pos > start;
+	}
+
+	bool name(std::string_view& value) {
+		skipSpaces();
+		size_t start = pos;
+		while (pos < source.size() && (std::isalnum(static_cast<unsigned char>(source[pos])) || source[pos] == '_')) pos++;
+		value = source.substr(start, pos - start);
+		return pos > start && !std::isdigit(static_cast<unsigned char>(value.front()));
+	}
+
+	std::string where() const {
+		return " at column " + std::to_string(pos + 1);
+	}
+};
+
+/**
+ * @brief Drops totals that cannot happen from both ends
+ */
+void trim(DiceDistribution& dist) {
+	size_t first = 0;
+	while (first + 1 < dist.chances.size() && dist.chances[first] == 0) first++;
+	size_t last = dist.chances.size();
+	while (last > first + 1 && dist.chances[last - 1] == 0) last--;
+	dist.chances.erase(dist.chances.begin() + static_cast<std::ptrdiff_t>(last), dist.chances.end());
+	dist.chances.erase(dist.chances.begin(), dist.chances.begin() + static_cast<std::ptrdiff_t>(first));
+	dist.minimum += static_cast<int>(first);
+}
+
+/**
+ * @brief Adds one die to a distribution; a window sum over the previous chances
+ */
+DiceDistribution addDie(const DiceDistribution& dist, int sides) {
+	DiceDistribution sum;
+	sum.minimum = dist.minimum + 1;
+	sum.chances.assign(dist.chances.size() + static_cast<size_t>(sides) - 1, 0.0);
+	double window = 0;
+	for (size_t i = 0; i < sum.chances.size(); ++i) {
+		if (i < dist.chances.size()) window += dist.chances[i];
+		if (i >= static_cast<size_t>(sides)) window -= dist.chances[i - static_cast<size_t>(sides)];
+		sum.chances[i] = window / sides;
+	}
+	return sum;
+}
+
+DiceDistribution convolve(const DiceDistribution& a, const DiceDistribution& b) {
+	DiceDistribution sum;
+	sum.minimum = a.minimum + b.minimum;
+	sum.chances.assign(a.chances.size() + b.chances.size() - 1, 0.0);
+	for (size_t i = 0; i < a.chances.size(); ++i) {
+		if (a.chances[i] == 0) continue;
+		for (size_t j = 0; j < b.chances.size(); ++j) {
+			sum.chances[i + j] += a.chances[i] * b.chances[j];
+		}
+	}
+	return sum;
+}
+
+DiceDistribution negate(const DiceDistribution& dist) {
+	DiceDistribution negated;
+	negated.minimum = -dist.maximum();
+	negated.chances.assign(dist.chances.rbegin(), dist.chances.rend());
+	return negated;
+}
+
+} // namespace
+
+int DiceDistribution::maximum() const {
+	return minimum + static_cast<int>(chances.size()) - 1;
+}
+
+double DiceDistribution::chance(int total) const {
+	if (total < minimum || total > maximum()) return 0;
+	return chances[static_cast<size_t>(total - minimum)];
+}
+
+double DiceDistribution::mean() const {
+	double sum = 0;
+	for (size_t i = 0; i < chances.size(); ++i) {
+		sum += chances[i] * (minimum + static_cast<int>(i));
+	}
+	return sum;
+}
+
+bool DiceExpression::compile(std::string_view source, std::initializer_list<std::string_view> variables,
+	DiceExpression& expression, std::string& error) {
+	assert(variables.size() <= MAX_VARIABLES);
+	DiceExpression compiled;
+	compiled.text.assign(source);
+	compiled.variableCount = variables.size();
+	Parser parser(source);
+
+	auto variableIndex = [&](std::string_view name) {
+		for (size_t i = 0; i < variables.size(); ++i) {
+			if (variables.begin()[i] == name) return static_cast<int>(i);
+		}
+		return -1;
+	};
+
+	int sign = parser.match("-") ? -1 : 1;
+	if (sign > 0) parser.match("+");
+	size_t terms = 0;
+	while (true) {
+		Term term{ static_cast<int8_t>(sign), true, 0, 0, 0 };
+		int count = 1;
+		std::string_view name;
+		bool counted = !parser.atDie() && parser.number(count);
+		if (parser.atDie()) {
+			parser.match("d");
+			int sides;
+			parser.number(sides);
+			if (count < 1 || count > MAX_DICE) {
+				error = "between 1 and " + std::to_string(MAX_DICE) + " dice can be rolled at once" + parser.where();
+				return false;
+			}
+			if (sides < 1 || sides > MAX_SIDES) {
+				error = "dice have between 1 and " + std::to_string(MAX_SIDES) + " sides" + parser.where();
+				return false;
+			}
+			int keep = count;
+			bool highest = parser.match("kh");
+			if (highest || parser.match("kl")) {
+				if (!parser.number(keep) || keep < 1 || keep > count) {
+					error = "expected the number of dice to keep, 1 to " + std::to_string(count) + parser.where();
+					return false;
+				}
+			}
+			term.keepHighest = highest || keep == count;
+			term.count = static_cast<int8_t>(count);
+			term.keep = static_cast<int8_t>(keep);
+			term.sides = static_cast<int16_t>(sides);
+			compiled.terms.push_back(term);
+		}
+		else if (counted) {
+			if (count > MAX_NUMBER) {
+				error = "number over " + std::to_string(MAX_NUMBER) + parser.where();
+				return false;
+			}
+			compiled.offset += sign * count;
+		}
+		else if (parser.name(name)) {
+			int index = variableIndex(name);
+			if (index < 0) {
+				error = "unknown name '" + std::string(name) + "'" + parser.where();
+				return false;
+			}
+			compiled.weights[static_cast<size_t>(index)] += static_cast<int8_t>(sign);
+		}
+		else {
+			error = "expected dice, a number or a name" + parser.where();
+			return false;
+		}
+
+		if (++terms > MAX_TERMS) {
+			error = "more than " + std::to_string(MAX_TERMS) + " terms";
+			return false;
+		}
+		if (parser.match("+")) {
+			sign = 1;
+		}
+		else if (parser.match("-")) {
+			sign = -1;
+		}
+		else {
+			break;
+		}
+	}
+
+	// Longer operators first, so ">=" is not read as ">"
+	constexpr std::pair<std::string_view, DiceCompare> TESTS[] = {
+		{ ">=", DiceCompare::AT_LEAST },
+		{ "<=", DiceCompare::AT_MOST },
+		{ "==", DiceCompare::EQUAL },
+		{ ">", DiceCompare::ABOVE },
+		{ "<", DiceCompare::BELOW },
+		{ "=", DiceCompare::EQUAL }
+	};
+	for (const auto& [token, test] : TESTS) {
+		if (!parser.match(token)) continue;
+		compiled.compare = test;
+		std::string_view name;
+		int thresholdSign = parser.match("-") ? -1 : 1;
+		if (parser.number(compiled.threshold)) {
+			if (compiled.threshold > MAX_NUMBER) {
+				error = "number over " + std::to_string(MAX_NUMBER) + parser.where();
+				return false;
+			}
+			compiled.threshold *= thresholdSign;
+		}
+		else if (thresholdSign > 0 && parser.name(name)) {
+			compiled.thresholdVariable = variableIndex(name);
+			if (compiled.thresholdVariable < 0) {
+				error = "unknown name '" + std::string(name) + "'" + parser.where();
+				return false;
+			}
+		}
+		else {
+			error = "expected a number or a name to test against" + parser.where();
+			return false;
+		}
+		break;
+	}
+
+	if (!parser.atEnd()) {
+		error = "unexpected '" + std::string(1, parser.peek()) + "'" + parser.where();
+		return false;
+	}
+	if (compiled.terms.size() == 1 && compiled.terms[0].count == 1 && compiled.terms[0].sign > 0) {
+		compiled.singleDie = compiled.terms[0].sides;
+	}
+	expression = std::move(compiled);
+	return true;
+}
+
+const std::string& DiceExpression::getText() const {
+	return text;
+}
+
+bool DiceExpression::hasTest() const {
+	return compare != DiceCompare::NONE;
+}
+
+int DiceExpression::largestDie() const {
+	int largest = 0;
+	for (const Term& term : terms) {
+		largest = std::max(largest, static_cast<int>(term.sides));
+	}
+	return largest;
+}
+
+DiceDistribution DiceExpression::termDistribution(const Term& term) {
+	DiceDistribution dist{ 0, { 1.0 } };
+	if (term.keep == term.count) {
+		for (int i = 0; i < term.count; ++i) {
+			dist = addDie(dist, term.sides);
+		}
+		return dist;
+	}
+
+	// Faces are visited from the kept end; the first `keep` dice to show a face are the kept ones
+	size_t count = static_cast<size_t>(term.count);
+	size_t keep = static_cast<size_t>(term.keep);
+	size_t sums = keep * static_cast<size_t>(term.sides) + 1;
+	std::vector<std::vector<double>> binomial(count + 1, std::vector<double>(count + 1, 0.0));
+	for (size_t n = 0; n <= count; ++n) {
+		binomial[n][0] = 1;
+		for (size_t k = 1; k <= n; ++k) {
+			binomial[n][k] = binomial[n - 1][k - 1] + (k <= n - 1 ? binomial[n - 1][k] : 0);
+		}
+	}
+	// ways[n][sum]: orderings of n dice placed so far whose kept dice add up to sum
+	std::vector<std::vector<double>> ways(count + 1, std::vector<double>(sums, 0.0));
+	ways[0][0] = 1;
+	for (int step = 0; step < term.sides; ++step) {
+		size_t face = static_cast<size_t>(term.keepHighest ? term.sides - step : step + 1);
+		std::vector<std::vector<double>> next(count + 1, std::vector<double>(sums, 0.0));
+		for (size_t placed = 0; placed <= count; ++placed) {
+			for (size_t sum = 0; sum < sums; ++sum) {
+				double w = ways[placed][sum];
+				if (w == 0) continue;
+				for (size_t showing = 0; placed + showing <= count; ++showing) {
+					size_t kept = std::min(placed + showing, keep) - std::min(placed, keep);
+					next[placed + showing][sum + face * kept] += w * binomial[count - placed][showing];
+				}
+			}
+		}
+		ways = std::move(next);
+	}
+
+	double total = 0;
+	for (double w : ways[count]) total += w;
+	dist.chances.resize(sums);
+	for (size_t sum = 0; sum < sums; ++sum) {
+		dist.chances[sum] = ways[count][sum] / total;
+	}
+	trim(dist);
+	return dist;
+}
+
+DiceDistribution DiceExpression::distribution(std::initializer_list<int> values) const {
+	assert(values.size() >= variableCount);
+	DiceDistribution dist{ fixedPart(values.begin()), { 1.0 } };
+	for (const Term& term : terms) {
+		DiceDistribution dice = termDistribution(term);
+		dist = convolve(dist, term.sign > 0 ? dice : negate(dice));
+	}
+	return dist;
+}
+
+double DiceExpression::successChance(std::initializer_list<int> values) const {
+	DiceDistribution dist = distribution(values);
+	double chance = 0;
+	for (int total = dist.minimum; total <= dist.maximum(); ++total) {
+		if (succeeds(total, values)) chance += dist.chance(total);
+	}
+	return chance;
+}
+
+bool printDiceReport(std::string_view source, size_t rolls, std::ostream& out, std::string& error) {
+	DiceExpression expression;
+	if (!DiceExpression::compile(source, {}, expression, error)) {
+		return false;
+	}
+	DiceDistribution exact = expression.distribution();
+
+	std::vector<uint64_t> counts(exact.chances.size(), 0);
+	std::vector<int> totals(REPORT_BATCH);
+	FastRng rng(std::random_device{}());
+	size_t rolled = 0;
+	double sum = 0;
+	auto start = std::chrono::steady_clock::now();
+	while (rolled < rolls) {
+		std::span<int> batch(totals.data(), std::min(REPORT_BATCH, rolls - rolled));
+		expression.rollBatch(rng, batch);
+		for (int total : batch) {
+			counts[static_cast<size_t>(total - exact.minimum)]++;
+			sum += total;
+		}
+		rolled += batch.size();
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	out << "\n- - - " << expression.getText() << " - - -\n";
+	out << std::fixed;
+	if (exact.chances.size() <= REPORT_ROWS) {
+		double likeliest = *std::max_element(exact.chances.begin(), exact.chances.end());
+		out << " Total   Exact  Rolled\n";
+		for (size_t i = 0; i < exact.chances.size(); ++i) {
+			double rolledShare = static_cast<double>(counts[i]) / static_cast<double>(rolls);
+			out << std::setw(6) << exact.minimum + static_cast<int>(i)
+				<< std::setprecision(2) << std::setw(7) << 100 * exact.chances[i] << "%"
+				<< std::setw(7) << 100 * rolledShare << "%  "
+				<< std::string(static_cast<size_t>(REPORT_BAR * exact.chances[i] / likeliest + 0.5), '#') << "\n";
+		}
+	}
+	out << "Totals " << exact.minimum << " to " << exact.maximum()
+		<< ", mean " << std::setprecision(3) << exact.mean() << " (rolled " << sum / static_cast<double>(rolls) << ")\n";
+	if (expression.hasTest()) {
+		uint64_t passed = 0;
+		for (size_t i = 0; i < counts.size(); ++i) {
+			if (expression.succeeds(exact.minimum + static_cast<int>(i))) passed += counts[i];
+		}
+		out << "Passes " << std::setprecision(2) << 100 * expression.successChance() << "% (rolled "
+			<< 100.0 * static_cast<double>(passed) / static_cast<double>(rolls) << "%)\n";
+	}
+	out << std::setprecision(1) << static_cast<double>(rolls) / elapsed.count() / 1e6 << " M rolls/s in batches of " << REPORT_BATCH << "\n";
+	return true;
+}
\ No newline at end of file
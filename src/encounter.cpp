@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <cassert>
+#include <span>
+#include <vector>
+#include "encounter.h"
+#include "combatlog.h"
+#include "bestiary.h"
+#include "utility.h"
+
+size_t Encounter::addCombatant(CreatureID creature) {
+	creatures.push_back(creature);
+	hitPoints.push_back(Bestiary::get(creature).hitPoints);
+	return creatures.size() - 1;
+}
+
+size_t Encounter::size() const {
+	return creatures.size();
+}
+
+CreatureID Encounter::getCreature(size_t index) const {
+	return creatures[index];
+}
+
+const std::string& Encounter::getName(size_t index) const {
+	return Bestiary::get(creatures[index]).name;
+}
+
+int Encounter::getHitPoints(size_t index) const {
+	return hitPoints[index];
+}
+
+int Encounter::getMaxHitPoints(size_t index) const {
+	return Bestiary::get(creatures[index]).hitPoints;
+}
+
+int Encounter::getAttackValue(size_t index) const {
+	return Bestiary::get(creatures[index]).attack;
+}
+
+int Encounter::getDefenseValue(size_t index) const {
+	return Bestiary::get(creatures[index]).defense;
+}
+
+Side Encounter::getSide(size_t index) const {
+	return Bestiary::get(creatures[index]).side;
+}
+
+bool Encounter::isAlive(size_t index) const {
+	return hitPoints[index] > 0;
+}
+
+int Encounter::takeDamage(size_t index, int damage) {
+	int actualDamage = std::max(1, damage - getDefenseValue(index));
+	hitPoints[index] = std::max(0, hitPoints[index] - actualDamage);
+	return actualDamage;
+}
+
+void Encounter::setHitPoints(size_t index, int hp) {
+	hitPoints[index] = std::clamp(hp, 0, getMaxHitPoints(index));
+}
+
+void Encounter::reset() {
+	for (size_t i = 0; i < creatures.size(); ++i) {
+		hitPoints[i] = getMaxHitPoints(i);
+	}
+}
+
+namespace {
+
+// Combat helpers take the side of combatant i from a callable, so they run over
+// prototype lookups as well as over gathered arrays
+template <typename SideOf>
+size_t countLivingIn(const int* hp, SideOf sideOf, size_t count, Side side) {
+	size_t living = 0;
+	for (size_t i = 0; i < count; ++i) {
+		living += (sideOf(i) == side && hp[i] > 0);
+	}
+	return living;
+}
+
+template <typename SideOf>
+size_t weakestEnemyIn(const int* hp, SideOf sideOf, size_t count) {
+	size_t weakest = count;
+	for (size_t i = 0; i < count; ++i) {
+		if (sideOf(i) != Side::ENEMY || hp[i] <= 0) continue;
+		if (weakest == count || hp[i] < hp[weakest]) {
+			weakest = i;
+		}
+	}
+	return weakest;
+}
+
+template <typename SideOf>
+size_t enemyTargetIn(const int* hp, SideOf sideOf, size_t count, size_t attacker) {
+	// Slot 0 is the player, the remaining slots are the living allies in order
+	size_t slots = 1 + countLivingIn(hp, sideOf, count, Side::ALLY);
+	size_t slot = attacker % slots;
+	if (slot == 0) {
+		return count;
+	}
+	for (size_t i = 0; i < count; ++i) {
+		if (sideOf(i) == Side::ALLY && hp[i] > 0 && --slot == 0) {
+			return i;
+		}
+	}
+	return count;
+}
+
+int applyDamage(int& hp, int damage, int defense) {
+	int actualDamage = std::max(1, damage - defense);
+	hp = std::max(0, hp - actualDamage);
+	return actualDamage;
+}
+
+DiceExpression rule(const std::string& source, std::initializer_list<std::string_view> variables = {}) {
+	DiceExpression expression;
+	std::string error;
+	[[maybe_unused]] bool compiled = DiceExpression::compile(source, variables, expression, error);
+	assert(compiled && "combat rules must compile");
+	return expression;
+}
+
+} // namespace
+
+const CombatDice& Encounter::dice() {
+	static const CombatDice rules{
+		rule("1d20>=" + std::to_string(PLAYER_HIT_ROLL)),
+		rule("1d20>=" + std::to_string(ENEMY_HIT_ROLL)),
+		rule("1d20>=" + std::to_string(FLEE_ROLL)),
+		rule("1d" + std::to_string(PLAYER_DAMAGE_DIE) + "+atk", { "atk" }),
+		rule("1d" + std::to_string(ENEMY_DAMAGE_DIE) + "+atk", { "atk" })
+	};
+	return rules;
+}
+
+size_t Encounter::countLiving(Side side) const {
+	return countLivingIn(hitPoints.data(), [this](size_t i) { return getSide(i); }, size(), side);
+}
+
+size_t Encounter::weakestEnemy() const {
+	return weakestEnemyIn(hitPoints.data(), [this](size_t i) { return getSide(i); }, size());
+}
+
+size_t Encounter::mindAttacker() const {
+	size_t attacker = size();
+	int strongest = 0;
+	for (size_t i = 0; i < size(); ++i) {
+		if (getSide(i) == Side::ENEMY && isAlive(i) && getMindAttack(i) > strongest) {
+			strongest = getMindAttack(i);
+			attacker = i;
+		}
+	}
+	return attacker;
+}
+
+int Encounter::getMindAttack(size_t index) const {
+	return Bestiary::get(creatures[index]).mindAttack;
+}
+
+size_t Encounter::enemyTarget(size_t attacker) const {
+	return enemyTargetIn(hitPoints.data(), [this](size_t i) { return getSide(i); }, size(), attacker);
+}
+
+EncounterResult Encounter::simulate(const CombatStats& player, FastRng& rng, CombatStream* events) const {
+	const size_t count = size();
+
+	// One scratch buffer holds the hit points (a copy, so the encounter can be simulated
+	// repeatedly), the prototype stats gathered once, and the rolls of a round
+	enum Column { HP, ATTACK, DEFENSE, SIDE, HIT_ROLL, DAMAGE_ROLL, COLUMNS };
+	std::vector<int> scratch(count * COLUMNS);
+	int* hp = scratch.data() + HP * count;
+	int* attack = scratch.data() + ATTACK * count;
+	int* defense = scratch.data() + DEFENSE * count;
+	int* sides = scratch.data() + SIDE * count;
+	int* hitRolls = scratch.data() + HIT_ROLL * count;
+	int* damageRolls = scratch.data() + DAMAGE_ROLL * count;
+	for (size_t i = 0; i < count; ++i) {
+		const Creature& creature = Bestiary::get(creatures[i]);
+		hp[i] = hitPoints[i];
+		attack[i] = creature.attack;
+		defense[i] = creature.defense;
+		sides[i] = static_cast<int>(creature.side);
+	}
+	auto sideOf = [sides](size_t i) { return static_cast<Side>(sides[i]); };
+	const CombatDice& rules = dice();
+	int playerHitPoints = player.hitPoints;
+	int rounds = 0;
+
+	while (playerHitPoints > 0 && countLivingIn(hp, sideOf, count, Side::ENEMY) > 0) {
+		rounds++;
+
+		// Player's turn
+		size_t target = weakestEnemyIn(hp, sideOf, count);
+		int roll = rules.playerHit.roll(rng);
+		if (rules.playerHit.succeeds(roll)) {
+			int playerAttack = player.attack + (rounds <= player.openingRounds ? player.openingBonus : 0);
+			int damage = applyDamage(hp[target], rules.playerDamage.roll(rng, { playerAttack }), defense[target]);
+			if (events) events->attack(CombatEvent::PLAYER, CombatStream::actorOf(target), roll, true, damage, hp[target]);
+		}
+		else if (events) {
+			events->attack(CombatEvent::PLAYER, CombatStream::actorOf(target), roll, false);
+		}
+
+		// Every combatant rolls for the round up front; both sides roll the same D20 and only test it differently
+		rules.playerHit.rollBatch(rng, std::span<int>(hitRolls, count));
+		for (size_t i = 0; i < count; ++i) {
+			damageRolls[i] = (sideOf(i) == Side::ALLY ? rules.playerDamage : rules.enemyDamage).roll(rng, { attack[i] });
+		}
+
+		// Allies' turn
+		for (size_t i = 0; i < count; ++i) {
+			if (sideOf(i) != Side::ALLY || hp[i] <= 0) continue;
+			bool hit = rules.playerHit.succeeds(hitRolls[i]);
+			if (!hit && !events) continue;
+			target = weakestEnemyIn(hp, sideOf, count);
+			if (target == count) break;
+			int damage = hit ? applyDamage(hp[target], damageRolls[i], defense[target]) : 0;
+			if (events) events->attack(CombatStream::actorOf(i), CombatStream::actorOf(target), hitRolls[i], hit, damage, hp[target]);
+		}
+
+		// Enemies' turn
+		for (size_t i = 0; i < count && playerHitPoints > 0; ++i) {
+			if (sideOf(i) != Side::ENEMY || hp[i] <= 0) continue;
+			bool hit = rules.enemyHit.succeeds(hitRolls[i]);
+			if (!hit && !events) continue;
+			target = enemyTargetIn(hp, sideOf, count, i);
+			int& targetHitPoints = target == count ? playerHitPoints : hp[target];
+			int damage = hit ? applyDamage(targetHitPoints, damageRolls[i], target == count ? player.defense : defense[target]) : 0;
+			if (events) {
+				events->attack(CombatStream::actorOf(i), target == count ? CombatEvent::PLAYER : CombatStream::actorOf(target),
+					hitRolls[i], hit, damage, targetHitPoints);
+			}
+		}
+	}
+
+	if (events) events->end(playerHitPoints > 0);
+	return EncounterResult{ playerHitPoints > 0, rounds, playerHitPoints };
+}
\ No newline at end of file
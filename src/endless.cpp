@@ -0,0 +1,178 @@
+#include "endless.h"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <climits>
+#include <string_view>
+#include "bestiary.h"
+#include "utility.h"
+
+namespace {
+
+constexpr int ENCOUNTER_CHANCE = 45;   // Percent of scenes with enemies
+constexpr int LOOT_CHANCE = 30;        // Percent of scenes with an item
+constexpr int ROLL_CHECK_CHANCE = 25;  // Percent of choices that need a roll
+constexpr int MAX_GROUP = 3;           // Most enemies in one scene
+constexpr int LAST_DEPTH = (INT_MAX - EndlessRealm::FIRST_SCENE) / EndlessRealm::LANES - 1;
+
+constexpr std::array<std::string_view, 8> TERRAIN = {
+	"The path winds through a forest of grey, leafless trees.",
+	"You cross a marsh where the ground sucks at your boots.",
+	"A windswept ridge opens before you, bare but for heather and stone.",
+	"The trail descends into a narrow gorge loud with rushing water.",
+	"You walk among the ruins of a village long abandoned.",
+	"Rolling hills stretch away under a low and heavy sky.",
+	"A road of broken flagstones leads through a silent pine wood.",
+	"You reach the shore of a black lake, still as glass."
+};
+
+constexpr std::array<std::string_view, 8> FEATURE = {
+	"An old watchtower leans against the wind nearby.",
+	"Fresh tracks cross your path, too large to be a man's.",
+	"A cold campfire smoulders beside a toppled cart.",
+	"Crows watch you from the branches without a sound.",
+	"A shrine to a forgotten god stands half buried in moss.",
+	"The bones of some great beast lie bleaching in the open.",
+	"Smoke rises from somewhere beyond the next rise.",
+	"A rope bridge sways over a chasm to your left."
+};
+
+constexpr std::array<std::string_view, 8> OMEN = {
+	"You feel you are being watched.",
+	"The wind carries the distant sound of drums.",
+	"For a moment the land is quiet and you catch your breath.",
+	"A chill runs through you that has nothing to do with the cold.",
+	"Somewhere ahead, steel rings against steel.",
+	"The light is fading and you must choose your way quickly.",
+	"You recall the words of the Kai masters and steady your nerve.",
+	"Strange lights flicker on the horizon."
+};
+
+constexpr std::array<std::string_view, 12> PATHS = {
+	"Follow the old road",
+	"Climb towards the high ground",
+	"Wade across the stream",
+	"Take the hunters' trail",
+	"Cut through the thicket",
+	"Head for the smoke",
+	"Keep to the shadows of the valley",
+	"Cross the rope bridge",
+	"Search the ruins for another way",
+	"Follow the tracks",
+	"Skirt the edge of the lake",
+	"Make for the watchtower"
+};
+
+constexpr std::array<std::string_view, 6> ITEM_MAKERS = {
+	"Rusted", "Tarnished", "Old Kai", "Sommlending", "Durenor", "Runed"
+};
+
+constexpr std::array<std::string_view, 3> ITEM_NAMES = {
+	"Sword", "Mail", "Draught"
+};
+
+size_t pick(FastRng& rng, size_t count) {
+	return static_cast<size_t>(rng.roll(static_cast<int>(count)) - 1);
+}
+
+bool chance(FastRng& rng, int percent) {
+	return rng.roll(100) <= percent;
+}
+
+void appendNumber(std::string& out, int value) {
+	char buffer[16];
+	out.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), value).ptr);
+}
+
+} // namespace
+
+EndlessRealm::EndlessRealm(uint64_t seed, const Story& story) : seed(seed) {
+	for (int number : story.sceneNumbers()) {
+		for (const CombatantDef& combatant : story.find(number)->combatants) {
+			if (Bestiary::get(combatant.creature).side == Side::ENEMY &&
+				std::find(pool.begin(), pool.end(), combatant.creature) == pool.end()) {
+				pool.push_back(combatant.creature);
+			}
+		}
+	}
+	scaled.assign(pool.size() * (MAX_TIER + 1), Bestiary::NONE);
+}
+
+bool EndlessRealm::contains(int number) {
+	return number >= FIRST_SCENE;
+}
+
+int EndlessRealm::depthOf(int number) {
+	return (number - FIRST_SCENE) / LANES;
+}
+
+int EndlessRealm::sceneAt(int depth, int lane) {
+	return depth <= LAST_DEPTH ? FIRST_SCENE + depth * LANES + lane : 0;
+}
+
+CreatureID EndlessRealm::scaledEnemy(size_t index, int tier) {
+	CreatureID& id = scaled[static_cast<size_t>(tier) * pool.size() + index];
+	if (id == Bestiary::NONE) {
+		const Creature& base = Bestiary::get(pool[index]);
+		id = Bestiary::define(base.name, base.hitPoints + base.hitPoints * tier / 4,
+			base.attack + tier / 2, base.defense + tier / 3, Side::ENEMY, base.mindAttack);
+		if (id == Bestiary::NONE) {
+			id = pool[index];
+		}
+	}
+	return id;
+}
+
+void EndlessRealm::generate(int number, SceneDef& def) {
+	int depth = depthOf(number);
+	int tier = std::min(depth / TIER_DEPTH, MAX_TIER);
+	FastRng rng(seed ^ (static_cast<uint64_t>(number) * 0xD1B54A32D192ED03ULL));
+
+	def.number = number;
+	def.name.clear();
+	def.combatants.clear();
+
+	def.description.assign("League ");
+	appendNumber(def.description, depth + 1);
+	def.description += " beyond the journey's end.\n";
+	def.description += TERRAIN[pick(rng, TERRAIN.size())];
+	def.description += ' ';
+	def.description += FEATURE[pick(rng, FEATURE.size())];
+	def.description += '\n';
+	def.description += OMEN[pick(rng, OMEN.size())];
+
+	// The first scene is a quiet start into the lands
+	if (depth > 0 && !pool.empty() && chance(rng, ENCOUNTER_CHANCE)) {
+		int groupSize = std::min(rng.roll(1 + depth / (2 * TIER_DEPTH)), MAX_GROUP);
+		def.combatants.push_back({ scaledEnemy(pick(rng, pool.size()), tier), groupSize });
+	}
+
+	def.loot.resize(chance(rng, LOOT_CHANCE) ? 1 : 0);
+	if (!def.loot.empty()) {
+		auto kind = static_cast<ItemKind>(pick(rng, ITEM_NAMES.size()));
+		LootDef& item = def.loot.front();
+		item.kind = kind;
+		item.name.assign(ITEM_MAKERS[pick(rng, ITEM_MAKERS.size())]);
+		item.name += ' ';
+		item.name += ITEM_NAMES[static_cast<size_t>(kind)];
+		item.bonus = kind == ItemKind::POTION ? 5 + 2 * tier : 1 + tier + rng.roll(3) - 1;
+	}
+
+	// Two or three ways on, each to a different lane of the next depth; none where scene numbers run out
+	int ways = sceneAt(depth + 1, 0) != 0 ? 1 + rng.roll(LANES - 1) : 0;
+	int firstLane = rng.roll(LANES) - 1;
+	size_t firstPath = pick(rng, PATHS.size());
+	// Resizing keeps the label buffers of the previous scene
+	def.choices.resize(static_cast<size_t>(ways));
+	for (int i = 0; i < ways; ++i) {
+		ChoiceDef& choice = def.choices[static_cast<size_t>(i)];
+		choice.label.assign(PATHS[(firstPath + static_cast<size_t>(i) * 5) % PATHS.size()]);
+		choice.next = sceneAt(depth + 1, (firstLane + i) % LANES);
+		choice.minRoll = 0;
+		choice.fail = 0;
+		if (chance(rng, ROLL_CHECK_CHANCE)) {
+			choice.minRoll = 6 + rng.roll(8);
+			choice.fail = sceneAt(depth + 1, (firstLane + i + 1) % LANES);
+		}
+	}
+}
\ No newline at end of file
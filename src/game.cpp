@@ -1,6 +1,11 @@
 #include <iostream>
+#include <random>
+#include <chrono>
+#include <iomanip>
+#include <algorithm>
 #include <vector>
 #include <string>
+#include <optional>
 #include "game.h"
 #include "scene.h"
 #include "player.h"
@@ -9,10 +14,63 @@
 #include "potion.h"
 #include "utility.h"
 #include "sceneID.h"
+#include "telemetry.h"
+#include "trace.h"
+#include "encounter.h"
+#include "batchcombat.h"
+#include "story.h"
+#include "storyfile.h"
+#include "localization.h"
+#include "console.h"
+#include "journal.h"
+#include "gamestate.h"
+#include "endless.h"
+#include "modifier.h"
+#include "combatlog.h"
+#include "runstore.h"
+#include "leaderboard.h"
 
 constexpr int PLAYER_HP = 30;
 constexpr int PLAYER_ATK = 5;
 constexpr int PLAYER_DEF = 2;
+constexpr int STARTER_WEAPON_ATK = 2;
+constexpr int STARTER_ARMOR_DEF = 1;
+constexpr int STARTER_POTION_HEAL = 5;
+constexpr int FIGHT_SAMPLES = 3;   // Sampled outcomes per fight when exploring branches
+constexpr size_t LEADERBOARD_SHOWN = 5;   // Entries shown of every leaderboard after a ranked run
+constexpr int ENDLESS_KEEP_BEHIND = 4;   // Depths of generated scenes kept behind the player
+constexpr const char* ENDLESS_GATE_CHOICE = "Set out once more into the unknown lands beyond";
+
+namespace {
+
+void addLoot(Scene& scene, const SceneDef& def) {
+	for (const LootDef& item : def.loot) {
+		switch (item.kind) {
+		case ItemKind::WEAPON:
+			scene.addNewWeapon(item.name, item.bonus);
+			break;
+		case ItemKind::ARMOR:
+			scene.addNewArmor(item.name, item.bonus);
+			break;
+		case ItemKind::POTION:
+			scene.addPotionLoot(item.name, item.bonus);
+			break;
+		}
+	}
+}
+
+/**
+ * @brief Attack penalty the mind attack of a fight puts on a character with these skills
+ */
+int mindAttackPenalty(const Encounter& encounter, uint32_t skills) {
+	size_t attacker = encounter.mindAttacker();
+	if (attacker == encounter.size() || (skills & skillBit(Skill::MINDSHIELD))) {
+		return 0;
+	}
+	return encounter.getMindAttack(attacker);
+}
+
+} // namespace
 
 Game::Game() = default;
 
@@ -24,346 +82,1067 @@ Game::~Game() {
 	delete player;
 }
 
-Scene* Game::createScene(SceneID id, const std::string& description) {
+Scene* Game::createScene(int id, const std::string& description) {
 	auto* scene = new Scene(id, description);
 	scenes[id] = scene;
 	return scene;
 }
 
-Scene* Game::getScene(SceneID id) {
+Scene* Game::getScene(int id) {
 	auto it = scenes.find(id);
-	return (it != scenes.end()) ? it->second : nullptr;
+	if (it != scenes.end()) {
+		return it->second;
+	}
+	const SceneDef* def = findDef(id);
+	return def ? buildScene(*def) : nullptr;
+}
+
+bool Game::keepsScene(int id) const {
+	return !endlessMode || !EndlessRealm::contains(id);
+}
+
+const SceneDef* Game::findDef(int id) {
+	if (endlessMode && EndlessRealm::contains(id)) {
+		// The realm takes its enemies from the story, so it waits until the story is known
+		if (!endless) {
+			endless = std::make_unique<EndlessRealm>(endlessSeed, *story);
+		}
+		endless->generate(id, generated);
+		return &generated;
+	}
+	return story ? story->find(id) : nullptr;
+}
+
+void Game::evictBehind() {
+	if (!endless || !currentScene || !EndlessRealm::contains(currentScene->getSceneNumber())) {
+		return;
+	}
+	int keptDepth = EndlessRealm::depthOf(currentScene->getSceneNumber()) - ENDLESS_KEEP_BEHIND;
+	if (keptDepth <= 0) {
+		return;
+	}
+	// Generated scenes are ordered by depth, so those behind form one range of the map
+	int firstKept = EndlessRealm::sceneAt(keptDepth, 0);
+	auto first = scenes.lower_bound(EndlessRealm::FIRST_SCENE);
+	auto last = scenes.lower_bound(firstKept);
+	if (first == last) {
+		return;
+	}
+	for (auto it = first; it != last; ++it) {
+		delete it->second;
+	}
+	scenes.erase(first, last);
+
+	if (journalSession) {
+		journalSession->recordForget(EndlessRealm::FIRST_SCENE, firstKept);
+	}
+	if (!history.empty()) {
+		history.back().clearSceneStates(EndlessRealm::FIRST_SCENE, firstKept);
+	}
+}
+
+Scene* Game::buildScene(const SceneDef& def) {
+	Scene* scene = createScene(def.number, def.description);
+	for (const CombatantDef& combatant : def.combatants) {
+		scene->addCombatants(combatant.creature, combatant.count);
+	}
+	addLoot(*scene, def);
+
+	// Scenes the choices lead to are built when a choice is first followed
+	for (const ChoiceDef& choice : def.choices) {
+		scene->addChoice(choice.label, SceneRef(choice.next, this), choice.minRoll,
+			choice.fail > 0 ? SceneRef(choice.fail, this) : SceneRef());
+	}
+	if (endlessMode && def.number == endlessGate) {
+		scene->addChoice(ENDLESS_GATE_CHOICE, SceneRef(EndlessRealm::FIRST_SCENE, this));
+	}
+	return scene;
 }
 
-void Game::setStartScene(SceneID id) {
+void Game::setStartScene(int id) {
 	currentScene = getScene(id);
 }
 
+void Game::applyStory(std::shared_ptr<const Story> newStory) {
+	story = std::move(newStory);
+
+	// Only the start scene is built now; the rest follow as the player reaches them
+	if (!currentScene) {
+		setStartScene(story->getStartScene());
+	}
+}
+
+void Game::setStorySource(StoryFile* source) {
+	storySource = source;
+	applyStory(source->current());
+}
+
+const Story* Game::getStory() const {
+	return story.get();
+}
+
+void Game::refreshStory() {
+	if (!storySource || !currentScene) {
+		return;
+	}
+	std::shared_ptr<const Story> latest = storySource->current();
+	int currentNumber = currentScene->getSceneNumber();
+
+	// Keep playing the old version until the player stands in a scene that still exists
+	if (latest == story || !latest->find(currentNumber)) {
+		return;
+	}
+
+	std::shared_ptr<const Story> previousStory = story;
+	std::map<int, Scene*> previousScenes = std::move(scenes);
+	scenes.clear();
+	currentScene = nullptr;
+	applyStory(latest);
+
+	// Scenes whose definition did not change keep their world state (enemy HP, loot taken)
+	for (auto& [number, scene] : previousScenes) {
+		if (latest->findShared(number) && previousStory->findShared(number) == latest->findShared(number)) {
+			getScene(number)->takeStateFrom(*scene);
+		}
+	}
+	for (auto& [number, scene] : previousScenes) {
+		delete scene;
+	}
+	currentScene = getScene(currentNumber);
+}
+
+void Game::setJournal(Journal* target) {
+	journal = target;
+}
+
+void Game::setRewindLimit(size_t turns) {
+	rewindLimit = turns;
+	while (history.size() > rewindLimit + 1) {
+		history.pop_front();
+	}
+}
+
+void Game::setEndless(uint64_t seed) {
+	endlessSeed = seed;
+	endlessMode = true;
+	endless.reset();
+}
+
+void Game::resumePlayer(const SavedGame& saved) {
+	player = new Player(saved.name, saved.player.maxHitPoints, saved.player.attack, saved.player.defense);
+	player->restore(saved.player);
+	player->setJournal(journalSession.get());
+
+	for (const auto& [number, state] : saved.world) {
+		if (Scene* scene = getScene(number)) {
+			scene->restoreState(state);
+		}
+	}
+	if (Scene* scene = getScene(saved.scene)) {
+		currentScene = scene;
+	}
+}
+
+GameState Game::captureState() const {
+	GameState state;
+	if (currentScene) {
+		state.setScene(currentScene->getSceneNumber());
+	}
+	if (player) {
+		player->captureState(state.editPlayer());
+	}
+	// Scenes still as defined are left out and read back as untouched
+	SceneState sceneState;
+	for (const auto& [number, scene] : scenes) {
+		if (scene->captureState(sceneState)) {
+			state.setSceneState(number, std::move(sceneState));
+		}
+	}
+	return state;
+}
+
+void Game::restoreState(const GameState& state) {
+	if (player && !player->matchesState(state.getPlayer())) {
+		player->restore(state.getPlayer());
+	}
+	// Built scenes go back to the state, and scenes changed in the state are built first
+	for (auto& [number, scene] : scenes) {
+		restoreScene(*scene, state.getSceneState(number));
+	}
+	GameState().forEachChangedScene(state, [&](int number) {
+		if (!scenes.count(number)) {
+			if (Scene* scene = getScene(number)) {
+				restoreScene(*scene, state.getSceneState(number));
+			}
+		}
+	});
+	if (Scene* scene = getScene(state.getScene())) {
+		currentScene = scene;
+	}
+}
+
+void Game::restoreScene(Scene& scene, const SceneState& state) {
+	// Going back to before the loot was taken puts it back
+	if (scene.isLooted() && !state.looted) {
+		if (const SceneDef* def = findDef(scene.getSceneNumber())) {
+			addLoot(scene, *def);
+		}
+	}
+	scene.restoreState(state);
+}
+
+void Game::recordTurn(int playedScene) {
+	if (history.empty()) {
+		history.push_back(captureState());
+		return;
+	}
+
+	GameState state = history.back();
+	state.setScene(currentScene->getSceneNumber());
+	if (!player->matchesState(state.getPlayer())) {
+		player->captureState(state.editPlayer());
+	}
+	// Turns only change the world of the scene they are played in
+	if (Scene* scene = getScene(playedScene)) {
+		SceneState sceneState;
+		scene->captureState(sceneState);
+		if (!(sceneState == state.getSceneState(playedScene))) {
+			state.setSceneState(playedScene, std::move(sceneState));
+		}
+	}
+	history.push_back(std::move(state));
+	// One entry more than the limit: rewinding N turns returns to the start of the Nth last turn
+	if (history.size() > rewindLimit + 1) {
+		history.pop_front();
+	}
+}
+
+void Game::rewindTo(size_t index, int playedScene) {
+	const GameState& target = history[index];
+
+	// The live world differs from the latest entry only in the scene played since
+	std::vector<int> changed;
+	target.forEachChangedScene(history.back(), [&](int number) {
+		changed.push_back(number);
+	});
+	changed.push_back(playedScene);
+	for (int number : changed) {
+		if (Scene* scene = getScene(number)) {
+			restoreScene(*scene, target.getSceneState(number));
+		}
+	}
+	if (!player->matchesState(target.getPlayer())) {
+		player->restore(target.getPlayer());
+	}
+	if (Scene* scene = getScene(target.getScene())) {
+		currentScene = scene;
+	}
+
+	if (journalSession) {
+		SavedGame saved;
+		saved.scene = target.getScene();
+		saved.player = target.getPlayer();
+		GameState().forEachChangedScene(target, [&](int number) {
+			saved.world[number] = target.getSceneState(number);
+		});
+		journalSession->recordRestore(saved);
+	}
+	history.erase(history.begin() + static_cast<std::ptrdiff_t>(index) + 1, history.end());
+}
+
+bool Game::offerRewind(int playedScene) {
+	if (rewindLimit == 0 || history.empty()) {
+		return false;
+	}
+	// Replaying an ending scene changes nothing, so count from the turn that led there
+	Scene* played = getScene(playedScene);
+	size_t skip = player->isAlive() && played && played->isEnding() ? 1 : 0;
+	size_t available = history.size() - skip;
+	if (available == 0) {
+		return false;
+	}
+
+	Console::out() << tr(StringID::REWIND_PROMPT, available);
+	size_t turns;
+	validateInput(turns, available);
+	if (turns == 0) {
+		return false;
+	}
+	rewindTo(available - turns, playedScene);
+	Console::out() << tr(StringID::TURNS_REWOUND, turns);
+	return true;
+}
+
 void Game::createPlayer(const std::string& name) {
 	player = new Player(name, PLAYER_HP, PLAYER_ATK, PLAYER_DEF);
+	player->setJournal(journalSession.get());
 
 	// Give player starting equipment
-	auto* woodenSword = new Weapon("Wooden Sword", 2);
-	auto* leatherArmor = new Armor("Leather Armor", 1);
-	auto* healingPotion = new Potion("Healing Potion", 5);
-
-	player->addWeapon(woodenSword);
-	player->addArmor(leatherArmor);
-	player->addPotion(healingPotion);
+	size_t woodenSword = player->addWeapon(Weapon(std::string(tr(StringID::STARTER_WEAPON)), STARTER_WEAPON_ATK));
+	size_t leatherArmor = player->addArmor(Armor(std::string(tr(StringID::STARTER_ARMOR)), STARTER_ARMOR_DEF));
+	player->addPotion(Potion(std::string(tr(StringID::STARTER_POTION)), STARTER_POTION_HEAL));
 	player->equipWeapon(woodenSword);
 	player->equipArmor(leatherArmor);
+
+	// Every Kai initiate has mastered one discipline
+	Console::out() << tr(StringID::SKILL_MENU, WEAPONSKILL_BONUS, MINDBLAST_BONUS, MINDBLAST_ROUNDS);
+	size_t skill;
+	validateInput(skill, static_cast<size_t>(Skill::COUNT));
+	if (skill > 0) {
+		player->learnSkill(static_cast<Skill>(skill - 1));
+	}
 }
 
-void Game::setStoryline() {
-	createScene(START,
+namespace {
+
+/**
+ * @brief Defines the built-in storyline
+ */
+std::shared_ptr<const Story> buildStoryline() {
+	StoryBuilder story;
+
+	story.createScene(START,
 		""
 		"You must make haste for you sense it is not safe to linger by the smoking remains of the ruined monastery.\n"
 		"At the foot of the hill, the path splits into two directions, both leading into a large wood.");
 
-	createScene(WIDEPATH,
+	story.createScene(WIDEPATH,
 		"The path is wide and leads straight into thick undergrowth. The trees are tall here and unusually quiet.\n"
 		"You walk for over a mile when suddenly you hear the beating of large wings directly above you.\n"
 		"Looking up, you are shocked to see the sinister black outline of a Kraan diving to attack you.");
 
-	createScene(FIGHT_KRAAN,
+	story.createScene(FIGHT_KRAAN,
 		"The Kraan hovers above you, raising dust with the beat of its huge black wings.\n"
 		"The dust gets into your eyes and nose, and you start to cough. Now the beast attacks.");
-	getScene(FIGHT_KRAAN)->setEnemy("Kraan", 20, 6, 2);
-	getScene(FIGHT_KRAAN)->addNewWeapon("Dagger", 3);
+	story.scene(FIGHT_KRAAN).addEnemy("Kraan", 20, 6, 2);
+	story.scene(FIGHT_KRAAN).addNewWeapon("Dagger", 3);
 
-	createScene(CLEARING,
+	story.createScene(CLEARING,
 		"You continue eastwards along the path. The path opens out into a large clearing.\n"
 		"You notice strange claw prints in the earth. Kraan have landed here. By the number of prints and by the\n"
 		"size of the area disturbed, you judge that at least five of the foul creatures landed here recently.\n\n"
 		"You see two exits on the far side of the clearing. One leads west, the other south.");
 
-	createScene(FALLENTREE,
+	story.createScene(FALLENTREE,
 		"You walk along this path for over an hour, carefully watching the sky above you in case the Kraan attack\n"
 		"again. Up ahead, a large tree has fallen across the path. As you approach, you can hear voices coming\n"
 		"from the other side of the massive trunk.");
 
-	createScene(KAKARMI,
+	story.createScene(KAKARMI,
 		"Leaping from the top of the trunk, you land in front of two small furry creatures. You recognize that\n"
 		"they are Kakarmi, an intelligent race of animals that inhabit and tend the forests of Sommerlund. Before\n"
 		"you can apologize for your dramatic entrance, the frightened little creatures scurry off into the forest.");
 
-	createScene(STREAM,
+	story.createScene(STREAM,
 		"The Kakarmi disappear into the dense undergrowth and you soon find yourself lost. After nearly two \n"
 		"hours of walking you hear the sound of running water. You decide to investigate a little closer.\n"
 		"Eventually you come to the edge of a fast-flowing icy stream. You follow the stream as it makes its way\n"
 		"towards the east. Suddenly you notice something in the distance that brings you to a halt. You can see\n"
 		"on the track above four soldiers and their officer. They wear the uniform of the King's army.");
 
-	createScene(CONTINUE_FOREST,
+	story.createScene(CONTINUE_FOREST,
 		"You decide not to follow the Kakarmi and continue your journey through the forest.\n"
 		"The path becomes narrower and more overgrown, making progress difficult.\n"
 		"After an hour of hacking through thorny bushes, you emerge into a small glade.");
 
-	createScene(CAMOUFLAGE,
+	story.createScene(CAMOUFLAGE,
 		"You quickly gather branches and leaves to camouflage yourself and wait for the soldiers to pass.\n"
 		"They march directly past your hiding spot, unaware of your presence.\n"
 		"As they pass, you overhear them discussing troop movements and a planned ambush.\n"
 		"After they've gone, you consider your next move.");
 
-	createScene(APPROACH,
+	story.createScene(APPROACH,
 		"As you get nearer to the men, you call to them. As they turn to face you, your skin turns cold and your\n"
 		"heart pounds, for they are Drakkarim in disguise. Suddenly they charge at you. Forced to the ground, you\n"
 		"are tied up with ropes and dragged behind them along a track. They take all of your items. They cackle\n"
 		"menacingly to themselves, and talk at great length of the tortures that await you at their camp.");
 
-	createScene(MARCHING,
+	story.createScene(MARCHING,
 		"After an hour of marching, the Drakkarim suddenly halt as a large, grey scaly creature approaches along the\n"
 		"track. As the beast draws closer, you can smell its fetid breath on your face. It lets out a roar and grabs\n"
 		"your head in its powerful webbed hands. The last thing you hear is the sharp crack of your spine snapping.\n"
 		"Game over.");
 
-	createScene(BATTLE,
+	story.createScene(BATTLE,
 		"As you journey ahead, you can see a fierce battle raging across a stone bridge. The clash of steel and the cries\n"
 		"of men and beasts echo through the forest. In the midst of the fighting, you see Prince Pelathar, the King's son.\n"
 		"He is in combat with a large grey Gourgaz who is wielding a black axe above his scaly head.\n\n"
 		"You picked up the Prince's sword and may use it.");
-	getScene(BATTLE)->addNewWeapon("Prince's Sword", 5);
+	story.scene(BATTLE).addNewWeapon("Prince's Sword", 5);
 
-	createScene(FIGHT_GOURGAZ,
+	story.createScene(FIGHT_GOURGAZ,
 		"You rush to aid the Prince. The creature that you now face is a Gourgaz, one of a race of cold-blooded reptilian\n"
 		"creatures that dwell deep in the treacherous Maakenmire swamps. Their favourite food is human flesh!");
-	getScene(FIGHT_GOURGAZ)->setEnemy("Gourgaz", 30, 8, 3);
+	story.scene(FIGHT_GOURGAZ).addEnemy("Gourgaz", 30, 8, 3);
+	story.scene(FIGHT_GOURGAZ).addEnemy("Giak Follower", 8, 4, 1, 3);
+	story.scene(FIGHT_GOURGAZ).addAlly("Prince Pelathar", 25, 6, 3);
+	story.scene(FIGHT_GOURGAZ).addAlly("King's Soldier", 12, 4, 2);
 
-	createScene(DEFEND_PRINCE,
+	story.createScene(DEFEND_PRINCE,
 		"The giant Gourgaz lies dead at your feet. His evil followers hiss at you and then fall back from the bridge.\n"
 		"The Prince's soldiers killed off the remaining enemies and surrounded the Prince with their shields.\n"
 		"The battle is over. The prince thanked you and offers to take you into the town.");
 
-	createScene(TOWN_END,
+	story.createScene(TOWN_END,
 		"As you follow the entourage of the Prince into the town, you finally have a sense of safety inside the walls.\n"
 		"But something feels amiss and you do not know what the future brings you.\n"
 		"Perhaps one day you will complete your journey, but for now you retire into the inn.");
 
-	createScene(FLEE_BATTLE,
+	story.createScene(FLEE_BATTLE,
 		"You turn and flee from the battle, disappearing into the dense forest.\n"
 		"The sounds of combat fade behind you as you push deeper into the woods.\n"
 		"Eventually, you find a small cave in which to rest and gather your thoughts.");
 
-	createScene(CONTINUE_BATTLE,
+	story.createScene(CONTINUE_BATTLE,
 		"You decide to avoid the fighting and change direction, heading deeper into the forest.\n"
 		"The sounds of battle fade as you make your way through the thick undergrowth.\n"
 		"After several hours of walking, you find yourself on the edge of a clearing.");
 
-	createScene(WALK_AWAY,
+	story.createScene(WALK_AWAY,
 		"You politely decline the Prince's offer and decide to continue your journey alone.\n"
 		"With a respectful bow, you turn and head back into the forest, seeking your own path.");
 
-	createScene(UNDERGROWTH,
+	story.createScene(UNDERGROWTH,
 		"The path is wide and leads straight into thick undergrowth. The trees are tall here and unusually quiet.\n"
 		"You walk for over a mile when suddenly you hear the beating of large wings directly above you.\n"
 		"Looking up, you are shocked to see the sinister black outline of a Kraan diving to attack you.");
 
-	createScene(FOGWOOD,
+	story.createScene(FOGWOOD,
 		"You move quickly along the track. You recall that this route leads to Fogwood, a small cluster of huts\n"
 		"that have been used by a family of charcoal burners for nearly fifty years. After twenty minutes you\n"
 		"reach the edge of a clearing where the huts are grouped in a small circle. There is no sign of the\n"
 		"usual mist of wood smoke which gives Fogwood its  name, and the huts are unusually quiet.");
 
-	createScene(TRACK_PERIMETER,
+	story.createScene(TRACK_PERIMETER,
 		"You detect Giak tracks around the perimeter of the clearing. The prints are fresh and you can tell that\n"
 		"these cruel minions of the Darklords were in this area less than two hours ago.");
 
-	createScene(INVESTIGATE_HUTS,
+	story.createScene(INVESTIGATE_HUTS,
 		"Through the open doorway of the first hut, you can see the body of a charcoal burner lying\n"
 		"face down on the rough stone floor. He has been murdered, stabbed in the back by a spear. All his\n"
 		"furniture and belongings have been smashed and broken and not one piece remains intact.\n"
 		"This is the evil handiwork of Giaks without any doubt, for they delight in the destruction of all things.\n"
 		"You search the hut and discovered a Giak Spear, proof of your suspicions. You continue along the track.\n"
 		"In the distance, perched on the branch of an old oak tree is a jet-black raven.");
-	getScene(INVESTIGATE_HUTS)->addNewWeapon("Giak Spear", 4);
+	story.scene(INVESTIGATE_HUTS).addNewWeapon("Giak Spear", 4);
 
-	createScene(FIGHT_GIAK,
+	story.createScene(FIGHT_GIAK,
 		"The Kraan and its riders land on the track barely ten feet from where you are hidden.A Giak leap\n"
 		"from the scaly backs of the Kraan and move towards you, its spears raised to strike. You have been seen.");
-	getScene(FIGHT_GIAK)->setEnemy("Giak", 10, 13, 4);
+	story.scene(FIGHT_GIAK).addEnemy("Giak", 10, 13, 4);
 
-	createScene(CALL_BIRD,
+	story.createScene(CALL_BIRD,
 		"The head of the bird slowly turns and it curses you. An instant later, it flies off above the trees and has\n"
 		"soon disappeared. Shocked by what you have heard you are now sure that the fledgling was a scout of the\n"
 		"Darklords and is now probably on its way to inform them of your whereabouts.");
 
-	createScene(CONTINUE_TRACK,
+	story.createScene(CONTINUE_TRACK,
 		"After a few minutes walking you see a stranger, clad in red, standing in the centre of the track ahead.\n"
 		"He has his back towards you, and his head is covered by the hood of his robes. Perched on his\n"
 		"outstretched arm is the black raven that you saw earlier.");
 
-	createScene(LEAVE_TRACK,
+	story.createScene(LEAVE_TRACK,
 		"For half an hour or more you press on through the forest, through the rich vegetation and ferns.\n"
 		"You happen upon a small clear stream where you stop for a few minutes to wash your face and drink\n"
 		"of the cold, fresh water .Feeling revitalized, you cross the stream and press on. You soon notice\n"
 		"the smell of wood smoke which seems to be drifting towards you from the north.");
 
-	createScene(CONFRONT_STRANGER,
+	story.createScene(CONFRONT_STRANGER,
 		"As your voice echoes through the trees, the stranger slowly turns to face you.\n"
 		"Your heart pounds and your blood freezes as you realize that the stranger is not human. It is a Vordak,\n"
 		"a hideous lieutenant of the Darklords and one of the undead. A piercing scream fills your ears, and\n"
 		"the creature raises a huge black mace above its head and charges at you. Frozen with horror, you can\n"
 		"also feel the Vordak attacking you with the force of its mind.");
-	getScene(CONFRONT_STRANGER)->setEnemy("Vordak", 25, 7, 3);
-	getScene(CONFRONT_STRANGER)->addNewArmor("Mage Armor", 4);
+	story.scene(CONFRONT_STRANGER).addEnemy("Vordak", 25, 7, 3, 1, 2);
+	story.scene(CONFRONT_STRANGER).addNewArmor("Mage Armor", 4);
 
-	createScene(KILLED_MAGE,
+	story.createScene(KILLED_MAGE,
 		"As the mage collapse, you can finally catch a breath. The raven has flown away and you are left with a corpse.\n"
 		"You searched him and found a gem.");
-	createScene(TAKE_MAGE_GEM,
+	story.createScene(TAKE_MAGE_GEM,
 		"As you picked up the gem, you hands burns through your bones and you felt excruciating pain.\n"
 		"As you see yourself burn through the cursed gem, nothing mattered.\n"
 		" Game Over! You died.");
 
-	createScene(RUN_FROM_GIAKS,
+	story.createScene(RUN_FROM_GIAKS,
 		"You have been trudging through the forest for nearly four hours. As you escaped out of the forest,\n"
 		"over a distance, you see a group of people with horse carriage.");
 
-	createScene(APPROACH_MERCHANTS,
+	story.createScene(APPROACH_MERCHANTS,
 		"You found a merchant group heading to town. You asked to travel with them for the time being.\n"
 		"You reach the town, exhausted but alive.");
 
-	createScene(WALK_OPPOSITE,
+	story.createScene(WALK_OPPOSITE,
 		"As you kept walking, exhaustion overtook you and you collapse and died.\nGame over.");
 
-	createScene(AVOID_CLEARING,
+	story.createScene(AVOID_CLEARING,
 		"You decide to avoid the clearing, taking a detour through the dense forest instead.\n"
 		"The journey is difficult as you push through thick undergrowth, but you eventually find a small path.\n"
 		"After an hour of careful travel, you emerge from the forest near a rocky outcrop.");
 
-	createScene(FELL_DEATH,
+	story.createScene(FELL_DEATH,
 		"As you climb up the rocky outcrop, your feet slipped and you have fallen to your death. \nGame Over.");
 
-	createScene(IGNORE_BIRD,
+	story.createScene(IGNORE_BIRD,
 		"You ignore the raven and continue walking along the track. The bird watches you intently as you pass,\n"
 		"its beady eyes following your every move. After a while, you hear the flapping of wings and notice\n"
 		"the raven has taken flight, circling above you before heading off in the direction you came from.");
 
-	createScene(INVESTIGATE_SMOKE,
+	story.createScene(INVESTIGATE_SMOKE,
 		"You follow the scent of wood smoke through the trees. After about fifteen minutes, you come to a small\n"
 		"clearing where an old man sits beside a campfire. He looks up as you approach, seemingly unsurprised\n"
 		"by your presence. He introduces himself as a sage who has lived in these woods for many years.");
 
-	createScene(AVOID_SMOKE,
+	story.createScene(AVOID_SMOKE,
 		"Deciding not to risk investigating the source of the smoke, you change direction and head east.\n"
 		"The forest grows denser here, with tall trees blotting out much of the sunlight. You push on through\n"
 		"the growing darkness, hoping to find your way to safer lands.");
 
-	getScene(START)->addChoice("Take the right path into the wood", getScene(WIDEPATH));
-	getScene(START)->addChoice("Follow the left track", getScene(FOGWOOD));
+	story.scene(START).addChoice("Take the right path into the wood", WIDEPATH);
+	story.scene(START).addChoice("Follow the left track", FOGWOOD);
+
+	story.scene(WIDEPATH).addChoice("Draw your weapon and prepare to fight", FIGHT_KRAAN);
+	story.scene(WIDEPATH).addChoice("Evade the attack by running south, deeper into the forest", UNDERGROWTH);
+
+	story.scene(FIGHT_KRAAN).addChoice("Engage in combat", CLEARING);
+	story.scene(FIGHT_KRAAN).addChoice("Flee to the east path", FOGWOOD);
+
+	story.scene(CLEARING).addChoice("Take the south path", FALLENTREE);
+	story.scene(CLEARING).addChoice("Take the west path", AVOID_CLEARING);
 
-	getScene(WIDEPATH)->addChoice("Draw your weapon and prepare to fight", getScene(FIGHT_KRAAN));
-	getScene(WIDEPATH)->addChoice("Evade the attack by running south, deeper into the forest", getScene(UNDERGROWTH));
+	story.scene(FALLENTREE).addChoice("Try to attack", KAKARMI);
+	story.scene(FALLENTREE).addChoice("Listen to what the voices say", TRACK_PERIMETER);
 
-	getScene(FIGHT_KRAAN)->addChoice("Engage in combat", getScene(CLEARING));
-	getScene(FIGHT_KRAAN)->addChoice("Flee to the east path", getScene(FOGWOOD));
+	story.scene(KAKARMI).addChoice("Follow the Kakarmi creatures", STREAM);
+	story.scene(KAKARMI).addChoice("Continue your journey without following them", CONTINUE_FOREST);
 
-	getScene(CLEARING)->addChoice("Take the south path", getScene(FALLENTREE));
-	getScene(CLEARING)->addChoice("Take the west path", getScene(AVOID_CLEARING));
+	story.scene(STREAM).addChoice("Camouflage yourself and wait for the soldiers to pass", CAMOUFLAGE);
+	story.scene(STREAM).addChoice("Approach the soldiers", APPROACH);
 
-	getScene(FALLENTREE)->addChoice("Try to attack", getScene(KAKARMI));
-	getScene(FALLENTREE)->addChoice("Listen to what the voices say", getScene(TRACK_PERIMETER));
+	story.scene(APPROACH).addChoice("Attempt to escape (Success on roll of 10+)", BATTLE, 10, MARCHING);
+	story.scene(APPROACH).addChoice("Wait for something to happen", MARCHING);
 
-	getScene(KAKARMI)->addChoice("Follow the Kakarmi creatures", getScene(STREAM));
-	getScene(KAKARMI)->addChoice("Continue your journey without following them", getScene(CONTINUE_FOREST));
+	story.scene(BATTLE).addChoice("Defend the Prince", FIGHT_GOURGAZ);
+	story.scene(BATTLE).addChoice("Run into the forest", FLEE_BATTLE);
 
-	getScene(STREAM)->addChoice("Camouflage yourself and wait for the soldiers to pass", getScene(CAMOUFLAGE));
-	getScene(STREAM)->addChoice("Approach the soldiers", getScene(APPROACH));
+	story.scene(FIGHT_GOURGAZ).addChoice("Engage to battle", DEFEND_PRINCE);
 
-	getScene(APPROACH)->addChoice("Attempt to escape (Success on roll of 10+)", getScene(BATTLE), 10, getScene(MARCHING));
-	getScene(APPROACH)->addChoice("Wait for something to happen", getScene(MARCHING));
+	story.scene(DEFEND_PRINCE).addChoice("Follow the Prince to town", TOWN_END);
+	story.scene(DEFEND_PRINCE).addChoice("Politely reject and walk away", WALK_AWAY);
 
-	getScene(BATTLE)->addChoice("Defend the Prince", getScene(FIGHT_GOURGAZ));
-	getScene(BATTLE)->addChoice("Run into the forest", getScene(FLEE_BATTLE));
+	story.scene(FOGWOOD).addChoice("Track the perimeter", TRACK_PERIMETER);
+	story.scene(FOGWOOD).addChoice("Prepare your weapon and stealthily approach the huts", FIGHT_GIAK);
 
-	getScene(FIGHT_GOURGAZ)->addChoice("Engage to battle", getScene(DEFEND_PRINCE));
+	story.scene(FIGHT_GIAK).addChoice("Engage in battle", INVESTIGATE_HUTS);
+	story.scene(FIGHT_GIAK).addChoice("Run away", AVOID_CLEARING);
 
-	getScene(DEFEND_PRINCE)->addChoice("Follow the Prince to town", getScene(TOWN_END));
-	getScene(DEFEND_PRINCE)->addChoice("Politely reject and walk away", getScene(WALK_AWAY));
+	story.scene(TRACK_PERIMETER).addChoice("Forewarned by this knowledge, you decide to investigate the huts", INVESTIGATE_HUTS);
+	story.scene(TRACK_PERIMETER).addChoice("Avoid the clearing", AVOID_CLEARING);
 
-	getScene(FOGWOOD)->addChoice("Track the perimeter", getScene(TRACK_PERIMETER));
-	getScene(FOGWOOD)->addChoice("Prepare your weapon and stealthily approach the huts", getScene(FIGHT_GIAK));
+	story.scene(INVESTIGATE_HUTS).addChoice("Call the bird", CALL_BIRD);
+	story.scene(INVESTIGATE_HUTS).addChoice("Ignore it", IGNORE_BIRD);
 
-	getScene(FIGHT_GIAK)->addChoice("Engage in battle", getScene(INVESTIGATE_HUTS));
-	getScene(FIGHT_GIAK)->addChoice("Run away", getScene(AVOID_CLEARING));
+	story.scene(CALL_BIRD).addChoice("Continue your journey along the track", CONTINUE_TRACK);
+	story.scene(CALL_BIRD).addChoice("Leave the track and continue through the forest instead", LEAVE_TRACK);
 
-	getScene(TRACK_PERIMETER)->addChoice("Forewarned by this knowledge, you decide to investigate the huts", getScene(INVESTIGATE_HUTS));
-	getScene(TRACK_PERIMETER)->addChoice("Avoid the clearing", getScene(AVOID_CLEARING));
+	story.scene(CONTINUE_TRACK).addChoice("Call the stranger", CONFRONT_STRANGER);
+	story.scene(CONTINUE_TRACK).addChoice("Draw your weapon and attack", CONFRONT_STRANGER);
 
-	getScene(INVESTIGATE_HUTS)->addChoice("Call the bird", getScene(CALL_BIRD));
-	getScene(INVESTIGATE_HUTS)->addChoice("Ignore it", getScene(IGNORE_BIRD));
+	story.scene(CONFRONT_STRANGER).addChoice("Engage battle", KILLED_MAGE);
+	story.scene(CONFRONT_STRANGER).addChoice("Flee", RUN_FROM_GIAKS);
 
-	getScene(CALL_BIRD)->addChoice("Continue your journey along the track", getScene(CONTINUE_TRACK));
-	getScene(CALL_BIRD)->addChoice("Leave the track and continue through the forest instead", getScene(LEAVE_TRACK));
+	story.scene(KILLED_MAGE).addChoice("Take the gem", TAKE_MAGE_GEM);
+	story.scene(KILLED_MAGE).addChoice("Walked away", RUN_FROM_GIAKS);
 
-	getScene(CONTINUE_TRACK)->addChoice("Call the stranger", getScene(CONFRONT_STRANGER));
-	getScene(CONTINUE_TRACK)->addChoice("Draw your weapon and attack", getScene(CONFRONT_STRANGER));
+	story.scene(RUN_FROM_GIAKS).addChoice("Approach them", APPROACH_MERCHANTS);
+	story.scene(RUN_FROM_GIAKS).addChoice("Walk in the opposite direction", WALK_OPPOSITE);
 
-	getScene(CONFRONT_STRANGER)->addChoice("Engage battle", getScene(KILLED_MAGE));
-	getScene(CONFRONT_STRANGER)->addChoice("Flee", getScene(RUN_FROM_GIAKS));
+	story.scene(IGNORE_BIRD).addChoice("Continue along the path", CONTINUE_TRACK);
+	story.scene(IGNORE_BIRD).addChoice("Take a detour through the forest", LEAVE_TRACK);
 
-	getScene(KILLED_MAGE)->addChoice("Take the gem", getScene(TAKE_MAGE_GEM));
-	getScene(KILLED_MAGE)->addChoice("Walked away", getScene(RUN_FROM_GIAKS));
+	story.scene(LEAVE_TRACK).addChoice("Investigate the smell of wood smoke", INVESTIGATE_SMOKE);
+	story.scene(LEAVE_TRACK).addChoice("Avoid the source of this smoke", AVOID_SMOKE);
 
-	getScene(RUN_FROM_GIAKS)->addChoice("Approach them", getScene(APPROACH_MERCHANTS));
-	getScene(RUN_FROM_GIAKS)->addChoice("Walk in the opposite direction", getScene(WALK_OPPOSITE));
+	story.scene(INVESTIGATE_SMOKE).addChoice("Ask the sage for guidance", APPROACH_MERCHANTS);
+	story.scene(INVESTIGATE_SMOKE).addChoice("Thank him and continue your journey", BATTLE);
 
-	getScene(IGNORE_BIRD)->addChoice("Continue along the path", getScene(CONTINUE_TRACK));
-	getScene(IGNORE_BIRD)->addChoice("Take a detour through the forest", getScene(LEAVE_TRACK));
+	story.scene(AVOID_SMOKE).addChoice("Head towards the mountains", TOWN_END);
+	story.scene(AVOID_SMOKE).addChoice("Follow a faint path through the trees", MARCHING);
 
-	getScene(LEAVE_TRACK)->addChoice("Investigate the smell of wood smoke", getScene(INVESTIGATE_SMOKE));
-	getScene(LEAVE_TRACK)->addChoice("Avoid the source of this smoke", getScene(AVOID_SMOKE));
+	story.scene(AVOID_CLEARING).addChoice("Climb the rocky outcrop for a better view", FELL_DEATH);
+	story.scene(AVOID_CLEARING).addChoice("Continue east through the forest", APPROACH_MERCHANTS);
 
-	getScene(INVESTIGATE_SMOKE)->addChoice("Ask the sage for guidance", getScene(APPROACH_MERCHANTS));
-	getScene(INVESTIGATE_SMOKE)->addChoice("Thank him and continue your journey", getScene(BATTLE));
+	story.scene(CONTINUE_FOREST).addChoice("Investigate a strange sound in the bushes", FIGHT_GIAK);
+	story.scene(CONTINUE_FOREST).addChoice("Keep moving forward cautiously", APPROACH_MERCHANTS);
 
-	getScene(AVOID_SMOKE)->addChoice("Head towards the mountains", getScene(TOWN_END));
-	getScene(AVOID_SMOKE)->addChoice("Follow a faint path through the trees", getScene(MARCHING));
+	story.scene(UNDERGROWTH).addChoice("Hide under dense foliage", CONTINUE_BATTLE);
+	story.scene(UNDERGROWTH).addChoice("Draw your weapon and prepare to fight", FIGHT_GIAK);
 
-	getScene(AVOID_CLEARING)->addChoice("Climb the rocky outcrop for a better view", getScene(FELL_DEATH));
-	getScene(AVOID_CLEARING)->addChoice("Continue east through the forest", getScene(APPROACH_MERCHANTS));
+	story.scene(CAMOUFLAGE).addChoice("Continue your journey after they pass", APPROACH_MERCHANTS);
+	story.scene(CAMOUFLAGE).addChoice("Follow the soldiers at a safe distance", MARCHING);
 
-	getScene(CONTINUE_FOREST)->addChoice("Investigate a strange sound in the bushes", getScene(FIGHT_GIAK));
-	getScene(CONTINUE_FOREST)->addChoice("Keep moving forward cautiously", getScene(APPROACH_MERCHANTS));
+	story.scene(FLEE_BATTLE).addChoice("Rest and recover your strength", WALK_OPPOSITE);
+	story.scene(FLEE_BATTLE).addChoice("Explore the surrounding area", APPROACH_MERCHANTS);
 
-	getScene(UNDERGROWTH)->addChoice("Hide under dense foliage", getScene(CONTINUE_BATTLE));
-	getScene(UNDERGROWTH)->addChoice("Draw your weapon and prepare to fight", getScene(FIGHT_GIAK));
+	story.scene(CONTINUE_BATTLE).addChoice("Follow the wind", CLEARING);
+	story.scene(CONTINUE_BATTLE).addChoice("Continue on your current path", TOWN_END);
 
-	getScene(CAMOUFLAGE)->addChoice("Continue your journey after they pass", getScene(APPROACH_MERCHANTS));
-	getScene(CAMOUFLAGE)->addChoice("Follow the soldiers at a safe distance", getScene(MARCHING));
+	story.setStartScene(START);
+	return story.build();
+}
 
-	getScene(FLEE_BATTLE)->addChoice("Rest and recover your strength", getScene(WALK_OPPOSITE));
-	getScene(FLEE_BATTLE)->addChoice("Explore the surrounding area", getScene(APPROACH_MERCHANTS));
+} // namespace
 
-	getScene(CONTINUE_BATTLE)->addChoice("Follow the wind", getScene(CLEARING));
-	getScene(CONTINUE_BATTLE)->addChoice("Continue on your current path", getScene(TOWN_END));
+std::shared_ptr<const Story> Game::builtinStoryline() {
+	// Definitions are immutable, so every game in the process shares one copy
+	static const std::shared_ptr<const Story> storyline = buildStoryline();
+	return storyline;
+}
 
-	setStartScene(START);
+void Game::setStoryline() {
+	TraceSpan span("Game::setStoryline", "engine");
+	applyStory(builtinStoryline());
+	endlessGate = TOWN_END;
+	rankedEnding = TOWN_END;
 }
 
 void Game::run() {
 	std::string playerName;
-	std::cout << "What is your name: ";
-	std::cin >> playerName;
-
-	std::vector<std::string> text = {
-		"On this fateful morning, you, " + playerName + ", have been sent to collect firewood in the forest as a punishment",
-		"for your inattention in class. As you are preparing to return, you see to your horror a vast cloud of black",
-		"leathery creatures swoop down and engulf the monastery. Dropping the wood, you race to the battle. You grabbed",
-		"your equipments but in the unnatural dark, you stumble and strike your head on a low tree branch. As you lose",
-		"consciousness, the last thing that you see in the poor light are the walls of the monastery crashing to the ground."
-	};
+	Console::out() << tr(StringID::ASK_NAME);
+	{
+		TraceSpan span("input wait", "input");
+		Console::in() >> playerName;
+	}
 
-	printBorderedText(text);
+	SavedGame saved;
+	if (journal) {
+		journalSession = journal->resume(playerName, saved);
+	}
+	if (journalSession) {
+		resumePlayer(saved);
+		Console::out() << tr(StringID::JOURNEY_RESUMED, playerName);
+	}
+	else {
+		printBorderedText({ tr(StringID::INTRO, playerName) });
+		if (journal) {
+			journalSession = journal->begin(playerName, PLAYER_HP, PLAYER_ATK, PLAYER_DEF);
+		}
+		createPlayer(playerName);
+	}
 
-	createPlayer(playerName);
+	RunRecord record;
+	record.player = playerName;
+	// The turns before the resume were not recorded, so the run is kept but never ranked
+	record.resumed = saved.scene != 0;
+	bool reachedEnding = false;
+	std::vector<size_t> living;
+	std::vector<std::string> kills;   // Enemies killed, in order, so rewinding can forget the latest
 
+	int playedScene = 0;
+	bool rewound = false;
 	while (currentScene && player->isAlive()) {
+		refreshStory();
+		if (rewindLimit > 0 && !rewound) {
+			recordTurn(playedScene);
+			history.back().setRunProgress(record.route.size(), kills.size());
+		}
+		rewound = false;
+		if (journalSession) {
+			// The previous turn is on disk before the next one is shown
+			journalSession->recordScene(currentScene->getSceneNumber());
+			journalSession->sync();
+		}
 		currentScene->display();
-		currentScene = currentScene->processInput(player);
+		auto turnStart = std::chrono::steady_clock::now();
+		auto waitedBefore = Console::commands().waited();
+		playedScene = currentScene->getSceneNumber();
+		Scene* played = currentScene;
+		reachedEnding = played->isEnding();
+		record.route.push_back(playedScene);
+		living.clear();
+		for (size_t i = 0; i < played->getEncounter().size(); ++i) {
+			if (played->getEncounter().getSide(i) == Side::ENEMY && played->getEncounter().isAlive(i)) {
+				living.push_back(i);
+			}
+		}
+		bool rewindRequested = false;
+		currentScene = currentScene->processInput(player, history.size() > 1 ? &rewindRequested : nullptr);
+		// Time spent waiting for the player is theirs, not the turn's
+		Telemetry::recordTurnLatency(std::chrono::steady_clock::now() - turnStart - (Console::commands().waited() - waitedBefore));
+		tallyTurn(record, kills, *played, living);
+
+		if (rewindRequested) {
+			rewindTo(history.size() - 2, playedScene);
+			Console::out() << tr(StringID::TURNS_REWOUND, 1);
+			rewound = true;
+		}
+		else if ((!currentScene || !player->isAlive()) && offerRewind(playedScene)) {
+			rewound = true;
+		}
+		if (rewound) {
+			// Rewound turns are no longer part of the run
+			record.route.resize(history.back().getRouteLength());
+			kills.resize(history.back().getKillCount());
+		}
+		evictBehind();
 	}
 
 	if (!player->isAlive()) {
-		std::cout << "\nYour life and your mission end here.\n";
+		Console::out() << tr(StringID::MISSION_ENDS);
+	}
+	if (journalSession) {
+		journalSession->recordEnd();
+		journalSession->sync();
+	}
+
+	record.hitPoints = player->getHitPoints();
+	record.maxHitPoints = player->getMaxHitPoints();
+	record.turns = static_cast<int>(record.route.size());
+	for (const std::string& name : kills) {
+		auto slain = std::find_if(record.slain.begin(), record.slain.end(),
+			[&](const auto& entry) { return entry.first == name; });
+		if (slain == record.slain.end()) {
+			record.slain.emplace_back(name, 1);
+		}
+		else {
+			slain->second++;
+		}
+	}
+	if (leaderboard && !record.resumed && player->isAlive() && reachedEnding && (rankedEnding == 0 || playedScene == rankedEnding)) {
+		rankRun(record);
+	}
+
+	if (runStore) {
+		record.finishedAt = std::chrono::duration_cast<std::chrono::seconds>(
+			std::chrono::system_clock::now().time_since_epoch()).count();
+		record.outcome = !player->isAlive() ? RunOutcome::DIED : reachedEnding ? RunOutcome::ENDING : RunOutcome::QUIT;
+		record.ending = playedScene;
+		if (player->isAlive()) {
+			record.killer.clear();   // Rewound past the death
+		}
+		std::string error;
+		if (!runStore->append(record, error)) {
+			std::cerr << "[runs] " << error << "\n";
+		}
+	}
+}
+
+void Game::tallyTurn(RunRecord& run, std::vector<std::string>& kills, const Scene& played, const std::vector<size_t>& living) const {
+	const Encounter& encounter = played.getEncounter();
+	bool killerFound = false;
+	for (size_t i : living) {
+		if (encounter.isAlive(i)) {
+			if (!player->isAlive() && !killerFound) {
+				run.killer = encounter.getName(i);
+				killerFound = true;
+			}
+			continue;
+		}
+		kills.push_back(encounter.getName(i));
+	}
+}
+
+void Game::setRunStore(RunStore* store) {
+	runStore = store;
+}
+
+void Game::setLeaderboard(Leaderboard* board) {
+	leaderboard = board;
+}
+
+void Game::rankRun(const RunRecord& run) {
+	struct Board {
+		LeaderboardCategory category;
+		StringID title;
+		int value;
+	};
+	const Board rankedBoards[] = {
+		{ LeaderboardCategory::FEWEST_TURNS, StringID::LEADERBOARD_FEWEST_TURNS, run.turns },
+		{ LeaderboardCategory::MOST_HIT_POINTS, StringID::LEADERBOARD_MOST_HIT_POINTS, run.hitPoints },
+		{ LeaderboardCategory::FEWEST_POTIONS, StringID::LEADERBOARD_FEWEST_POTIONS, player->getPotionsUsed() }
+	};
+
+	LeaderboardEntry own[std::size(rankedBoards)];
+	for (size_t i = 0; i < std::size(rankedBoards); ++i) {
+		own[i] = leaderboard->submit(rankedBoards[i].category, run.player, rankedBoards[i].value);
+	}
+
+	// Other sessions keep ranking runs meanwhile, so every query sees the boards as they are now
+	std::ostream& out = Console::out();
+	out << tr(StringID::LEADERBOARD_TITLE, leaderboard->size(LeaderboardCategory::FEWEST_TURNS));
+	for (size_t i = 0; i < std::size(rankedBoards); ++i) {
+		const Board& board = rankedBoards[i];
+		out << tr(board.title);
+		std::vector<LeaderboardEntry> best = leaderboard->top(board.category, LEADERBOARD_SHOWN);
+		for (size_t place = 0; place < best.size(); ++place) {
+			out << tr(StringID::LEADERBOARD_ENTRY, place + 1, best[place].player, best[place].value);
+		}
+		out << tr(StringID::LEADERBOARD_OWN_RANK, leaderboard->rank(board.category, own[i]),
+			leaderboard->size(board.category), board.value);
+	}
+}
+
+void Game::reportRuns(const RunStore& store, const std::string& player) const {
+	auto start = std::chrono::steady_clock::now();
+	std::vector<int> endings;
+	for (int number : story->sceneNumbers()) {
+		if (story->find(number)->choices.empty()) {
+			endings.push_back(number);
+		}
+	}
+
+	std::cout << "\n- - - Run History (" << store.runCount() << " runs, " << store.countRuns(player)
+		<< " by " << player << ") - - -\n";
+	std::vector<int> unseen = store.unseenEndings(player, endings);
+	std::cout << "Endings " << player << " has not reached yet: " << unseen.size() << " of " << endings.size() << "\n";
+	for (int ending : unseen) {
+		std::cout << "  Scene " << ending << "\n";
+	}
+
+	std::cout << "Best runs per ending:\n";
+	for (int ending : endings) {
+		std::optional<RunRecord> best = store.bestHitPoints(ending);
+		std::optional<RunRecord> fastest = store.fastestRoute(ending);
+		if (!best) continue;
+		std::cout << "  Scene " << std::setw(2) << ending << ": most HP " << best->hitPoints << "/" << best->maxHitPoints
+			<< " by " << best->player;
+		// Only resumed runs reached it, and those are not timed
+		if (!fastest) {
+			std::cout << "\n";
+			continue;
+		}
+		std::cout << ", fastest " << fastest->turns << " scenes by " << fastest->player << " (";
+		for (size_t i = 0; i < fastest->route.size(); ++i) {
+			std::cout << (i > 0 ? " > " : "") << fastest->route[i];
+		}
+		std::cout << ")\n";
+	}
+
+	std::cout << "Deaths by enemy:\n";
+	for (const auto& [name, count] : store.deathsByEnemy()) {
+		std::cout << "  " << std::left << std::setw(20) << name << std::right << " " << count << "\n";
+	}
+	std::cout << "Deaths by scene:\n";
+	for (const auto& [scene, count] : store.deathsByScene()) {
+		std::cout << "  Scene " << std::setw(2) << scene << "           " << count << "\n";
+	}
+
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "Answered from the indexes in " << std::fixed << std::setprecision(2) << elapsed.count() << " ms\n";
+}
+
+void Game::simulateEncounters(int trials) {
+	// A fresh character with starting equipment, through the same modifiers as a player
+	StatBlock starterStats;
+	starterStats.setBase(Stat::ATTACK, PLAYER_ATK);
+	starterStats.setBase(Stat::DEFENSE, PLAYER_DEF);
+	starterStats.add({ Stat::ATTACK, STARTER_WEAPON_ATK, ModifierSource::EQUIPMENT, {} });
+	starterStats.add({ Stat::DEFENSE, STARTER_ARMOR_DEF, ModifierSource::EQUIPMENT, {} });
+	FastRng rng(std::random_device{}());
+
+	// Every encounter is simulated, so build the scenes nobody visited yet
+	for (int number : story->sceneNumbers()) {
+		getScene(number);
+	}
+
+	std::cout << "\n- - - Encounter Simulation (" << trials << " fights each) - - -\n";
+	// Chances come straight from the rules the fights roll with
+	const CombatDice& rules = Encounter::dice();
+	std::cout << std::fixed << std::setprecision(1)
+		<< "Hits on " << rules.playerHit.getText() << " (" << 100 * rules.playerHit.successChance() << "%), "
+		<< "enemy hits on " << rules.enemyHit.getText() << " (" << 100 * rules.enemyHit.successChance() << "%), "
+		<< "flees on " << rules.flee.getText() << " (" << 100 * rules.flee.successChance() << "%)\n";
+	for (const auto& [id, scene] : scenes) {
+		const Encounter& encounter = scene->getEncounter();
+		if (encounter.size() == 0) continue;
+
+		// Effects of the fight are applied once; every round reads the cached totals
+		ModifierID mindAttack = starterStats.add({ Stat::ATTACK, -mindAttackPenalty(encounter, 0), ModifierSource::EFFECT, {} });
+		CombatStats starter{ PLAYER_HP, starterStats.get(Stat::ATTACK), starterStats.get(Stat::DEFENSE) };
+		starterStats.remove(mindAttack);
+
+		int wins = 0;
+		long long rounds = 0;
+		auto start = std::chrono::steady_clock::now();
+		bool logged = CombatLog::isOpen();
+		for (int i = 0; i < trials; ++i) {
+			// Without a combat log the fights emit nothing at all
+			std::optional<CombatStream> events;
+			if (logged) events.emplace(encounter, nullptr);
+			EncounterResult result = encounter.simulate(starter, rng, events ? &*events : nullptr);
+			wins += result.playerWon;
+			rounds += result.rounds;
+		}
+		std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+
+		std::cout << "Scene " << std::setw(2) << id << " (" << encounter.size() << " combatants): "
+			<< std::fixed << std::setprecision(1)
+			<< 100.0 * wins / trials << "% wins, "
+			<< static_cast<double>(rounds) / trials << " rounds, "
+			<< std::setprecision(2) << elapsed.count() / trials << " us per fight\n";
+
+		// One-on-one fights can also run through the vectorized batch kernel
+		if (encounter.size() != 1 || encounter.getSide(0) != Side::ENEMY) continue;
+
+		CombatStats enemy{ encounter.getHitPoints(0), encounter.getAttackValue(0), encounter.getDefenseValue(0) };
+		start = std::chrono::steady_clock::now();
+		BatchResult batch = simulateBatch(starter, enemy, static_cast<uint64_t>(trials), rng.next());
+		elapsed = std::chrono::steady_clock::now() - start;
+
+		std::cout << "         batch " << std::left << std::setw(7) << batchKernelName() << std::right
+			<< std::setprecision(1)
+			<< 100.0 * static_cast<double>(batch.playerWins) / static_cast<double>(batch.fights) << "% wins, "
+			<< static_cast<double>(batch.rounds) / static_cast<double>(batch.fights) << " rounds, "
+			<< static_cast<double>(batch.rounds) / elapsed.count() << " M rounds/s\n";
+	}
+}
+
+void Game::exploreBranches(size_t maxBranches) {
+	// A fresh character with starting equipment
+	GameState start;
+	start.setScene(story->getStartScene());
+	PlayerState& starter = start.editPlayer();
+	starter.hitPoints = starter.maxHitPoints = PLAYER_HP;
+	starter.attack = PLAYER_ATK;
+	starter.defense = PLAYER_DEF;
+	starter.weapons.write().push_back({ std::string(tr(StringID::STARTER_WEAPON)), STARTER_WEAPON_ATK });
+	starter.armor.write().push_back({ std::string(tr(StringID::STARTER_ARMOR)), STARTER_ARMOR_DEF });
+	starter.potions.write().push_back({ std::string(tr(StringID::STARTER_POTION)), STARTER_POTION_HEAL });
+	starter.equippedWeapon = 0;
+	starter.equippedArmor = 0;
+
+	FastRng rng(std::random_device{}());
+	Encounter fight;
+	// The player picks a discipline, or none, before the first scene
+	std::vector<GameState> frontier{ start };
+	for (size_t skill = 0; skill < static_cast<size_t>(Skill::COUNT); ++skill) {
+		GameState trained = start;
+		trained.editPlayer().skills = skillBit(static_cast<Skill>(skill));
+		frontier.push_back(std::move(trained));
+	}
+	std::vector<GameState> next;
+	size_t explored = 0;
+	size_t peak = frontier.size();
+	size_t endings = 0;
+	size_t deaths = 0;
+	size_t pruned = 0;
+
+	// Never keep more branches alive than will be explored, which bounds memory
+	auto fork = [&](GameState&& branch) {
+		if (next.size() < maxBranches) {
+			next.push_back(std::move(branch));
+		}
+		else {
+			pruned++;
+		}
+	};
+
+	auto began = std::chrono::steady_clock::now();
+	while (!frontier.empty() && explored < maxBranches) {
+		for (GameState& state : frontier) {
+			if (explored == maxBranches) break;
+			explored++;
+
+			const SceneDef* def = story->find(state.getScene());
+			const Scene* scene = getScene(state.getScene());
+			if (!def || !scene) {
+				endings++;
+				continue;
+			}
+
+			// Enemy hit points of this branch
+			fight = scene->getEncounter();
+			const SceneState& sceneState = state.getSceneState(def->number);
+			for (size_t i = 0; i < sceneState.hitPoints.size() && i < fight.size(); ++i) {
+				if (sceneState.hitPoints[i] >= 0) fight.setHitPoints(i, sceneState.hitPoints[i]);
+			}
+			bool enemyAlive = fight.countLiving(Side::ENEMY) > 0;
+
+			// Loot is handed out on arrival once no enemy is left
+			if (!enemyAlive && !sceneState.looted && !def->loot.empty()) {
+				SceneState looted = sceneState;
+				looted.looted = true;
+				PlayerState& player = state.editPlayer();
+				for (const LootDef& item : def->loot) {
+					player.editInventory(item.kind).push_back({ item.name, item.bonus });
+				}
+				state.setSceneState(def->number, std::move(looted));
+			}
+			if (def->choices.empty()) {
+				endings++;
+				continue;
+			}
+
+			for (size_t c = 0; c < def->choices.size(); ++c) {
+				const ChoiceDef& choice = def->choices[c];
+				if (choice.minRoll > 0) {
+					// A failed roll check is a branch of its own
+					if (choice.fail > 0) {
+						GameState failed = state;
+						failed.setScene(choice.fail);
+						fork(std::move(failed));
+					}
+					else {
+						endings++;
+					}
+				}
+
+				if (!enemyAlive || c != 0) {
+					GameState moved = state;
+					moved.setScene(choice.next);
+					fork(std::move(moved));
+					continue;
+				}
+
+				// Fighting forks into a few sampled outcomes
+				const PlayerState& player = state.getPlayer();
+				CombatStats stats{ player.hitPoints, player.totalAttack() - mindAttackPenalty(fight, player.skills), player.totalDefense() };
+				if (player.skills & skillBit(Skill::MINDBLAST)) {
+					stats.openingBonus = MINDBLAST_BONUS;
+					stats.openingRounds = MINDBLAST_ROUNDS;
+				}
+				std::vector<int> survived;
+				for (int sample = 0; sample < FIGHT_SAMPLES; ++sample) {
+					EncounterResult result = fight.simulate(stats, rng);
+					if (!result.playerWon) {
+						deaths++;
+					}
+					else if (std::find(survived.begin(), survived.end(), result.playerHitPoints) == survived.end()) {
+						survived.push_back(result.playerHitPoints);
+					}
+				}
+				for (int hitPoints : survived) {
+					GameState won = state;
+					PlayerState& winner = won.editPlayer();
+					winner.hitPoints = hitPoints;
+					SceneState defeated = won.getSceneState(def->number);
+					defeated.hitPoints.resize(fight.size(), -1);
+					for (size_t i = 0; i < fight.size(); ++i) {
+						if (fight.getSide(i) == Side::ENEMY) defeated.hitPoints[i] = 0;
+					}
+					// The spoils are handed out as soon as the fight is won, before the branch moves on
+					if (!defeated.looted) {
+						defeated.looted = true;
+						for (const LootDef& item : def->loot) {
+							winner.editInventory(item.kind).push_back({ item.name, item.bonus });
+						}
+					}
+					won.setSceneState(def->number, std::move(defeated));
+					won.setScene(choice.next);
+					fork(std::move(won));
+				}
+			}
+		}
+		peak = std::max(peak, next.size());
+		frontier.swap(next);
+		next.clear();
 	}
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - began;
+
+	std::cout << "\n- - - Branch Exploration (" << explored << " branches) - - -\n"
+		<< "Endings reached: " << endings << ", deaths: " << deaths
+		<< ", unexplored at the limit: " << frontier.size() + pruned << "\n"
+		<< "Most branches alive at once: " << peak << "\n"
+		<< std::fixed << std::setprecision(1) << elapsed.count() << " ms ("
+		<< explored / std::max(elapsed.count(), 0.001) * 1000.0 << " branches per second)\n";
 }
\ No newline at end of file
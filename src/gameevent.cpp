@@ -0,0 +1,45 @@
+#include "gameevent.h"
+#include "localization.h"
+
+namespace {
+
+StringID foundString(ItemKind kind) {
+	switch (kind) {
+	case ItemKind::WEAPON: return StringID::LOOT_WEAPON;
+	case ItemKind::ARMOR: return StringID::LOOT_ARMOR;
+	default: return StringID::LOOT_POTION;
+	}
+}
+
+} // namespace
+
+void presentEvent(const GameEvent& event, std::ostream& out) {
+	switch (event.type) {
+	case GameEventType::TEXT:
+	case GameEventType::SCENE_ENTERED:
+		out.write(event.text.data(), static_cast<std::streamsize>(event.text.size()));
+		break;
+	case GameEventType::PAUSE:
+		break;
+	case GameEventType::LOOT_RECEIVED:
+		out << tr(StringID::LOOT_RECEIVED);
+		break;
+	case GameEventType::ITEM_FOUND:
+		out << tr(foundString(event.kind), event.text, event.value);
+		break;
+	case GameEventType::ITEM_ADDED:
+		out << tr(StringID::ITEM_ADDED, event.text);
+		break;
+	case GameEventType::ITEM_EQUIPPED:
+		out << tr(event.kind == ItemKind::ARMOR ? StringID::ARMOR_EQUIPPED : StringID::WEAPON_EQUIPPED, event.text);
+		break;
+	case GameEventType::DAMAGE_TAKEN:
+		out << tr(StringID::TAKES_DAMAGE, event.text, event.value);
+		out << tr(StringID::PLAYER_HP, event.hitPoints, event.maxHitPoints);
+		break;
+	case GameEventType::HEALED:
+		out << tr(StringID::HEALS, event.text, event.value);
+		out << tr(StringID::PLAYER_HP, event.hitPoints, event.maxHitPoints);
+		break;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include "gamestate.h"
+#include "modifier.h"
+
+const std::vector<ItemState>& PlayerState::inventory(ItemKind kind) const {
+	switch (kind) {
+	case ItemKind::WEAPON:
+		return *weapons;
+	case ItemKind::ARMOR:
+		return *armor;
+	default:
+		return *potions;
+	}
+}
+
+std::vector<ItemState>& PlayerState::editInventory(ItemKind kind) {
+	switch (kind) {
+	case ItemKind::WEAPON:
+		return weapons.write();
+	case ItemKind::ARMOR:
+		return armor.write();
+	default:
+		return potions.write();
+	}
+}
+
+int* PlayerState::equippedSlot(ItemKind kind) {
+	switch (kind) {
+	case ItemKind::WEAPON:
+		return &equippedWeapon;
+	case ItemKind::ARMOR:
+		return &equippedArmor;
+	default:
+		return nullptr;
+	}
+}
+
+int PlayerState::totalAttack() const {
+	int total = attack + skillBonus(skills, Stat::ATTACK);
+	if (equippedWeapon >= 0 && static_cast<size_t>(equippedWeapon) < weapons->size())
+		total += (*weapons)[equippedWeapon].value;
+	return total;
+}
+
+int PlayerState::totalDefense() const {
+	int total = defense + skillBonus(skills, Stat::DEFENSE);
+	if (equippedArmor >= 0 && static_cast<size_t>(equippedArmor) < armor->size())
+		total += (*armor)[equippedArmor].value;
+	return total;
+}
+
+int GameState::getScene() const {
+	return scene;
+}
+
+void GameState::setScene(int number) {
+	scene = number;
+}
+
+size_t GameState::getRouteLength() const {
+	return routeLength;
+}
+
+size_t GameState::getKillCount() const {
+	return killCount;
+}
+
+void GameState::setRunProgress(size_t scenesPlayed, size_t enemiesKilled) {
+	routeLength = scenesPlayed;
+	killCount = enemiesKilled;
+}
+
+const PlayerState& GameState::getPlayer() const {
+	return *player;
+}
+
+PlayerState& GameState::editPlayer() {
+	return player.write();
+}
+
+const SceneState& GameState::getSceneState(int number) const {
+	return world.get(static_cast<size_t>(number));
+}
+
+void GameState::setSceneState(int number, SceneState state) {
+	world.set(static_cast<size_t>(number), std::move(state));
+}
+
+void GameState::clearSceneStates(int first, int last) {
+	world.clear(static_cast<size_t>(first), static_cast<size_t>(last));
+}
+
+bool GameState::sharesPlayerWith(const GameState& other) const {
+	return player.sharesWith(other.player);
+}
\ No newline at end of file
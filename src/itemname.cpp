@@ -0,0 +1,63 @@
+#include "itemname.h"
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+constexpr size_t CHUNK_BITS = 10;
+constexpr size_t CHUNK_SIZE = size_t{ 1 } << CHUNK_BITS;
+constexpr size_t MAX_CHUNKS = 4096;   // Room for four million distinct names
+
+/**
+ * @brief Interned names in chunks that never move, so readers need no lock
+ */
+struct NameTable {
+	std::mutex mutex;
+	std::unordered_map<std::string_view, uint32_t> ids;   // Views into the chunks
+	std::array<std::atomic<std::string*>, MAX_CHUNKS> chunks{};
+	uint32_t count = 1;   // Number 0 stays the empty name
+};
+
+NameTable& table() {
+	static NameTable names;
+	return names;
+}
+
+} // namespace
+
+ItemName::ItemName(std::string_view name) {
+	if (name.empty()) return;
+	NameTable& names = table();
+	std::lock_guard<std::mutex> lock(names.mutex);
+	auto found = names.ids.find(name);
+	if (found != names.ids.end()) {
+		id = found->second;
+		return;
+	}
+
+	size_t chunk = names.count >> CHUNK_BITS;
+	if (chunk >= MAX_CHUNKS) {
+		throw std::length_error("too many distinct item names");
+	}
+	std::string* slots = names.chunks[chunk].load(std::memory_order_relaxed);
+	if (slots == nullptr) {
+		// Chunks live as long as the process, like the numbers handed out for them
+		slots = new std::string[CHUNK_SIZE];
+		names.chunks[chunk].store(slots, std::memory_order_release);
+	}
+	std::string& slot = slots[names.count & (CHUNK_SIZE - 1)];
+	slot.assign(name);
+	id = names.count++;
+	names.ids.emplace(slot, id);
+}
+
+const std::string& ItemName::str() const {
+	static const std::string EMPTY;
+	if (id == 0) return EMPTY;
+	// The number reached this thread after its name was written, like any other value of the item
+	return table().chunks[id >> CHUNK_BITS].load(std::memory_order_acquire)[id & (CHUNK_SIZE - 1)];
+}
\ No newline at end of file
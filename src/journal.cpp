@@ -0,0 +1,723 @@
+#include "journal.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include "console.h"
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char SNAPSHOT_MAGIC[4] = { 'L', 'W', 'S', 'N' };
+constexpr uint32_t SNAPSHOT_VERSION = 2;
+constexpr uint32_t SKILLS_VERSION = 2;   // First version that stores the player's skills
+constexpr size_t RECORD_HEADER = 8;   // Body length and checksum
+constexpr size_t MAX_TEXT = 4096;
+constexpr size_t MAX_RECORD_TEXT = 16 * 1024 * 1024;   // RESTORE records carry a whole game
+constexpr int32_t MAX_COMBATANTS = 4096;
+
+int openLog(const std::string& path) {
+#ifdef _WIN32
+	return _open(path.c_str(), _O_RDWR | _O_CREAT | _O_APPEND | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+	return ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+#endif
+}
+
+void closeLog(int fd) {
+#ifdef _WIN32
+	_close(fd);
+#else
+	::close(fd);
+#endif
+}
+
+bool writeAll(int fd, const std::string& data) {
+	size_t written = 0;
+	while (written < data.size()) {
+#ifdef _WIN32
+		int result = _write(fd, data.data() + written, static_cast<unsigned>(data.size() - written));
+#else
+		ssize_t result = ::write(fd, data.data() + written, data.size() - written);
+		if (result < 0 && errno == EINTR) continue;
+#endif
+		if (result <= 0) return false;
+		written += static_cast<size_t>(result);
+	}
+	return true;
+}
+
+bool syncFile(int fd) {
+#ifdef _WIN32
+	return _commit(fd) == 0;
+#elif defined(__APPLE__)
+	return fsync(fd) == 0;
+#else
+	return fdatasync(fd) == 0;
+#endif
+}
+
+bool truncateFile(int fd, size_t size) {
+#ifdef _WIN32
+	return _chsize_s(fd, static_cast<long long>(size)) == 0;
+#else
+	return ftruncate(fd, static_cast<off_t>(size)) == 0;
+#endif
+}
+
+bool readFile(const std::string& path, std::string& data) {
+	std::ifstream file(path, std::ios::binary);
+	if (!file) return false;
+	file.seekg(0, std::ios::end);
+	data.resize(static_cast<size_t>(file.tellg()));
+	file.seekg(0, std::ios::beg);
+	file.read(data.data(), static_cast<std::streamsize>(data.size()));
+	return static_cast<bool>(file);
+}
+
+/**
+ * @brief FNV-1a checksum, enough to tell a torn or damaged write from a complete one
+ */
+uint32_t checksum(const char* data, size_t size) {
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < size; ++i) {
+		hash = (hash ^ static_cast<unsigned char>(data[i])) * 16777619u;
+	}
+	return hash;
+}
+
+/**
+ * @brief Appends fixed-size values in host byte order; journals are not meant to move between machines
+ */
+class Writer {
+private:
+	std::string& out;
+
+public:
+	explicit Writer(std::string& target) : out(target) {}
+
+	template <typename T>
+	void put(T value) {
+		char bytes[sizeof(T)];
+		std::memcpy(bytes, &value, sizeof(T));
+		out.append(bytes, sizeof(T));
+	}
+
+	void putText(const std::string& text) {
+		put(static_cast<uint32_t>(text.size()));
+		out.append(text);
+	}
+};
+
+class Reader {
+private:
+	const std::string& in;
+	size_t pos;
+	size_t end;
+
+public:
+	Reader(const std::string& source, size_t offset, size_t limit) : in(source), pos(offset), end(limit) {}
+
+	template <typename T>
+	bool get(T& value) {
+		if (end - pos < sizeof(T)) return false;
+		std::memcpy(&value, in.data() + pos, sizeof(T));
+		pos += sizeof(T);
+		return true;
+	}
+
+	bool getText(std::string& text, size_t limit = MAX_TEXT) {
+		uint32_t length;
+		if (!get(length) || length > limit || end - pos < length) return false;
+		text.assign(in, pos, length);
+		pos += length;
+		return true;
+	}
+};
+
+void encodeRecord(std::string& out, uint64_t sequence, const JournalRecord& record) {
+	size_t start = out.size();
+	out.append(RECORD_HEADER, '\0');
+	Writer writer(out);
+	writer.put(sequence);
+	writer.put(static_cast<uint8_t>(record.type));
+	writer.put(record.game);
+	for (int32_t value : record.values) {
+		writer.put(value);
+	}
+	writer.putText(record.text);
+
+	uint32_t length = static_cast<uint32_t>(out.size() - start - RECORD_HEADER);
+	uint32_t sum = checksum(out.data() + start + RECORD_HEADER, length);
+	std::memcpy(out.data() + start, &length, sizeof(length));
+	std::memcpy(out.data() + start + sizeof(length), &sum, sizeof(sum));
+}
+
+/**
+ * @brief Decodes the record at offset and advances past it
+ *
+ * @return bool False at the end of the log or at a torn or damaged record
+ */
+bool decodeRecord(const std::string& log, size_t& offset, uint64_t& sequence, JournalRecord& record) {
+	uint32_t length;
+	uint32_t sum;
+	Reader header(log, offset, log.size());
+	if (!header.get(length) || !header.get(sum)) return false;
+	size_t body = offset + RECORD_HEADER;
+	if (log.size() - body < length || checksum(log.data() + body, length) != sum) return false;
+
+	Reader reader(log, body, body + length);
+	uint8_t type;
+	if (!reader.get(sequence) || !reader.get(type) || !reader.get(record.game)) return false;
+	for (int32_t& value : record.values) {
+		if (!reader.get(value)) return false;
+	}
+	if (!reader.getText(record.text, MAX_RECORD_TEXT)) return false;
+	record.type = static_cast<RecordType>(type);
+	offset = body + length;
+	return true;
+}
+
+void encodeItems(Writer& writer, const std::vector<ItemState>& items) {
+	writer.put(static_cast<uint32_t>(items.size()));
+	for (const ItemState& item : items) {
+		writer.putText(item.name);
+		writer.put(static_cast<int32_t>(item.value));
+	}
+}
+
+bool decodeItems(Reader& reader, std::vector<ItemState>& items) {
+	uint32_t count;
+	if (!reader.get(count)) return false;
+	for (uint32_t i = 0; i < count; ++i) {
+		ItemState item;
+		int32_t value;
+		if (!reader.getText(item.name) || !reader.get(value)) return false;
+		item.value = value;
+		items.push_back(std::move(item));
+	}
+	return true;
+}
+
+/**
+ * @brief Encodes the scene, player and world of a game, shared by snapshots and RESTORE records
+ */
+void encodeGameState(Writer& writer, const SavedGame& game) {
+	const PlayerState& player = game.player;
+	for (int value : { game.scene, player.hitPoints, player.maxHitPoints, player.attack, player.defense,
+		player.equippedWeapon, player.equippedArmor }) {
+		writer.put(static_cast<int32_t>(value));
+	}
+	encodeItems(writer, *player.weapons);
+	encodeItems(writer, *player.armor);
+	encodeItems(writer, *player.potions);
+	writer.put(static_cast<uint32_t>(game.world.size()));
+	for (const auto& [number, scene] : game.world) {
+		writer.put(static_cast<int32_t>(number));
+		writer.put(static_cast<uint8_t>(scene.looted));
+		writer.put(static_cast<uint32_t>(scene.hitPoints.size()));
+		for (int hitPoints : scene.hitPoints) {
+			writer.put(static_cast<int32_t>(hitPoints));
+		}
+	}
+	writer.put(player.skills);
+}
+
+/**
+ * @brief Decodes the scene, player and world of a game; the name is left alone
+ *
+ * @param version - Snapshot version the data was written with
+ */
+bool decodeGameState(Reader& reader, SavedGame& game, uint32_t version) {
+	int32_t values[7];
+	for (int32_t& value : values) {
+		if (!reader.get(value)) return false;
+	}
+	PlayerState& player = game.player;
+	game.scene = values[0];
+	player.hitPoints = values[1];
+	player.maxHitPoints = values[2];
+	player.attack = values[3];
+	player.defense = values[4];
+	player.equippedWeapon = values[5];
+	player.equippedArmor = values[6];
+	if (!decodeItems(reader, player.weapons.write()) || !decodeItems(reader, player.armor.write())
+		|| !decodeItems(reader, player.potions.write())) {
+		return false;
+	}
+	uint32_t scenes;
+	if (!reader.get(scenes)) return false;
+	for (uint32_t s = 0; s < scenes; ++s) {
+		int32_t number;
+		uint8_t looted;
+		uint32_t combatants;
+		if (!reader.get(number) || !reader.get(looted) || !reader.get(combatants)) return false;
+		SceneState& scene = game.world[number];
+		scene.looted = looted != 0;
+		for (uint32_t c = 0; c < combatants; ++c) {
+			int32_t hitPoints;
+			if (!reader.get(hitPoints)) return false;
+			scene.hitPoints.push_back(hitPoints);
+		}
+	}
+	return version < SKILLS_VERSION || reader.get(player.skills);
+}
+
+/**
+ * @brief Applies a record to the saved state; shared by live appends and recovery
+ */
+void applyRecord(std::unordered_map<uint32_t, SavedGame>& games, const JournalRecord& record) {
+	if (record.type == RecordType::BEGIN) {
+		SavedGame& game = games[record.game];
+		game = SavedGame{};
+		game.name = record.text;
+		game.player.hitPoints = game.player.maxHitPoints = record.values[0];
+		game.player.attack = record.values[1];
+		game.player.defense = record.values[2];
+		return;
+	}
+
+	auto it = games.find(record.game);
+	if (it == games.end()) return;
+	SavedGame& game = it->second;
+	PlayerState& player = game.player;
+	ItemKind kind = static_cast<ItemKind>(record.values[0]);
+
+	switch (record.type) {
+	case RecordType::SCENE:
+		game.scene = record.values[0];
+		break;
+	case RecordType::PLAYER_HP:
+		player.hitPoints = record.values[0];
+		break;
+	case RecordType::COMBATANT_HP: {
+		if (record.values[0] < 0 || record.values[0] >= MAX_COMBATANTS) break;
+		std::vector<int>& hitPoints = game.world[game.scene].hitPoints;
+		size_t index = static_cast<size_t>(record.values[0]);
+		if (index >= hitPoints.size()) {
+			hitPoints.resize(index + 1, -1);
+		}
+		hitPoints[index] = record.values[1];
+		break;
+	}
+	case RecordType::ITEM_GAINED:
+		player.editInventory(kind).push_back({ record.text, record.values[1] });
+		break;
+	case RecordType::ITEM_REMOVED: {
+		int index = record.values[1];
+		if (index < 0 || static_cast<size_t>(index) >= player.inventory(kind).size()) break;
+		std::vector<ItemState>& items = player.editInventory(kind);
+		items.erase(items.begin() + index);
+		// Keep the equipped index pointing at the same item
+		if (int* slot = player.equippedSlot(kind)) {
+			if (*slot == index) *slot = -1;
+			else if (*slot > index) (*slot)--;
+		}
+		break;
+	}
+	case RecordType::EQUIP:
+		if (int* slot = player.equippedSlot(kind)) {
+			*slot = record.values[1];
+		}
+		break;
+	case RecordType::LOOTED:
+		game.world[game.scene].looted = true;
+		break;
+	case RecordType::RESTORE: {
+		SavedGame restored;
+		Reader reader(record.text, 0, record.text.size());
+		if (!decodeGameState(reader, restored, SNAPSHOT_VERSION)) {
+			// Written before skills were stored
+			restored = SavedGame{};
+			Reader older(record.text, 0, record.text.size());
+			if (!decodeGameState(older, restored, SKILLS_VERSION - 1)) break;
+		}
+		restored.name = std::move(game.name);
+		game = std::move(restored);
+		break;
+	}
+	case RecordType::SKILL:
+		if (record.values[0] >= 0 && record.values[0] < 32) {
+			player.skills |= 1u << record.values[0];
+		}
+		break;
+	case RecordType::FORGET:
+		if (record.values[0] < record.values[1]) {
+			game.world.erase(game.world.lower_bound(record.values[0]), game.world.lower_bound(record.values[1]));
+		}
+		break;
+	case RecordType::END:
+		games.erase(it);
+		break;
+	default:
+		// Choices and rolls are kept for auditing; they do not change state by themselves
+		break;
+	}
+}
+
+std::string encodeSnapshot(const std::unordered_map<uint32_t, SavedGame>& games, uint64_t sequence, uint32_t nextGame) {
+	std::string image(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+	Writer writer(image);
+	writer.put(SNAPSHOT_VERSION);
+	writer.put(sequence);
+	writer.put(nextGame);
+	writer.put(static_cast<uint32_t>(games.size()));
+	for (const auto& [id, game] : games) {
+		writer.put(id);
+		writer.putText(game.name);
+		encodeGameState(writer, game);
+	}
+	writer.put(checksum(image.data(), image.size()));
+	return image;
+}
+
+bool decodeSnapshot(const std::string& image, std::unordered_map<uint32_t, SavedGame>& games, uint64_t& sequence, uint32_t& nextGame) {
+	if (image.size() < sizeof(SNAPSHOT_MAGIC) + sizeof(uint32_t)
+		|| std::memcmp(image.data(), SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+		return false;
+	}
+	size_t bodyEnd = image.size() - sizeof(uint32_t);
+	uint32_t sum;
+	std::memcpy(&sum, image.data() + bodyEnd, sizeof(sum));
+	if (checksum(image.data(), bodyEnd) != sum) return false;
+
+	Reader reader(image, sizeof(SNAPSHOT_MAGIC), bodyEnd);
+	uint32_t version;
+	uint32_t count;
+	if (!reader.get(version) || version == 0 || version > SNAPSHOT_VERSION || !reader.get(sequence) || !reader.get(nextGame) || !reader.get(count)) {
+		return false;
+	}
+	for (uint32_t i = 0; i < count; ++i) {
+		uint32_t id;
+		SavedGame game;
+		if (!reader.get(id) || !reader.getText(game.name) || !decodeGameState(reader, game, version)) return false;
+		games[id] = std::move(game);
+	}
+	return true;
+}
+
+} // namespace
+
+Journal::Journal() = default;
+
+Journal::~Journal() {
+	close();
+}
+
+bool Journal::open(const std::string& logPath, std::string& error) {
+	path = logPath;
+	fd = openLog(path);
+	if (fd < 0) {
+		error = "cannot open " + path;
+		return false;
+	}
+	recover();
+	flusher = std::thread(&Journal::flushLoop, this);
+	return true;
+}
+
+void Journal::recover() {
+	auto start = std::chrono::steady_clock::now();
+
+	std::string image;
+	if (readFile(path + ".snap", image) && !decodeSnapshot(image, games, snapshotSequence, nextGame)) {
+		std::cerr << "[journal] ignoring damaged snapshot " << path << ".snap\n";
+		games.clear();
+		snapshotSequence = 0;
+		nextGame = 1;
+	}
+
+	std::string log;
+	readFile(path, log);
+	size_t offset = 0;
+	size_t replayed = 0;
+	uint64_t sequence;
+	JournalRecord record;
+	while (decodeRecord(log, offset, sequence, record)) {
+		nextSequence = std::max(nextSequence, sequence + 1);
+		nextGame = std::max(nextGame, record.game + 1);
+		// Records already contained in the snapshot (crash before the log was truncated)
+		if (sequence <= snapshotSequence) continue;
+		applyRecord(games, record);
+		replayed++;
+	}
+	if (offset < log.size()) {
+		std::cerr << "[journal] discarding " << log.size() - offset << " bytes of incomplete records\n";
+		truncateFile(fd, offset);
+	}
+	logBytes = offset;
+	nextSequence = std::max(nextSequence, snapshotSequence + 1);
+	durableSequence.store(nextSequence - 1, std::memory_order_release);
+
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	std::cerr << "[journal] " << games.size() << " unfinished games, " << replayed
+		<< " records replayed in " << elapsed.count() << " ms\n";
+}
+
+void Journal::close() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (fd < 0) return;
+		stopping = true;
+	}
+	wakeFlusher.notify_one();
+	if (flusher.joinable()) {
+		flusher.join();
+	}
+
+	// A clean shutdown leaves only the snapshot, so the next start replays nothing
+	std::string image;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		image = encodeSnapshot(games, nextSequence - 1, nextGame);
+	}
+	std::string error;
+	if (writeSnapshot(image, error)) {
+		truncateFile(fd, 0);
+	}
+	else {
+		std::cerr << "[journal] " << error << "\n";
+	}
+	closeLog(fd);
+	fd = -1;
+	std::cerr << "[journal] closed after " << commitCount() << " commits, " << games.size() << " unfinished games\n";
+}
+
+void Journal::flushLoop() {
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true) {
+		wakeFlusher.wait(lock, [this] { return !pending.empty() || stopping; });
+		if (pending.empty()) break;
+
+		// Everything appended while the previous commit was syncing goes out together
+		std::string batch;
+		batch.swap(pending);
+		uint64_t last = nextSequence - 1;
+		std::string image;
+		if (logBytes >= SNAPSHOT_INTERVAL) {
+			image = encodeSnapshot(games, last, nextGame);
+			logBytes = 0;
+		}
+		lock.unlock();
+
+		bool written = writeAll(fd, batch) && syncFile(fd);
+		if (!written) {
+			// Keep the games running; they just lose crash safety
+			std::cerr << "[journal] cannot write " << path << ", journaling stopped\n";
+			durableSequence.store(std::numeric_limits<uint64_t>::max(), std::memory_order_release);
+			durableSequence.notify_all();
+			lock.lock();
+			failed = true;
+			pending.clear();
+			return;
+		}
+		durableSequence.store(last, std::memory_order_release);
+		durableSequence.notify_all();
+		commits.fetch_add(1, std::memory_order_relaxed);
+
+		if (!image.empty()) {
+			std::string error;
+			// The snapshot holds everything in the log, so the log can start over
+			if (writeSnapshot(image, error)) {
+				truncateFile(fd, 0);
+			}
+			else {
+				std::cerr << "[journal] " << error << "\n";
+			}
+		}
+		lock.lock();
+	}
+}
+
+bool Journal::writeSnapshot(const std::string& image, std::string& error) {
+	// Write next to the target and rename so a crash never leaves a partial snapshot
+	std::string snapshotPath = path + ".snap";
+	std::string tempPath = snapshotPath + ".tmp";
+	int snapshotFd = -1;
+#ifdef _WIN32
+	snapshotFd = _open(tempPath.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+	snapshotFd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+#endif
+	if (snapshotFd < 0) {
+		error = "cannot write " + tempPath;
+		return false;
+	}
+	bool written = writeAll(snapshotFd, image) && syncFile(snapshotFd);
+	closeLog(snapshotFd);
+	if (!written) {
+		error = "cannot write " + tempPath;
+		return false;
+	}
+	std::error_code ec;
+	std::filesystem::rename(tempPath, snapshotPath, ec);
+	if (ec) {
+		error = "cannot replace " + snapshotPath + ": " + ec.message();
+		return false;
+	}
+	return true;
+}
+
+std::unique_ptr<JournalSession> Journal::begin(const std::string& name, int hitPoints, int attack, int defense) {
+	uint32_t game;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		game = nextGame++;
+		attached.insert(game);
+	}
+	JournalRecord record{ RecordType::BEGIN, game, { hitPoints, attack, defense }, name.substr(0, MAX_TEXT) };
+	append(record);
+	return std::make_unique<JournalSession>(*this, game);
+}
+
+std::unique_ptr<JournalSession> Journal::resume(const std::string& name, SavedGame& saved) {
+	std::lock_guard<std::mutex> lock(mutex);
+	// Newest game of the player that nobody is playing right now
+	uint32_t found = 0;
+	for (const auto& [id, game] : games) {
+		if (game.name == name && id > found && !attached.count(id)) {
+			found = id;
+		}
+	}
+	if (found == 0) {
+		return nullptr;
+	}
+	attached.insert(found);
+	saved = games[found];
+	return std::make_unique<JournalSession>(*this, found);
+}
+
+uint64_t Journal::append(const JournalRecord& record) {
+	bool wasIdle;
+	uint64_t sequence;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		sequence = nextSequence++;
+		applyRecord(games, record);
+		if (failed) return sequence;
+		size_t before = pending.size();
+		wasIdle = before == 0;
+		encodeRecord(pending, sequence, record);
+		logBytes += pending.size() - before;
+	}
+	if (wasIdle) {
+		wakeFlusher.notify_one();
+	}
+	return sequence;
+}
+
+bool Journal::isDurable(uint64_t sequence) const {
+	return durableSequence.load(std::memory_order_acquire) >= sequence;
+}
+
+void Journal::waitDurable(uint64_t sequence) const {
+	uint64_t durable = durableSequence.load(std::memory_order_acquire);
+	while (durable < sequence) {
+		durableSequence.wait(durable, std::memory_order_acquire);
+		durable = durableSequence.load(std::memory_order_acquire);
+	}
+}
+
+size_t Journal::unfinishedGames() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return games.size();
+}
+
+uint64_t Journal::commitCount() const {
+	return commits.load(std::memory_order_relaxed);
+}
+
+void Journal::detach(uint32_t game) {
+	std::lock_guard<std::mutex> lock(mutex);
+	attached.erase(game);
+}
+
+// JournalSession implementation
+JournalSession::JournalSession(Journal& owner, uint32_t gameId)
+	: journal(owner), game(gameId) {
+}
+
+JournalSession::~JournalSession() {
+	journal.detach(game);
+}
+
+void JournalSession::record(RecordType type, int32_t a, int32_t b, int32_t c, const std::string& text) {
+	lastSequence = journal.append(JournalRecord{ type, game, { a, b, c }, text.substr(0, MAX_TEXT) });
+}
+
+void JournalSession::recordScene(int sceneNumber) {
+	record(RecordType::SCENE, sceneNumber);
+}
+
+void JournalSession::recordChoice(int sceneNumber, size_t choiceIndex) {
+	record(RecordType::CHOICE, sceneNumber, static_cast<int32_t>(choiceIndex));
+}
+
+void JournalSession::recordRoll(int die, int result) {
+	record(RecordType::ROLL, die, result);
+}
+
+void JournalSession::recordPlayerHitPoints(int hitPoints) {
+	record(RecordType::PLAYER_HP, hitPoints);
+}
+
+void JournalSession::recordCombatantHitPoints(size_t index, int hitPoints) {
+	record(RecordType::COMBATANT_HP, static_cast<int32_t>(index), hitPoints);
+}
+
+void JournalSession::recordItemGained(ItemKind kind, const std::string& name, int value) {
+	record(RecordType::ITEM_GAINED, static_cast<int32_t>(kind), value, 0, name);
+}
+
+void JournalSession::recordItemRemoved(ItemKind kind, size_t index) {
+	record(RecordType::ITEM_REMOVED, static_cast<int32_t>(kind), static_cast<int32_t>(index));
+}
+
+void JournalSession::recordEquip(ItemKind kind, int index) {
+	record(RecordType::EQUIP, static_cast<int32_t>(kind), index);
+}
+
+void JournalSession::recordLooted() {
+	record(RecordType::LOOTED);
+}
+
+void JournalSession::recordSkill(int skill) {
+	record(RecordType::SKILL, skill);
+}
+
+void JournalSession::recordForget(int first, int last) {
+	record(RecordType::FORGET, first, last);
+}
+
+void JournalSession::recordRestore(const SavedGame& state) {
+	JournalRecord restore{ RecordType::RESTORE, game, { 0, 0, 0 }, {} };
+	Writer writer(restore.text);
+	encodeGameState(writer, state);
+	lastSequence = journal.append(restore);
+}
+
+void JournalSession::recordEnd() {
+	record(RecordType::END);
+}
+
+void JournalSession::sync() {
+	if (!Console::sharesThread()) {
+		journal.waitDurable(lastSequence);
+		return;
+	}
+	while (!journal.isDurable(lastSequence)) {
+		Console::pause(std::chrono::milliseconds(COMMIT_POLL_MS));
+	}
+}
\ No newline at end of file
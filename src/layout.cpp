@@ -0,0 +1,170 @@
+#include "layout.h"
+#include <algorithm>
+#include <atomic>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::atomic<size_t> processWidth{ 0 };
+
+struct ThreadWidth {
+	bool hasOwnWidth = false;
+	size_t columns = 0;
+};
+
+thread_local ThreadWidth threadWidth;
+
+bool isSpace(char c) {
+	return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+}
+
+/**
+ * @brief Byte length of the first columns code points of text
+ */
+size_t prefixBytes(std::string_view text, size_t columns) {
+	size_t bytes = 0;
+	while (bytes < text.size()) {
+		if ((static_cast<unsigned char>(text[bytes]) & 0xC0) != 0x80) {
+			if (columns == 0) break;
+			columns--;
+		}
+		bytes++;
+	}
+	return bytes;
+}
+
+bool fits(std::string_view paragraph, size_t width) {
+	size_t start = 0;
+	while (start <= paragraph.size()) {
+		size_t end = paragraph.find('\n', start);
+		if (end == std::string_view::npos) end = paragraph.size();
+		if (Layout::displayWidth(paragraph.substr(start, end - start)) > width) {
+			return false;
+		}
+		start = end + 1;
+	}
+	return true;
+}
+
+void reflow(std::string& out, std::string_view paragraph, size_t width, size_t indent) {
+	size_t column = 0;
+	bool lineEmpty = true;
+	auto newLine = [&] {
+		out += '\n';
+		out.append(indent, ' ');
+		column = indent;
+		lineEmpty = true;
+	};
+
+	size_t pos = 0;
+	while (pos < paragraph.size()) {
+		if (isSpace(paragraph[pos])) {
+			pos++;
+			continue;
+		}
+		size_t end = pos;
+		while (end < paragraph.size() && !isSpace(paragraph[end])) end++;
+		std::string_view word = paragraph.substr(pos, end - pos);
+		pos = end;
+
+		size_t wordWidth = Layout::displayWidth(word);
+		if (!lineEmpty && column + 1 + wordWidth > width) {
+			newLine();
+		}
+		if (!lineEmpty) {
+			out += ' ';
+			column++;
+		}
+		// Split words that do not fit on a line of their own
+		while (column + wordWidth > width) {
+			size_t room = width - column;
+			size_t bytes = prefixBytes(word, room);
+			out.append(word.substr(0, bytes));
+			word.remove_prefix(bytes);
+			wordWidth -= room;
+			newLine();
+		}
+		out.append(word);
+		column += wordWidth;
+		lineEmpty = false;
+	}
+}
+
+} // namespace
+
+void Layout::setWidth(size_t columns) {
+	processWidth.store(columns, std::memory_order_relaxed);
+}
+
+void Layout::setThreadWidth(size_t columns) {
+	threadWidth.hasOwnWidth = true;
+	threadWidth.columns = columns;
+}
+
+size_t Layout::width() {
+	return threadWidth.hasOwnWidth ? threadWidth.columns : processWidth.load(std::memory_order_relaxed);
+}
+
+size_t Layout::terminalWidth() {
+#ifdef _WIN32
+	CONSOLE_SCREEN_BUFFER_INFO info;
+	if (GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info)) {
+		return static_cast<size_t>(info.srWindow.Right - info.srWindow.Left + 1);
+	}
+#else
+	winsize size{};
+	if (isatty(STDOUT_FILENO) && ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0) {
+		return size.ws_col;
+	}
+#endif
+	return 0;
+}
+
+size_t Layout::displayWidth(std::string_view text) {
+	size_t columns = 0;
+	for (char c : text) {
+		// Count every byte except UTF-8 continuation bytes
+		if ((static_cast<unsigned char>(c) & 0xC0) != 0x80) {
+			columns++;
+		}
+	}
+	return columns;
+}
+
+void Layout::wrap(std::string& out, std::string_view text, size_t width, size_t indent) {
+	if (width == 0) {
+		out.append(text);
+		return;
+	}
+	if (indent * 2 > width) {
+		indent = 0;
+	}
+
+	size_t start = 0;
+	while (true) {
+		size_t end = text.find("\n\n", start);
+		if (end == std::string_view::npos) end = text.size();
+		std::string_view paragraph = text.substr(start, end - start);
+		if (fits(paragraph, width)) {
+			out.append(paragraph);
+		}
+		else {
+			reflow(out, paragraph, width, indent);
+		}
+		if (end == text.size()) break;
+		out += "\n\n";
+		start = end + 2;
+	}
+}
+
+void LayoutCache::clear() {
+	entries.clear();
+}
\ No newline at end of file
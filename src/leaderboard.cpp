@@ -0,0 +1,180 @@
+#include "leaderboard.h"
+#include <algorithm>
+#include <iterator>
+#include <thread>
+
+namespace {
+
+/**
+ * @brief Sort key of a score; fewer turns and potions rank higher, more hit points do
+ */
+int64_t keyOf(LeaderboardCategory category, int value) {
+	return category == LeaderboardCategory::MOST_HIT_POINTS ? -static_cast<int64_t>(value) : value;
+}
+
+} // namespace
+
+Leaderboard::Leaderboard() {
+	for (Board& board : boards) {
+		board.ranking.store(new Ranking());
+	}
+}
+
+Leaderboard::~Leaderboard() {
+	for (Board& board : boards) {
+		delete board.ranking.load();
+	}
+}
+
+size_t Leaderboard::shardOfThread() {
+	// Threads take shards in turn; thread ids are addresses and would mostly land in the same shard
+	static std::atomic<size_t> nextShard{ 0 };
+	thread_local size_t shard = nextShard.fetch_add(1) % SHARDS;
+	return shard;
+}
+
+LeaderboardEntry Leaderboard::submit(LeaderboardCategory category, const std::string& player, int value) {
+	LeaderboardEntry entry{ keyOf(category, value), 0, player, value };
+	Board& board = boards[static_cast<size_t>(category)];
+	bool full;
+	{
+		Shard& shard = board.shards[shardOfThread()];
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		// Numbered under the shard lock, so a shard never gains an entry older than one a merge covered
+		entry.seq = nextSeq.fetch_add(1);
+		shard.pending.push_back(entry);
+		full = shard.pending.size() >= MERGE_THRESHOLD;
+	}
+	if (full) {
+		merge(board);
+	}
+	return entry;
+}
+
+void Leaderboard::merge(Board& board) {
+	std::unique_lock<std::mutex> mergeLock(board.mergeMutex, std::try_to_lock);
+	if (!mergeLock.owns_lock()) {
+		return;   // Another session is merging and will pick these entries up
+	}
+
+	const Ranking* current = board.ranking.load();
+	auto next = std::make_unique<Ranking>(*current);
+	Run fresh;
+	for (size_t i = 0; i < SHARDS; ++i) {
+		Shard& shard = board.shards[i];
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		for (const LeaderboardEntry& entry : shard.pending) {
+			if (entry.seq > current->covered[i]) {
+				fresh.push_back(entry);
+				next->covered[i] = std::max(next->covered[i], entry.seq);
+			}
+		}
+	}
+	std::sort(fresh.begin(), fresh.end());
+	next->size += fresh.size();
+
+	// Runs at least half as large as the one before them are combined, so there are O(log n) runs
+	while (!next->runs.empty() && next->runs.back()->size() <= fresh.size() * 2) {
+		Run combined;
+		combined.reserve(next->runs.back()->size() + fresh.size());
+		std::merge(next->runs.back()->begin(), next->runs.back()->end(), fresh.begin(), fresh.end(), std::back_inserter(combined));
+		fresh = std::move(combined);
+		next->runs.pop_back();
+	}
+	next->runs.push_back(std::make_shared<const Run>(std::move(fresh)));
+
+	const Ranking* published = next.release();
+	board.ranking.store(published);
+	for (size_t i = 0; i < SHARDS; ++i) {
+		Shard& shard = board.shards[i];
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		std::erase_if(shard.pending, [&](const LeaderboardEntry& entry) { return entry.seq <= published->covered[i]; });
+	}
+
+	// Readers that start from now on find the new ranking; wait for those that may still hold the old one
+	uint64_t retired = board.epoch.fetch_add(1);
+	while (board.readers[retired & 1].load() != 0) {
+		std::this_thread::yield();
+	}
+	delete current;
+}
+
+template <typename Fn>
+void Leaderboard::read(const Board& board, Fn&& fn) const {
+	uint64_t epoch;
+	while (true) {
+		epoch = board.epoch.load();
+		board.readers[epoch & 1].fetch_add(1);
+		if (board.epoch.load() == epoch) {
+			break;
+		}
+		board.readers[epoch & 1].fetch_sub(1);   // A merge may already have waited for this parity
+	}
+
+	while (true) {
+		const Ranking* ranking = board.ranking.load();
+		auto forEachUncovered = [&](auto&& visit) {
+			for (size_t i = 0; i < SHARDS; ++i) {
+				const Shard& shard = board.shards[i];
+				std::lock_guard<std::mutex> lock(shard.mutex);
+				for (const LeaderboardEntry& entry : shard.pending) {
+					if (entry.seq > ranking->covered[i]) {
+						visit(entry);
+					}
+				}
+			}
+		};
+		fn(*ranking, forEachUncovered);
+		// A merge in between may have pruned entries this ranking does not cover
+		if (board.ranking.load() == ranking) {
+			break;
+		}
+	}
+	board.readers[epoch & 1].fetch_sub(1);
+}
+
+std::vector<LeaderboardEntry> Leaderboard::top(LeaderboardCategory category, size_t count) const {
+	std::vector<LeaderboardEntry> best;
+	auto keepBest = [&](size_t limit) {
+		size_t kept = std::min(best.size(), limit);
+		std::partial_sort(best.begin(), best.begin() + static_cast<std::ptrdiff_t>(kept), best.end());
+		best.resize(kept);
+	};
+	read(boards[static_cast<size_t>(category)], [&](const Ranking& ranking, auto&& forEachUncovered) {
+		best.clear();
+		for (const auto& run : ranking.runs) {
+			best.insert(best.end(), run->begin(), run->begin() + static_cast<std::ptrdiff_t>(std::min(run->size(), count)));
+		}
+		forEachUncovered([&](const LeaderboardEntry& entry) {
+			best.push_back(entry);
+			if (best.size() >= count * 2 + 64) {
+				keepBest(count);   // Bounds the copies when many entries are not merged yet
+			}
+		});
+	});
+	keepBest(count);
+	return best;
+}
+
+size_t Leaderboard::rank(LeaderboardCategory category, const LeaderboardEntry& entry) const {
+	size_t better = 0;
+	read(boards[static_cast<size_t>(category)], [&](const Ranking& ranking, auto&& forEachUncovered) {
+		better = 0;
+		for (const auto& run : ranking.runs) {
+			better += static_cast<size_t>(std::lower_bound(run->begin(), run->end(), entry) - run->begin());
+		}
+		forEachUncovered([&](const LeaderboardEntry& other) {
+			if (other < entry) better++;
+		});
+	});
+	return better + 1;
+}
+
+size_t Leaderboard::size(LeaderboardCategory category) const {
+	size_t total = 0;
+	read(boards[static_cast<size_t>(category)], [&](const Ranking& ranking, auto&& forEachUncovered) {
+		total = ranking.size;
+		forEachUncovered([&](const LeaderboardEntry&) { total++; });
+	});
+	return total;
+}
\ No newline at end of file
@@ -0,0 +1,410 @@
+#include "loadgen.h"
+#include <iostream>
+
+#ifdef __linux__
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <string_view>
+#include <tuple>
+#include <vector>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "server.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t READ_CHUNK_SIZE = 16 * 1024;
+constexpr int MAX_EVENTS = 256;
+constexpr int COMMAND_PERCENT = 10;   // Answers given as a command word where menus accept them
+constexpr const char* COMMANDS[] = { "status", "inv", "drink 1" };
+
+/**
+ * @brief One simulated player and its current connection
+ */
+struct Client {
+	size_t id = 0;
+	int fd = -1;
+	uint64_t generation = 0;   // Bumped on every connection, so think timers of a finished game are dropped
+	std::string output;        // Received since the last answer
+	bool named = false;        // The name prompt of this game was answered
+	bool answered = false;     // An answer waits for the next prompt
+	Clock::time_point answeredAt;
+};
+
+/**
+ * @brief What happened during one step of the load test
+ */
+struct StepStats {
+	std::vector<uint32_t> latencies;   // Microseconds per turn
+	size_t games = 0;
+	size_t failures = 0;               // Connections refused or dropped before the first prompt
+};
+
+/**
+ * @brief Memory of a process in bytes, 0 if unknown
+ *
+ * Proportional set size where the kernel reports it, so pages shared with
+ * other processes are only counted in part; resident size otherwise.
+ */
+size_t processBytes(pid_t pid) {
+	std::string proc = "/proc/" + std::to_string(pid);
+	std::ifstream rollup(proc + "/smaps_rollup");
+	std::string field;
+	size_t kilobytes = 0;
+	while (rollup >> field) {
+		if (field == "Pss:" && rollup >> kilobytes) {
+			return kilobytes * 1024;
+		}
+	}
+	std::ifstream statm(proc + "/statm");
+	size_t pages = 0;
+	size_t resident = 0;
+	if (!(statm >> pages >> resident)) {
+		return 0;
+	}
+	return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+/**
+ * @brief Memory of a server process and its worker processes in bytes, 0 if unknown
+ */
+size_t serverBytes(pid_t server) {
+	size_t total = processBytes(server);
+	if (total == 0) {
+		return 0;
+	}
+	std::error_code error;
+	for (const auto& entry : std::filesystem::directory_iterator("/proc", error)) {
+		std::ifstream statFile(entry.path() / "stat");
+		std::string stat;
+		std::getline(statFile, stat);
+		// pid (name) state ppid ...; the name may itself contain spaces and parentheses
+		size_t nameEnd = stat.rfind(')');
+		if (nameEnd == std::string::npos) continue;
+		char state;
+		long parent = 0;
+		std::istringstream rest(stat.substr(nameEnd + 1));
+		if (rest >> state >> parent && parent == server) {
+			total += processBytes(static_cast<pid_t>(std::stol(entry.path().filename().string())));
+		}
+	}
+	return total;
+}
+
+/**
+ * @brief Process at the other end of a unix socket, 0 for other sockets
+ */
+pid_t peerProcess(int fd) {
+	ucred credentials{};
+	socklen_t length = sizeof(credentials);
+	if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &length) != 0) {
+		return 0;
+	}
+	return credentials.pid;
+}
+
+/**
+ * @brief Picks an answer among the options a prompt offers
+ *
+ * Only reads numbers, so it works whatever language the server speaks: a
+ * range such as (1-4) in the prompt line, numbered lines such as "2. ..."
+ * above it and any other number of the prompt line, such as the 0 of
+ * "0 to cancel". Menus whose prompt has no such number take command words
+ * as well, which are sometimes sent instead.
+ */
+std::string chooseAnswer(const std::string& output, std::mt19937& rng) {
+	size_t promptStart = output.find_last_of('\n');
+	promptStart = promptStart == std::string::npos ? 0 : promptStart + 1;
+	std::string_view prompt = std::string_view(output).substr(promptStart);
+
+	std::vector<long> options;
+	for (size_t line = 0; line < promptStart;) {
+		size_t end = output.find('\n', line);
+		size_t i = output.find_first_not_of(' ', line);
+		size_t digits = i;
+		while (digits < end && std::isdigit(static_cast<unsigned char>(output[digits]))) digits++;
+		if (digits > i && digits < end && output[digits] == '.') {
+			options.push_back(std::stol(output.substr(i, digits - i)));
+		}
+		line = end + 1;
+	}
+
+	bool promptNumbers = false;
+	for (size_t i = 0; i < prompt.size();) {
+		if (!std::isdigit(static_cast<unsigned char>(prompt[i]))) {
+			i++;
+			continue;
+		}
+		size_t end = i;
+		while (end < prompt.size() && std::isdigit(static_cast<unsigned char>(prompt[end]))) end++;
+		long first = std::stol(std::string(prompt.substr(i, end - i)));
+		long last = first;
+		if (end + 1 < prompt.size() && prompt[end] == '-' && std::isdigit(static_cast<unsigned char>(prompt[end + 1]))) {
+			size_t rangeEnd = end + 1;
+			while (rangeEnd < prompt.size() && std::isdigit(static_cast<unsigned char>(prompt[rangeEnd]))) rangeEnd++;
+			last = std::stol(std::string(prompt.substr(end + 1, rangeEnd - end - 1)));
+			end = rangeEnd;
+			options.clear();   // The range is the whole set of options
+		}
+		else {
+			promptNumbers = true;
+		}
+		for (long option = first; option <= last; ++option) {
+			options.push_back(option);
+		}
+		i = end;
+	}
+
+	if (!promptNumbers && std::uniform_int_distribution<int>(1, 100)(rng) <= COMMAND_PERCENT) {
+		return COMMANDS[std::uniform_int_distribution<size_t>(0, std::size(COMMANDS) - 1)(rng)];
+	}
+	if (options.empty()) {
+		return "1";
+	}
+	return std::to_string(options[std::uniform_int_distribution<size_t>(0, options.size() - 1)(rng)]);
+}
+
+uint32_t percentile(std::vector<uint32_t>& values, double fraction) {
+	if (values.empty()) {
+		return 0;
+	}
+	size_t index = std::min(values.size() - 1, static_cast<size_t>(std::ceil(fraction * static_cast<double>(values.size()))) - 1);
+	std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(index), values.end());
+	return values[index];
+}
+
+/**
+ * @brief Drives every client with one epoll loop and a heap of think timers
+ */
+class LoadDriver {
+private:
+	using Timer = std::tuple<Clock::time_point, uint64_t, Client*>;
+
+	const LoadConfig& config;
+	int epollFd = -1;
+	std::vector<std::unique_ptr<Client>> clients;
+	std::priority_queue<Timer, std::vector<Timer>, std::greater<>> timers;
+	std::mt19937 rng{ std::random_device{}() };
+	StepStats stats;
+	Clock::time_point stepStart;
+
+	void connect(Client& client) {
+		std::string error;
+		client.fd = connectToServer(config.address, error);
+		client.generation++;
+		client.output.clear();
+		client.named = false;
+		client.answered = false;
+		if (client.fd < 0) {
+			stats.failures++;
+			return;
+		}
+		fcntl(client.fd, F_SETFL, fcntl(client.fd, F_GETFL) | O_NONBLOCK);
+		epoll_event event{};
+		event.events = EPOLLIN;
+		event.data.ptr = &client;
+		epoll_ctl(epollFd, EPOLL_CTL_ADD, client.fd, &event);
+	}
+
+	void disconnect(Client& client) {
+		if (client.fd >= 0) {
+			close(client.fd);
+			client.fd = -1;
+		}
+	}
+
+	void answer(Client& client) {
+		std::string line = client.named ? chooseAnswer(client.output, rng) : "load" + std::to_string(client.id);
+		line += '\n';
+		client.named = true;
+		client.output.clear();
+		client.answered = true;
+		client.answeredAt = Clock::now();
+		if (send(client.fd, line.data(), line.size(), MSG_NOSIGNAL) < 0) {
+			disconnect(client);
+			connect(client);
+		}
+	}
+
+	void receive(Client& client) {
+		char buffer[READ_CHUNK_SIZE];
+		while (true) {
+			ssize_t count = read(client.fd, buffer, sizeof(buffer));
+			if (count > 0) {
+				client.output.append(buffer, static_cast<size_t>(count));
+				continue;
+			}
+			if (count < 0 && errno == EINTR) {
+				continue;
+			}
+			if (count < 0 && errno == EAGAIN) {
+				break;
+			}
+			// The server ends the connection with the game
+			if (client.named) stats.games++;
+			else stats.failures++;
+			disconnect(client);
+			connect(client);
+			return;
+		}
+
+		// Prompts are the only output that stops after a space instead of a line break
+		if (client.output.empty() || client.output.back() != ' ') {
+			return;
+		}
+		auto now = Clock::now();
+		if (client.answered && client.answeredAt >= stepStart) {
+			stats.latencies.push_back(static_cast<uint32_t>(
+				std::chrono::duration_cast<std::chrono::microseconds>(now - client.answeredAt).count()));
+		}
+		client.answered = false;
+		auto think = std::chrono::duration_cast<Clock::duration>(config.thinkTime * std::uniform_real_distribution<double>(0.5, 1.5)(rng));
+		timers.emplace(now + think, client.generation, &client);
+	}
+
+public:
+	explicit LoadDriver(const LoadConfig& loadConfig) : config(loadConfig) {
+		epollFd = epoll_create1(EPOLL_CLOEXEC);
+	}
+
+	~LoadDriver() {
+		for (auto& client : clients) {
+			disconnect(*client);
+		}
+		close(epollFd);
+	}
+
+	// Delete Copy Constructor - prevent copying
+	LoadDriver(const LoadDriver&) = delete;
+
+	// Delete Copy Assignment Operator - prevent assignment
+	LoadDriver& operator=(const LoadDriver&) = delete;
+
+	/**
+	 * @brief Grows to a number of clients and measures them for one step
+	 */
+	StepStats runStep(size_t clientCount) {
+		stats = StepStats();
+		for (auto& client : clients) {
+			if (client->fd < 0) {
+				connect(*client);   // Refused last time
+			}
+		}
+		while (clients.size() < clientCount) {
+			clients.push_back(std::make_unique<Client>());
+			clients.back()->id = clients.size();
+			connect(*clients.back());
+		}
+
+		stepStart = Clock::now();
+		auto stepEnd = stepStart + config.stepDuration;
+		epoll_event events[MAX_EVENTS];
+		for (auto now = stepStart; now < stepEnd; now = Clock::now()) {
+			while (!timers.empty() && std::get<0>(timers.top()) <= now) {
+				auto [due, generation, client] = timers.top();
+				timers.pop();
+				if (client->generation == generation && client->fd >= 0) {
+					answer(*client);
+				}
+			}
+			auto until = timers.empty() ? stepEnd : std::min(stepEnd, std::get<0>(timers.top()));
+			int timeout = static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(until - now).count());
+			int count = epoll_wait(epollFd, events, MAX_EVENTS, std::max(0, timeout));
+			for (int i = 0; i < count; ++i) {
+				auto* client = static_cast<Client*>(events[i].data.ptr);
+				if (client->fd >= 0) {
+					receive(*client);
+				}
+			}
+		}
+		return std::move(stats);
+	}
+};
+
+} // namespace
+
+int runLoad(const LoadConfig& config) {
+	// Every client is a descriptor; allow as many as the hard limit permits
+	rlimit limit;
+	if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+		limit.rlim_cur = limit.rlim_max;
+		setrlimit(RLIMIT_NOFILE, &limit);
+	}
+
+	// One probe connection checks the server is up and finds its process for memory readings;
+	// with worker processes, that is the supervising process, and its workers are counted too
+	std::string error;
+	int probe = connectToServer(config.address, error);
+	if (probe < 0) {
+		std::cout << "Could not connect to " << config.address << ": " << error << "\n";
+		return 1;
+	}
+	pid_t serverPid = peerProcess(probe);
+	close(probe);
+	size_t baseline = serverPid > 0 ? serverBytes(serverPid) : 0;
+
+	std::cout << "Load test of " << config.address << ": up to " << config.clients << " clients, "
+		<< config.thinkTime.count() << " ms think time, " << config.stepDuration.count() << " s per step\n"
+		<< "Turn latency runs from an answer to the next prompt and includes the game's pacing pauses\n\n"
+		<< " Clients   Turns/s    p50 ms    p99 ms  p99.9 ms     Games  Failures  KB/session\n";
+
+	LoadDriver driver(config);
+	bool overBudget = false;
+	for (size_t clients = 1;; clients = std::min(clients * 2, config.clients)) {
+		StepStats step = driver.runStep(clients);
+		size_t turns = step.latencies.size();
+		double p50 = percentile(step.latencies, 0.5) / 1000.0;
+		double p99 = percentile(step.latencies, 0.99) / 1000.0;
+		double p999 = percentile(step.latencies, 0.999) / 1000.0;
+		std::cout << std::fixed << std::setprecision(1)
+			<< std::setw(8) << clients
+			<< std::setw(10) << static_cast<double>(turns) / static_cast<double>(config.stepDuration.count())
+			<< std::setw(10) << p50 << std::setw(10) << p99 << std::setw(10) << p999
+			<< std::setw(10) << step.games << std::setw(10) << step.failures;
+		size_t used = serverPid > 0 ? serverBytes(serverPid) : 0;
+		if (used > 0) {
+			std::cout << std::setw(12) << static_cast<double>(used > baseline ? used - baseline : 0) / 1024.0 / static_cast<double>(clients);
+		}
+		else {
+			std::cout << std::setw(12) << "-";
+		}
+		std::cout << std::endl;
+
+		if (config.latencyBudget > 0 && p99 > config.latencyBudget) {
+			overBudget = true;
+		}
+		if (clients >= config.clients) {
+			break;
+		}
+	}
+
+	if (overBudget) {
+		std::cout << "\np99 turn latency went over the budget of " << config.latencyBudget << " ms\n";
+		return 1;
+	}
+	return 0;
+}
+
+#else
+
+int runLoad(const LoadConfig&) {
+	std::cerr << "Load testing is only available on Linux\n";
+	return 1;
+}
+
+#endif
\ No newline at end of file
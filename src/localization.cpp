@@ -0,0 +1,387 @@
+#include "localization.h"
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char MAGIC[4] = { 'L', 'W', 'S', 'T' };
+constexpr uint32_t FORMAT_VERSION = 1;
+
+struct Header {
+	char magic[4];
+	uint32_t version;
+	uint32_t count;
+	uint32_t schema;
+};
+
+constexpr std::string_view ENGLISH[] = {
+#define LONEWOLF_STRING_TEXT(id, text) text,
+	LONEWOLF_STRINGS(LONEWOLF_STRING_TEXT)
+#undef LONEWOLF_STRING_TEXT
+};
+
+constexpr std::string_view KEYS[] = {
+#define LONEWOLF_STRING_KEY(id, text) #id,
+	LONEWOLF_STRINGS(LONEWOLF_STRING_KEY)
+#undef LONEWOLF_STRING_KEY
+};
+
+constexpr size_t STRING_COUNT = static_cast<size_t>(StringID::COUNT);
+
+/**
+ * @brief FNV-1a hash of all string ID names, so tables compiled for another
+ * version of the ID list are rejected instead of showing the wrong strings
+ */
+uint32_t schemaHash() {
+	uint32_t hash = 2166136261u;
+	for (std::string_view key : KEYS) {
+		for (char c : key) {
+			hash = (hash ^ static_cast<unsigned char>(c)) * 16777619u;
+		}
+		hash *= 16777619u;   // Separator between names
+	}
+	return hash;
+}
+
+/**
+ * @brief Locale chosen by one thread and the table it resolved to
+ */
+struct ThreadLocale {
+	std::string locale;
+	bool hasOwnLocale = false;
+	uint64_t resolvedGeneration = 0;
+	const StringTable* table = nullptr;
+};
+
+std::mutex tablesMutex;
+std::map<std::string, std::unique_ptr<StringTable>> tables;   // Failed loads are kept as nullptr
+std::string tableDirectory = "locale";
+std::string defaultLocale;
+std::atomic<uint64_t> generation{ 1 };   // Bumped whenever threads must resolve their table again
+
+thread_local ThreadLocale threadLocale;
+
+std::string escape(std::string_view text) {
+	std::string result;
+	for (char c : text) {
+		switch (c) {
+		case '\n': result += "\\n"; break;
+		case '\t': result += "\\t"; break;
+		case '\\': result += "\\\\"; break;
+		case '"': result += "\\\""; break;
+		default: result += c; break;
+		}
+	}
+	return result;
+}
+
+bool unescape(std::string_view quoted, std::string& text) {
+	if (quoted.size() < 2 || quoted.front() != '"' || quoted.back() != '"') {
+		return false;
+	}
+	text.clear();
+	for (size_t i = 1; i + 1 < quoted.size(); ++i) {
+		char c = quoted[i];
+		if (c != '\\') {
+			text += c;
+			continue;
+		}
+		if (++i + 1 >= quoted.size()) return false;
+		switch (quoted[i]) {
+		case 'n': text += '\n'; break;
+		case 't': text += '\t'; break;
+		case '\\': text += '\\'; break;
+		case '"': text += '"'; break;
+		default: return false;
+		}
+	}
+	return true;
+}
+
+std::string_view trim(std::string_view text) {
+	size_t first = text.find_first_not_of(" \t\r");
+	if (first == std::string_view::npos) return {};
+	size_t last = text.find_last_not_of(" \t\r");
+	return text.substr(first, last - first + 1);
+}
+
+} // namespace
+
+StringTable::~StringTable() {
+#ifdef _WIN32
+	if (data) UnmapViewOfFile(data);
+	if (mapping) CloseHandle(mapping);
+#else
+	if (data) munmap(const_cast<char*>(data), size);
+#endif
+}
+
+std::unique_ptr<StringTable> StringTable::open(const std::string& path, std::string& error) {
+	std::unique_ptr<StringTable> table(new StringTable());
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		error = "cannot open " + path;
+		return nullptr;
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(Header))) {
+		CloseHandle(file);
+		error = path + " is not a string table";
+		return nullptr;
+	}
+	table->size = static_cast<size_t>(fileSize.QuadPart);
+	table->mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (!table->mapping) {
+		error = "cannot map " + path;
+		return nullptr;
+	}
+	table->data = static_cast<const char*>(MapViewOfFile(table->mapping, FILE_MAP_READ, 0, 0, 0));
+	if (!table->data) {
+		error = "cannot map " + path;
+		return nullptr;
+	}
+#else
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		error = "cannot open " + path;
+		return nullptr;
+	}
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(Header))) {
+		::close(fd);
+		error = path + " is not a string table";
+		return nullptr;
+	}
+	table->size = static_cast<size_t>(info.st_size);
+	void* address = mmap(nullptr, table->size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (address == MAP_FAILED) {
+		error = "cannot map " + path;
+		return nullptr;
+	}
+	table->data = static_cast<const char*>(address);
+#endif
+
+	Header header;
+	std::memcpy(&header, table->data, sizeof(header));
+	if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != FORMAT_VERSION) {
+		error = path + " is not a string table";
+		return nullptr;
+	}
+	if (header.schema != schemaHash()) {
+		error = path + " was compiled for a different list of strings";
+		return nullptr;
+	}
+	size_t entriesEnd = sizeof(Header) + static_cast<size_t>(header.count) * sizeof(Entry);
+	if (entriesEnd > table->size) {
+		error = path + " is truncated";
+		return nullptr;
+	}
+	table->count = header.count;
+	table->entries = reinterpret_cast<const Entry*>(table->data + sizeof(Header));
+	table->text = table->data + entriesEnd;
+	table->textSize = table->size - entriesEnd;
+
+	// Check every entry once so lookups only need the index check
+	for (uint32_t i = 0; i < table->count; ++i) {
+		const Entry& entry = table->entries[i];
+		if (entry.length != MISSING && static_cast<uint64_t>(entry.offset) + entry.length > table->textSize) {
+			error = path + " has an invalid entry for " + std::string(i < STRING_COUNT ? KEYS[i] : "?");
+			return nullptr;
+		}
+	}
+	return table;
+}
+
+std::string_view StringTable::get(StringID id) const {
+	uint32_t index = static_cast<uint32_t>(id);
+	if (index >= count || entries[index].length == MISSING) {
+		return {};
+	}
+	return std::string_view(text + entries[index].offset, entries[index].length);
+}
+
+void Localization::setDirectory(const std::string& directory) {
+	std::lock_guard<std::mutex> lock(tablesMutex);
+	tableDirectory = directory;
+	generation.fetch_add(1, std::memory_order_release);
+}
+
+void Localization::setLocale(const std::string& locale) {
+	std::lock_guard<std::mutex> lock(tablesMutex);
+	defaultLocale = locale;
+	generation.fetch_add(1, std::memory_order_release);
+}
+
+void Localization::setThreadLocale(const std::string& locale) {
+	threadLocale.locale = locale;
+	threadLocale.hasOwnLocale = !locale.empty();
+	threadLocale.resolvedGeneration = 0;
+}
+
+const StringTable* Localization::table(const std::string& locale) {
+	std::lock_guard<std::mutex> lock(tablesMutex);
+	std::string path = tableDirectory + "/" + locale + ".lwst";
+	auto it = tables.find(path);
+	if (it == tables.end()) {
+		std::string error;
+		it = tables.emplace(path, StringTable::open(path, error)).first;
+		if (!it->second) {
+			std::cerr << "[locale] " << error << ", using English\n";
+		}
+	}
+	return it->second.get();
+}
+
+std::string_view Localization::get(StringID id) {
+	size_t index = static_cast<size_t>(id);
+	if (index >= STRING_COUNT) {
+		return {};
+	}
+
+	// Resolve the thread's table lazily; afterwards a lookup is two array reads
+	ThreadLocale& current = threadLocale;
+	uint64_t latest = generation.load(std::memory_order_acquire);
+	if (current.resolvedGeneration != latest) {
+		std::string locale = current.locale;
+		if (!current.hasOwnLocale) {
+			std::lock_guard<std::mutex> lock(tablesMutex);
+			locale = defaultLocale;
+		}
+		current.table = locale.empty() ? nullptr : table(locale);
+		current.resolvedGeneration = latest;
+	}
+
+	if (current.table) {
+		std::string_view translated = current.table->get(id);
+		if (translated.data()) {
+			return translated;
+		}
+	}
+	return ENGLISH[index];
+}
+
+void Localization::exportSource(std::ostream& out) {
+	out << "# LoneWolf strings. Translate the quoted text; keep {0}..{9} placeholders.\n";
+	out << "# Compile with: --compile-strings <this file> <locale>.lwst\n\n";
+	for (size_t i = 0; i < STRING_COUNT; ++i) {
+		out << KEYS[i] << " = \"" << escape(ENGLISH[i]) << "\"\n";
+	}
+}
+
+bool Localization::compile(const std::string& sourcePath, const std::string& tablePath, std::string& error) {
+	std::ifstream source(sourcePath);
+	if (!source) {
+		error = "cannot open " + sourcePath;
+		return false;
+	}
+
+	std::map<std::string_view, size_t> indexByKey;
+	for (size_t i = 0; i < STRING_COUNT; ++i) {
+		indexByKey[KEYS[i]] = i;
+	}
+
+	std::vector<std::string> translations(STRING_COUNT);
+	std::vector<bool> present(STRING_COUNT, false);
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(source, line)) {
+		lineNumber++;
+		std::string_view content = trim(line);
+		if (content.empty() || content.front() == '#') {
+			continue;
+		}
+		size_t equals = content.find('=');
+		auto where = [&] { return sourcePath + ":" + std::to_string(lineNumber) + ": "; };
+		if (equals == std::string_view::npos) {
+			error = where() + "expected KEY = \"text\"";
+			return false;
+		}
+		auto key = indexByKey.find(trim(content.substr(0, equals)));
+		if (key == indexByKey.end()) {
+			error = where() + "unknown string " + std::string(trim(content.substr(0, equals)));
+			return false;
+		}
+		if (present[key->second]) {
+			error = where() + "string " + std::string(key->first) + " is defined twice";
+			return false;
+		}
+		if (!unescape(trim(content.substr(equals + 1)), translations[key->second])) {
+			error = where() + "text must be quoted and may only use \\n, \\t, \\\\ and \\\" escapes";
+			return false;
+		}
+		present[key->second] = true;
+	}
+
+	Header header;
+	std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version = FORMAT_VERSION;
+	header.count = static_cast<uint32_t>(STRING_COUNT);
+	header.schema = schemaHash();
+
+	std::vector<uint32_t> entries;
+	std::string text;
+	for (size_t i = 0; i < STRING_COUNT; ++i) {
+		entries.push_back(static_cast<uint32_t>(text.size()));
+		entries.push_back(present[i] ? static_cast<uint32_t>(translations[i].size()) : StringTable::MISSING);
+		text += translations[i];
+	}
+
+	// Write next to the target and rename so running games never map a partial table
+	std::string tempPath = tablePath + ".tmp";
+	{
+		std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		out.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(uint32_t)));
+		out.write(text.data(), static_cast<std::streamsize>(text.size()));
+		if (!out) {
+			error = "cannot write " + tempPath;
+			return false;
+		}
+	}
+	std::error_code ec;
+	std::filesystem::rename(tempPath, tablePath, ec);
+	if (ec) {
+		error = "cannot write " + tablePath + ": " + ec.message();
+		return false;
+	}
+	return true;
+}
+
+std::string formatText(std::string_view pattern, const std::string* values, size_t count) {
+	std::string result;
+	result.reserve(pattern.size() + 16 * count);
+	for (size_t i = 0; i < pattern.size(); ++i) {
+		if (pattern[i] == '{' && i + 2 < pattern.size() && pattern[i + 2] == '}'
+			&& pattern[i + 1] >= '0' && pattern[i + 1] <= '9') {
+			size_t index = static_cast<size_t>(pattern[i + 1] - '0');
+			if (index < count) {
+				result += values[index];
+				i += 2;
+				continue;
+			}
+		}
+		result += pattern[i];
+	}
+	return result;
+}
\ No newline at end of file
@@ -1,20 +1,375 @@
-﻿#include <string>
+﻿#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
 #include <vector>
 #include "game.h"
 #include "utility.h"
+#include "telemetry.h"
+#include "trace.h"
+#include "memtrack.h"
+#include "storyfile.h"
+#include "localization.h"
+#include "layout.h"
+#include "server.h"
+#include "journal.h"
+#include "combatlog.h"
+#include "presenter.h"
+#include "runstore.h"
+#include "leaderboard.h"
+#include "loadgen.h"
+#include "dice.h"
 
-int main() {
-	std::vector<std::string> text = {
-		"~ Inspired by the Lone Wolf: Flight from the Dark ~",
-		"~ A simplified version of text RPG ~",
+constexpr int METRICS_INTERVAL_SECONDS = 10;
+constexpr size_t DICE_REPORT_ROLLS = 1000000;
+
+namespace {
+
+GameServer* runningServer = nullptr;
+
+void stopServer(int) {
+	runningServer->requestStop();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+	std::string metricsPrefix;
+	std::string tracePath;
+	bool memoryReport = false;
+	int simulateTrials = 0;
+	long long exploreBranches = 0;
+	std::string storyPath;
+	std::string exportPath;
+	std::string locale;
+	std::string stringsExportPath;
+	std::string stringsSourcePath;
+	std::string stringsTablePath;
+	size_t width = Layout::terminalWidth();
+	bool widthGiven = false;
+	ServerConfig serverConfig;
+	std::string connectAddress;
+	std::string journalPath;
+	size_t rewindTurns = 0;
+	std::optional<uint64_t> endlessSeed;
+	std::string combatLogPath;
+	std::string combatLogReadPath;
+	std::string runsPath;
+	std::string reportPath;
+	std::string reportPlayer;
+	LoadConfig loadConfig;
+	std::string diceExpression;
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--metrics" && i + 1 < argc) {
+			metricsPrefix = argv[++i];
+		}
+		else if (arg == "--trace" && i + 1 < argc) {
+			tracePath = argv[++i];
+		}
+		else if (arg == "--mem-report") {
+			memoryReport = true;
+		}
+		else if (arg == "--simulate" && i + 1 < argc) {
+			simulateTrials = std::max(1, std::atoi(argv[++i]));
+		}
+		else if (arg == "--explore" && i + 1 < argc) {
+			exploreBranches = std::max(1LL, std::atoll(argv[++i]));
+		}
+		else if (arg == "--story" && i + 1 < argc) {
+			storyPath = argv[++i];
+		}
+		else if (arg == "--export-story" && i + 1 < argc) {
+			exportPath = argv[++i];
+		}
+		else if (arg == "--locale" && i + 1 < argc) {
+			locale = argv[++i];
+		}
+		else if (arg == "--width" && i + 1 < argc) {
+			width = static_cast<size_t>(std::max(0, std::atoi(argv[++i])));
+			widthGiven = true;
+		}
+		else if (arg == "--locale-dir" && i + 1 < argc) {
+			Localization::setDirectory(argv[++i]);
+		}
+		else if (arg == "--export-strings" && i + 1 < argc) {
+			stringsExportPath = argv[++i];
+		}
+		else if (arg == "--serve" && i + 1 < argc) {
+			serverConfig.address = argv[++i];
+		}
+		else if (arg == "--workers" && i + 1 < argc) {
+			serverConfig.workers = std::max(0, std::atoi(argv[++i]));
+		}
+		else if (arg == "--processes" && i + 1 < argc) {
+			serverConfig.processes = std::max(0, std::atoi(argv[++i]));
+		}
+		else if (arg == "--connect" && i + 1 < argc) {
+			connectAddress = argv[++i];
+		}
+		else if (arg == "--journal" && i + 1 < argc) {
+			journalPath = argv[++i];
+		}
+		else if (arg == "--rewind" && i + 1 < argc) {
+			rewindTurns = static_cast<size_t>(std::max(0, std::atoi(argv[++i])));
+		}
+		else if (arg == "--endless" && i + 1 < argc) {
+			endlessSeed = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else if (arg == "--combat-log" && i + 1 < argc) {
+			combatLogPath = argv[++i];
+		}
+		else if (arg == "--read-combat-log" && i + 1 < argc) {
+			combatLogReadPath = argv[++i];
+		}
+		else if (arg == "--runs" && i + 1 < argc) {
+			runsPath = argv[++i];
+		}
+		else if (arg == "--run-report" && i + 2 < argc) {
+			reportPath = argv[++i];
+			reportPlayer = argv[++i];
+		}
+		else if (arg == "--load" && i + 2 < argc) {
+			loadConfig.address = argv[++i];
+			loadConfig.clients = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+		}
+		else if (arg == "--think" && i + 1 < argc) {
+			loadConfig.thinkTime = std::chrono::milliseconds(std::max(0, std::atoi(argv[++i])));
+		}
+		else if (arg == "--load-step" && i + 1 < argc) {
+			loadConfig.stepDuration = std::chrono::seconds(std::max(1, std::atoi(argv[++i])));
+		}
+		else if (arg == "--load-budget" && i + 1 < argc) {
+			loadConfig.latencyBudget = std::max(0.0, std::atof(argv[++i]));
+		}
+		else if (arg == "--dice" && i + 1 < argc) {
+			diceExpression = argv[++i];
+		}
+		else if (arg == "--compile-strings" && i + 2 < argc) {
+			stringsSourcePath = argv[++i];
+			stringsTablePath = argv[++i];
+		}
+	}
+
+	if (!stringsExportPath.empty()) {
+		std::ofstream out(stringsExportPath);
+		Localization::exportSource(out);
+		if (!out) {
+			std::cout << "Could not write strings file " << stringsExportPath << "\n";
+			return 1;
+		}
+		return 0;
+	}
+	if (!stringsSourcePath.empty()) {
+		std::string error;
+		if (!Localization::compile(stringsSourcePath, stringsTablePath, error)) {
+			std::cout << "Could not compile strings: " << error << "\n";
+			return 1;
+		}
+		return 0;
+	}
+	if (!diceExpression.empty()) {
+		std::string error;
+		if (!printDiceReport(diceExpression, DICE_REPORT_ROLLS, std::cout, error)) {
+			std::cout << "Could not read dice expression: " << error << "\n";
+			return 1;
+		}
+		return 0;
+	}
+	if (!connectAddress.empty()) {
+		return runClient(connectAddress);
+	}
+	if (!loadConfig.address.empty()) {
+		return runLoad(loadConfig);
+	}
+	Localization::setLocale(locale);
+	if (!combatLogReadPath.empty()) {
+		std::string error;
+		if (!CombatLog::summarize(combatLogReadPath, std::cout, error)) {
+			std::cout << "Could not read combat log: " << error << "\n";
+			return 1;
+		}
+		return 0;
+	}
+	Layout::setWidth(width);
+
+	if (!exportPath.empty()) {
+		Game game;
+		game.setStoryline();
+		std::ofstream out(exportPath);
+		writeStory(*game.getStory(), out);
+		if (!out) {
+			std::cout << "Could not write story file " << exportPath << "\n";
+			return 1;
+		}
+		return 0;
+	}
+
+	// Load the story file before starting anything else so a bad file fails fast
+	std::unique_ptr<StoryFile> storyFile;
+	if (!storyPath.empty()) {
+		storyFile = std::make_unique<StoryFile>(storyPath);
+		std::string error;
+		if (!storyFile->reload(error)) {
+			std::cout << "Could not load story " << storyPath << ": " << error << "\n";
+			return 1;
+		}
+	}
+
+	if (!reportPath.empty()) {
+		RunStore store;
+		std::string error;
+		if (!store.open(reportPath, error)) {
+			std::cout << "Could not open run history: " << error << "\n";
+			return 1;
+		}
+		Game game;
+		if (storyFile) {
+			game.setStorySource(storyFile.get());
+		}
+		else {
+			game.setStoryline();
+		}
+		game.reportRuns(store, reportPlayer);
+		return 0;
+	}
+
+
+	// Worker processes fork without the threads started below, and would overwrite each other's files
+	bool forksWorkers = !serverConfig.address.empty() && serverConfig.processes > 0;
+	if (forksWorkers && (!journalPath.empty() || !runsPath.empty() || !combatLogPath.empty()
+		|| !metricsPrefix.empty() || !tracePath.empty())) {
+		std::cout << "--journal, --runs, --combat-log, --metrics and --trace cannot be shared by worker processes\n";
+		return 1;
+	}
+
+	if (!metricsPrefix.empty()) {
+		Telemetry::start(metricsPrefix, std::chrono::seconds(METRICS_INTERVAL_SECONDS));
+	}
+	if (!tracePath.empty() && !Trace::start(tracePath)) {
+		std::cout << "Could not open trace file " << tracePath << "\n";
+	}
+	if (!combatLogPath.empty() && !CombatLog::open(combatLogPath)) {
+		std::cout << "Could not open combat log " << combatLogPath << "\n";
+	}
+
+	if (simulateTrials > 0 || exploreBranches > 0) {
+		Game game;
+		if (storyFile) {
+			game.setStorySource(storyFile.get());
+		}
+		else {
+			game.setStoryline();
+		}
+		if (simulateTrials > 0) {
+			game.simulateEncounters(simulateTrials);
+		}
+		if (exploreBranches > 0) {
+			game.exploreBranches(static_cast<size_t>(exploreBranches));
+		}
+		CombatLog::close();
+		Trace::stop();
+		Telemetry::stop();
+		return 0;
+	}
+
+	// Workers keep the story they forked with; a reload would only reach the supervisor
+	if (storyFile && !forksWorkers) {
+		storyFile->watch();
+	}
+
+	Journal journal;
+	if (!journalPath.empty()) {
+		std::string error;
+		if (!journal.open(journalPath, error)) {
+			std::cout << "Could not open journal: " << error << "\n";
+			return 1;
+		}
+	}
+
+	RunStore runs;
+	if (!runsPath.empty()) {
+		std::string error;
+		if (!runs.open(runsPath, error)) {
+			std::cout << "Could not open run history: " << error << "\n";
+			return 1;
+		}
+	}
+
+	// Sessions of a server are ranked against each other; a local game has nobody to compare with
+	Leaderboard leaderboard;
+	Leaderboard* rankings = serverConfig.address.empty() ? nullptr : &leaderboard;
+
+	auto playGame = [&storyFile, &journal, &journalPath, &runs, &runsPath, rankings, rewindTurns, endlessSeed] {
+		printBorderedText(splitLines(tr(StringID::BANNER)));
+
+		Game game;
+		if (storyFile) {
+			game.setStorySource(storyFile.get());
+		}
+		else {
+			game.setStoryline();
+		}
+		if (!journalPath.empty()) {
+			game.setJournal(&journal);
+		}
+		if (!runsPath.empty()) {
+			game.setRunStore(&runs);
+		}
+		if (rankings) {
+			game.setLeaderboard(rankings);
+		}
+		game.setRewindLimit(rewindTurns);
+		if (endlessSeed) {
+			game.setEndless(*endlessSeed);
+		}
+		game.run();
 	};
 
-	printBorderedText(text);
+	if (!serverConfig.address.empty()) {
+		// The server's terminal says nothing about the clients' screens
+		serverConfig.width = widthGiven ? width : 0;
+		if (serverConfig.processes > 0) {
+			if (!storyFile) {
+				// Built before the workers fork, so they all share its pages
+				Game::builtinStoryline();
+			}
+		}
+		GameServer server(serverConfig, playGame);
+		std::string error;
+		if (!server.start(error)) {
+			std::cout << "Could not start server: " << error << "\n";
+			return 1;
+		}
+		runningServer = &server;
+		std::signal(SIGINT, stopServer);
+		std::signal(SIGTERM, stopServer);
+		server.run();
+		std::signal(SIGINT, SIG_DFL);
+		std::signal(SIGTERM, SIG_DFL);
+		runningServer = nullptr;
+	}
+	else {
+		// The terminal is written and paced on its own thread while the game plays on
+		PresentationHost presenter;
+		Console::setHost(&presenter);
+		playGame();
+		Console::setHost(nullptr);
+	}
 
-	Game game;
-	game.setStoryline();
+	journal.close();
 
-	game.run();
+	if (memoryReport) {
+		MemTracker::report(std::cout);
+	}
 
+	CombatLog::close();
+	Trace::stop();
+	Telemetry::stop();
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <iomanip>
+#include "memtrack.h"
+
+namespace {
+
+constexpr size_t TAG_COUNT = static_cast<size_t>(MemTag::COUNT);
+
+const char* TAG_NAMES[TAG_COUNT] = { "story", "world state", "player", "items", "text" };
+
+#ifdef LONEWOLF_MEMTRACK
+struct TagCounters {
+	std::atomic<int64_t> currentBytes{ 0 };
+	std::atomic<int64_t> peakBytes{ 0 };
+	std::atomic<uint64_t> allocations{ 0 };
+	std::atomic<uint64_t> frees{ 0 };
+};
+
+std::array<TagCounters, TAG_COUNT>& counters() {
+	static std::array<TagCounters, TAG_COUNT> instance;
+	return instance;
+}
+
+bool ownsHeapBuffer(const std::string& text) {
+	// Short strings live inside the object itself and cost nothing extra
+	const char* data = text.data();
+	const char* object = reinterpret_cast<const char*>(&text);
+	return data < object || data >= object + sizeof(std::string);
+}
+#endif
+
+} // namespace
+
+#ifdef LONEWOLF_MEMTRACK
+void MemTracker::recordAlloc(MemTag tag, size_t bytes) {
+	TagCounters& counter = counters()[static_cast<size_t>(tag)];
+	int64_t current = counter.currentBytes.fetch_add(static_cast<int64_t>(bytes), std::memory_order_relaxed)
+		+ static_cast<int64_t>(bytes);
+	counter.allocations.fetch_add(1, std::memory_order_relaxed);
+
+	int64_t peak = counter.peakBytes.load(std::memory_order_relaxed);
+	while (current > peak && !counter.peakBytes.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+	}
+}
+
+void MemTracker::recordFree(MemTag tag, size_t bytes) {
+	TagCounters& counter = counters()[static_cast<size_t>(tag)];
+	counter.currentBytes.fetch_sub(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+	counter.frees.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MemTracker::trackText(const std::string& text) {
+	if (ownsHeapBuffer(text)) {
+		recordAlloc(MemTag::TEXT, text.capacity() + 1);
+	}
+}
+
+void MemTracker::releaseText(const std::string& text) {
+	if (ownsHeapBuffer(text)) {
+		recordFree(MemTag::TEXT, text.capacity() + 1);
+	}
+}
+
+void MemTracker::report(std::ostream& out) {
+	out << "\n- - - Memory Report - - -\n";
+	out << std::left << std::setw(14) << "Subsystem"
+		<< std::right << std::setw(12) << "Current"
+		<< std::setw(12) << "Peak"
+		<< std::setw(10) << "Allocs"
+		<< std::setw(10) << "Frees" << "\n";
+
+	int64_t totalCurrent = 0;
+	int64_t totalPeak = 0;
+	for (size_t i = 0; i < TAG_COUNT; ++i) {
+		const TagCounters& counter = counters()[i];
+		int64_t current = counter.currentBytes.load(std::memory_order_relaxed);
+		int64_t peak = counter.peakBytes.load(std::memory_order_relaxed);
+		totalCurrent += current;
+		totalPeak += peak;
+
+		out << std::left << std::setw(14) << TAG_NAMES[i]
+			<< std::right << std::setw(12) << current
+			<< std::setw(12) << peak
+			<< std::setw(10) << counter.allocations.load(std::memory_order_relaxed)
+			<< std::setw(10) << counter.frees.load(std::memory_order_relaxed) << "\n";
+	}
+	// Peaks of different subsystems may not coincide, so the total peak is an upper bound
+	out << std::left << std::setw(14) << "total"
+		<< std::right << std::setw(12) << totalCurrent
+		<< std::setw(12) << totalPeak << "\n";
+}
+#else
+void MemTracker::report(std::ostream& out) {
+	(void)TAG_NAMES;
+	out << "\nMemory tracking is disabled in release builds.\n";
+}
+#endif
\ No newline at end of file
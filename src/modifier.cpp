@@ -0,0 +1,107 @@
+#include "modifier.h"
+#include <algorithm>
+
+namespace {
+
+constexpr int EXPIRED_ROUNDS = -1;   // Marks an effect whose last round just passed
+
+} // namespace
+
+StatBlock::Entry* StatBlock::find(ModifierID id) {
+	for (Entry& entry : modifiers) {
+		if (entry.id == id) return &entry;
+	}
+	return nullptr;
+}
+
+int StatBlock::getBase(Stat stat) const {
+	return base[static_cast<size_t>(stat)];
+}
+
+void StatBlock::setBase(Stat stat, int value) {
+	base[static_cast<size_t>(stat)] = value;
+	dirty = true;
+}
+
+int StatBlock::get(Stat stat) const {
+	if (dirty) {
+		totals = base;
+		for (const Entry& entry : modifiers) {
+			totals[static_cast<size_t>(entry.modifier.stat)] += entry.modifier.amount;
+		}
+		dirty = false;
+	}
+	return totals[static_cast<size_t>(stat)];
+}
+
+int StatBlock::sum(Stat stat, ModifierSource source) const {
+	int total = 0;
+	for (const Entry& entry : modifiers) {
+		if (entry.modifier.stat == stat && entry.modifier.source == source) {
+			total += entry.modifier.amount;
+		}
+	}
+	return total;
+}
+
+ModifierID StatBlock::add(Modifier modifier) {
+	ModifierID id = nextId++;
+	modifiers.push_back({ id, std::move(modifier) });
+	dirty = true;
+	return id;
+}
+
+void StatBlock::remove(ModifierID id) {
+	auto it = std::find_if(modifiers.begin(), modifiers.end(), [id](const Entry& entry) {
+		return entry.id == id;
+	});
+	if (it != modifiers.end()) {
+		modifiers.erase(it);
+		dirty = true;
+	}
+}
+
+void StatBlock::setAmount(ModifierID id, int amount) {
+	Entry* entry = find(id);
+	if (entry && entry->modifier.amount != amount) {
+		entry->modifier.amount = amount;
+		dirty = true;
+	}
+}
+
+bool StatBlock::tickRounds() {
+	// Effects without a round count last until cleared, so those that ran out are marked apart from them
+	bool expired = false;
+	for (Entry& entry : modifiers) {
+		if (entry.modifier.source == ModifierSource::EFFECT && entry.modifier.rounds > 0
+			&& --entry.modifier.rounds == 0) {
+			entry.modifier.rounds = EXPIRED_ROUNDS;
+			expired = true;
+		}
+	}
+	if (!expired) {
+		return false;
+	}
+	std::erase_if(modifiers, [](const Entry& entry) {
+		return entry.modifier.rounds == EXPIRED_ROUNDS;
+	});
+	dirty = true;
+	return true;
+}
+
+void StatBlock::clearEffects() {
+	size_t before = modifiers.size();
+	std::erase_if(modifiers, [](const Entry& entry) {
+		return entry.modifier.source == ModifierSource::EFFECT;
+	});
+	if (modifiers.size() != before) {
+		dirty = true;
+	}
+}
+
+int skillBonus(uint32_t skills, Stat stat) {
+	if (stat == Stat::ATTACK && (skills & skillBit(Skill::WEAPONSKILL))) {
+		return WEAPONSKILL_BONUS;
+	}
+	return 0;
+}
\ No newline at end of file
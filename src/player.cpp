@@ -1,27 +1,108 @@
 #include <iostream>
+#include <algorithm>
 #include <cassert>
 #include "player.h"
 #include "weapon.h"
 #include "armor.h"
 #include "potion.h"
 #include "utility.h"
-
-Player::Player(const std::string& playerName, int hp, int atk, int def)
-	: name(playerName), hitPoints(hp), maxHitPoints(hp), baseAttack(atk), baseDefense(def) {
+#include "trace.h"
+#include "localization.h"
+#include "console.h"
+#include "journal.h"
+
+namespace {
+
+// Words of the inventory menu; any other verb leaves the menu and goes to the one that opened it
+constexpr CommandVerb INVENTORY_VERBS[] = {
+	{ "status", 1 },
+	{ "equip", 2 },
+	{ "wear", 3 },
+	{ "drink", 4 },
+	{ "drop", 5 },
+	{ "back", 0 },
+	{ "*", 0, VerbUse::FORWARD }
+};
+
+/**
+ * @brief Whether a live inventory holds the same items as a state inventory
+ */
+template <typename Inventory>
+bool sameItems(const Inventory& items, const std::vector<ItemState>& state) {
+	if (items.size() != state.size()) return false;
+	for (size_t i = 0; i < items.size(); ++i) {
+		if (items[i].name.str() != state[i].name || items[i].bonus != state[i].value) return false;
+	}
+	return true;
 }
 
-Player::~Player() {
-	for (Weapon* weapon : weaponInventory) {
-		delete weapon;
+template <typename Inventory>
+void captureItems(const Inventory& items, CowPtr<std::vector<ItemState>>& state) {
+	// Unchanged inventories stay shared with earlier states
+	if (sameItems(items, *state)) return;
+	std::vector<ItemState>& target = state.write();
+	target.clear();
+	for (const CarriedItem& item : items) {
+		target.push_back({ item.name.str(), item.bonus });
 	}
-	for (Armor* armor : armorInventory) {
-		delete armor;
+}
+
+template <typename Inventory>
+void restoreItems(Inventory& items, const std::vector<ItemState>& state) {
+	items.clear();
+	for (const ItemState& item : state) {
+		items.push_back({ ItemName(item.name), item.value });
 	}
-	for (Potion* potion : potionInventory) {
-		delete potion;
+}
+
+/**
+ * @brief Index an equipped index of a state stands for, or Player::NOTHING if out of range
+ */
+template <typename Inventory>
+int16_t equippedIndex(const Inventory& items, int index) {
+	return index >= 0 && static_cast<size_t>(index) < items.size() ? static_cast<int16_t>(index) : Player::NOTHING;
+}
+
+StringID skillName(Skill skill) {
+	switch (skill) {
+	case Skill::WEAPONSKILL:
+		return StringID::SKILL_WEAPONSKILL;
+	case Skill::MINDBLAST:
+		return StringID::SKILL_MINDBLAST;
+	default:
+		return StringID::SKILL_MINDSHIELD;
 	}
 }
 
+/**
+ * @brief Prints the skill and effect modifiers of a stat for the status screen
+ */
+void printModifiers(const StatBlock& stats, Stat stat) {
+	stats.forEach([stat](const Modifier& modifier) {
+		if (modifier.stat != stat || modifier.source == ModifierSource::EQUIPMENT || modifier.amount == 0) return;
+		if (modifier.amount > 0) {
+			Console::out() << tr(StringID::STATUS_BONUS, modifier.amount, modifier.label);
+		}
+		else {
+			Console::out() << tr(StringID::STATUS_PENALTY, -modifier.amount, modifier.label);
+		}
+	});
+}
+
+} // namespace
+
+Player::Player(const std::string& playerName, int hp, int atk, int def)
+	: name(playerName), hitPoints(hp), maxHitPoints(hp) {
+	stats.setBase(Stat::ATTACK, atk);
+	stats.setBase(Stat::DEFENSE, def);
+	weaponModifier = stats.add({ Stat::ATTACK, 0, ModifierSource::EQUIPMENT, {} });
+	armorModifier = stats.add({ Stat::DEFENSE, 0, ModifierSource::EQUIPMENT, {} });
+}
+
+std::string_view Player::getName() const {
+	return name;
+}
+
 int Player::getHitPoints() const {
 	return hitPoints;
 }
@@ -30,157 +111,275 @@ int Player::getMaxHitPoints() const {
 	return maxHitPoints;
 }
 
+int Player::getPotionsUsed() const {
+	return potionsUsed;
+}
+
 int Player::getTotalAttack() const {
-	int total = baseAttack;
-	if (equippedWeapon)
-		total += equippedWeapon->getAttackBonus();
-	return total;
+	return stats.get(Stat::ATTACK);
 }
 
 int Player::getTotalDefense() const {
-	int total = baseDefense;
-	if (equippedArmor)
-		total += equippedArmor->getDefenseBonus();
-	return total;
+	return stats.get(Stat::DEFENSE);
+}
+
+void Player::setEquippedWeapon(int16_t index) {
+	equippedWeapon = index;
+	stats.setAmount(weaponModifier, index != NOTHING ? weaponInventory[index].bonus : 0);
+}
+
+void Player::setEquippedArmor(int16_t index) {
+	equippedArmor = index;
+	stats.setAmount(armorModifier, index != NOTHING ? armorInventory[index].bonus : 0);
+}
+
+void Player::removeItem(Inventory& items, int16_t& equipped, size_t index) {
+	items.erase(index);
+	if (equipped != NOTHING && static_cast<size_t>(equipped) > index) {
+		equipped--;
+	}
+}
+
+void Player::applySkills() {
+	for (size_t i = 0; i < skillModifiers.size(); ++i) {
+		Skill skill = static_cast<Skill>(i);
+		int bonus = skillBonus(skills & skillBit(skill), Stat::ATTACK);
+		if (bonus != 0 && skillModifiers[i] == StatBlock::NONE) {
+			skillModifiers[i] = stats.add({ Stat::ATTACK, bonus, ModifierSource::SKILL, std::string(tr(skillName(skill))) });
+		}
+		else if (bonus == 0 && skillModifiers[i] != StatBlock::NONE) {
+			stats.remove(skillModifiers[i]);
+			skillModifiers[i] = StatBlock::NONE;
+		}
+	}
+}
+
+void Player::learnSkill(Skill skill) {
+	skills |= skillBit(skill);
+	applySkills();
+	if (journal) journal->recordSkill(static_cast<int>(skill));
+	Console::out() << tr(StringID::SKILL_LEARNED, tr(skillName(skill)));
+}
+
+bool Player::hasSkill(Skill skill) const {
+	return (skills & skillBit(skill)) != 0;
 }
 
-void Player::takeDamage(int damage) {
+void Player::addEffect(Stat stat, int amount, const std::string& label, int rounds) {
+	stats.add({ stat, amount, ModifierSource::EFFECT, label, rounds });
+}
+
+void Player::endCombatRound() {
+	stats.tickRounds();
+}
+
+void Player::endCombat() {
+	stats.clearEffects();
+}
+
+int Player::takeDamage(int damage) {
 	int actualDamage = std::max(1, damage - getTotalDefense());
 	hitPoints = std::max(0, hitPoints - actualDamage);
-	std::cout << name << " takes " << actualDamage << " damage! ";
-	std::cout << "Player's HP: " << hitPoints << "/" << maxHitPoints << "\n";
+	if (journal) journal->recordPlayerHitPoints(hitPoints);
+	return actualDamage;
 }
 
 void Player::heal(int amount) {
 	hitPoints = std::min(maxHitPoints, hitPoints + amount);
-	std::cout << name << " heals " << amount << " HP! ";
-	std::cout << "Player's HP: " << hitPoints << "/" << maxHitPoints << "\n";
+	if (journal) journal->recordPlayerHitPoints(hitPoints);
+	Console::publish({ .type = GameEventType::HEALED, .text = std::string(name.view()), .value = amount, .hitPoints = hitPoints, .maxHitPoints = maxHitPoints });
 }
 
 bool Player::isAlive() const {
 	return hitPoints > 0;
 }
 
-void Player::addWeapon(Weapon* weapon) {
-	// Check pointer is valid before using
-	assert(weapon != nullptr);
-	weaponInventory.push_back(weapon);
-	std::cout << " * Added " << weapon->getName() << " to inventory. *\n";
+size_t Player::addWeapon(const Weapon& weapon) {
+	weaponInventory.push_back({ ItemName(weapon.getName()), weapon.getAttackBonus() });
+	if (journal) journal->recordItemGained(ItemKind::WEAPON, weapon.getName(), weapon.getAttackBonus());
+	Console::publish({ .type = GameEventType::ITEM_ADDED, .text = weapon.getName(), .kind = ItemKind::WEAPON });
+	return weaponInventory.size() - 1;
 }
 
-void Player::addArmor(Armor* armor) {
-	assert(armor != nullptr);
-	armorInventory.push_back(armor);
-	std::cout << " * Added " << armor->getName() << " to inventory. *\n";
+size_t Player::addArmor(const Armor& armor) {
+	armorInventory.push_back({ ItemName(armor.getName()), armor.getDefenseBonus() });
+	if (journal) journal->recordItemGained(ItemKind::ARMOR, armor.getName(), armor.getDefenseBonus());
+	Console::publish({ .type = GameEventType::ITEM_ADDED, .text = armor.getName(), .kind = ItemKind::ARMOR });
+	return armorInventory.size() - 1;
 }
 
-void Player::addPotion(Potion* item) {
-	assert(item != nullptr);
-	potionInventory.push_back(item);
-	std::cout << " * Added " << item->getName() << " to inventory. *\n";
+size_t Player::addPotion(const Potion& item) {
+	potionInventory.push_back({ ItemName(item.getName()), item.getHealAmount() });
+	if (journal) journal->recordItemGained(ItemKind::POTION, item.getName(), item.getHealAmount());
+	Console::publish({ .type = GameEventType::ITEM_ADDED, .text = item.getName(), .kind = ItemKind::POTION });
+	return potionInventory.size() - 1;
 }
 
-void Player::equipWeapon(Weapon* weapon) {
-	equippedWeapon = weapon;
-	std::cout << " * Equipped " << weapon->getName() << " as weapon. *\n";
+void Player::equipWeapon(size_t index) {
+	assert(index < weaponInventory.size());
+	setEquippedWeapon(static_cast<int16_t>(index));
+	if (journal) journal->recordEquip(ItemKind::WEAPON, equippedWeapon);
+	Console::publish({ .type = GameEventType::ITEM_EQUIPPED, .text = weaponInventory[index].name.str(), .kind = ItemKind::WEAPON });
 }
 
-void Player::equipArmor(Armor* armor) {
-	equippedArmor = armor;
-	std::cout << " * Equipped " << armor->getName() << " as armor. *\n";
+void Player::equipArmor(size_t index) {
+	assert(index < armorInventory.size());
+	setEquippedArmor(static_cast<int16_t>(index));
+	if (journal) journal->recordEquip(ItemKind::ARMOR, equippedArmor);
+	Console::publish({ .type = GameEventType::ITEM_EQUIPPED, .text = armorInventory[index].name.str(), .kind = ItemKind::ARMOR });
 }
 
 void Player::usePotion(size_t index) {
 	if (index >= potionInventory.size()) {
-		std::cout << " * Invalid potion selection. *\n";
+		Console::out() << tr(StringID::INVALID_POTION);
 		return;
 	}
 
-	Potion* potion = potionInventory[index];
-	heal(potion->getHealAmount());
+	heal(potionInventory[index].bonus);
 
 	// Remove the potion from inventory
-	potionInventory.erase(potionInventory.begin() + index);
-	delete potion;
-	std::cout << " * The potion has been consumed. *\n";
+	potionInventory.erase(index);
+	potionsUsed++;
+	if (journal) journal->recordItemRemoved(ItemKind::POTION, index);
+	Console::out() << tr(StringID::POTION_CONSUMED);
+}
+
+void Player::setJournal(JournalSession* session) {
+	journal = session;
+}
+
+JournalSession* Player::getJournal() const {
+	return journal;
+}
+
+void Player::restore(const PlayerState& state) {
+	hitPoints = std::clamp(state.hitPoints, 0, maxHitPoints);
+	stats.setBase(Stat::ATTACK, state.attack);
+	stats.setBase(Stat::DEFENSE, state.defense);
+	stats.clearEffects();
+	skills = state.skills;
+	potionsUsed = state.potionsUsed;
+	applySkills();
+	restoreItems(weaponInventory, *state.weapons);
+	restoreItems(armorInventory, *state.armor);
+	restoreItems(potionInventory, *state.potions);
+	setEquippedWeapon(equippedIndex(weaponInventory, state.equippedWeapon));
+	setEquippedArmor(equippedIndex(armorInventory, state.equippedArmor));
+}
+
+bool Player::matchesState(const PlayerState& state) const {
+	return hitPoints == state.hitPoints && maxHitPoints == state.maxHitPoints
+		&& stats.getBase(Stat::ATTACK) == state.attack && stats.getBase(Stat::DEFENSE) == state.defense
+		&& skills == state.skills
+		&& potionsUsed == state.potionsUsed
+		&& equippedWeapon == state.equippedWeapon
+		&& equippedArmor == state.equippedArmor
+		&& sameItems(weaponInventory, *state.weapons)
+		&& sameItems(armorInventory, *state.armor)
+		&& sameItems(potionInventory, *state.potions);
+}
+
+void Player::captureState(PlayerState& state) const {
+	state.hitPoints = hitPoints;
+	state.maxHitPoints = maxHitPoints;
+	state.attack = stats.getBase(Stat::ATTACK);
+	state.defense = stats.getBase(Stat::DEFENSE);
+	state.skills = skills;
+	state.potionsUsed = potionsUsed;
+	state.equippedWeapon = equippedWeapon;
+	state.equippedArmor = equippedArmor;
+	captureItems(weaponInventory, state.weapons);
+	captureItems(armorInventory, state.armor);
+	captureItems(potionInventory, state.potions);
 }
 
 void Player::displayStatus() const {
-	std::cout << "\n * * * * *\n- - - " << name << "'s Status - - -\n";
-	std::cout << name << "'s HP: " << hitPoints << "/" << maxHitPoints << "\n";
+	Console::out() << tr(StringID::STATUS_TITLE, name);
+	Console::out() << tr(StringID::STATUS_HP, name, hitPoints, maxHitPoints);
 
-	std::cout << "Attack: " << getTotalAttack() << " (Base: " << baseAttack;
-	if (equippedWeapon) {
-		std::cout << " + " << equippedWeapon->getAttackBonus()
-			<< " from " << equippedWeapon->getName();
+	Console::out() << tr(StringID::STATUS_ATTACK, getTotalAttack(), stats.getBase(Stat::ATTACK));
+	if (equippedWeapon != NOTHING) {
+		const CarriedItem& weapon = weaponInventory[equippedWeapon];
+		Console::out() << tr(StringID::STATUS_BONUS, weapon.bonus, weapon.name.str());
 	}
-	std::cout << ")\n";
+	printModifiers(stats, Stat::ATTACK);
+	Console::out() << ")\n";
 
-	std::cout << "Defense: " << getTotalDefense() << " (Base: " << baseDefense;
-	if (equippedArmor) {
-		std::cout << " + " << equippedArmor->getDefenseBonus()
-			<< " from " << equippedArmor->getName();
+	Console::out() << tr(StringID::STATUS_DEFENSE, getTotalDefense(), stats.getBase(Stat::DEFENSE));
+	if (equippedArmor != NOTHING) {
+		const CarriedItem& armor = armorInventory[equippedArmor];
+		Console::out() << tr(StringID::STATUS_BONUS, armor.bonus, armor.name.str());
+	}
+	printModifiers(stats, Stat::DEFENSE);
+	Console::out() << ")\n";
+
+	// Display learned disciplines
+	Console::out() << tr(StringID::STATUS_SKILLS);
+	if (skills == 0) {
+		Console::out() << tr(StringID::STATUS_NONE);
+	}
+	else {
+		const char* separator = "";
+		for (size_t i = 0; i < static_cast<size_t>(Skill::COUNT); ++i) {
+			if (!hasSkill(static_cast<Skill>(i))) continue;
+			Console::out() << separator << tr(skillName(static_cast<Skill>(i)));
+			separator = ", ";
+		}
+		Console::out() << "\n";
 	}
-	std::cout << ")\n";
 
 	// Display weapon inventory
-	std::cout << "Weapon: ";
+	Console::out() << tr(StringID::STATUS_WEAPONS);
 	if (weaponInventory.empty()) {
-		std::cout << "None\n";
+		Console::out() << tr(StringID::STATUS_NONE);
 	}
 	else {
-		std::cout << "\n";
+		Console::out() << "\n";
 		for (size_t i = 0; i < weaponInventory.size(); ++i) {
-			std::cout << "  " << i + 1 << ". " << weaponInventory[i]->getName();
-			if (weaponInventory[i] == equippedWeapon) {
-				std::cout << " (Equipped)";
+			Console::out() << "  " << i + 1 << ". " << weaponInventory[i].name.str();
+			if (static_cast<int16_t>(i) == equippedWeapon) {
+				Console::out() << tr(StringID::TAG_EQUIPPED);
 			}
-			std::cout << "\n";
+			Console::out() << "\n";
 		}
 	}
 	// Display armor inventory
-	std::cout << "Armor: ";
+	Console::out() << tr(StringID::STATUS_ARMOR);
 	if (armorInventory.empty()) {
-		std::cout << "None\n";
+		Console::out() << tr(StringID::STATUS_NONE);
 	}
 	else {
-		std::cout << "\n";
+		Console::out() << "\n";
 		for (size_t i = 0; i < armorInventory.size(); ++i) {
-			std::cout << "  " << i + 1 << ". " << armorInventory[i]->getName();
-			if (armorInventory[i] == equippedArmor) {
-				std::cout << " (Equipped)";
+			Console::out() << "  " << i + 1 << ". " << armorInventory[i].name.str();
+			if (static_cast<int16_t>(i) == equippedArmor) {
+				Console::out() << tr(StringID::TAG_EQUIPPED);
 			}
-			std::cout << "\n";
+			Console::out() << "\n";
 		}
 	}
 
 	// Display potion inventory
-	std::cout << "Potions: ";
+	Console::out() << tr(StringID::STATUS_POTIONS);
 	if (potionInventory.empty()) {
-		std::cout << "None\n";
+		Console::out() << tr(StringID::STATUS_NONE);
 	}
 	else {
-		std::cout << "\n";
+		Console::out() << "\n";
 		for (size_t i = 0; i < potionInventory.size(); ++i) {
-			std::cout << "  " << i + 1 << ". " << potionInventory[i]->getName() << "\n";
+			Console::out() << "  " << i + 1 << ". " << potionInventory[i].name.str() << "\n";
 		}
 	}
-	std::cout << "\n";
+	Console::out() << "\n";
 }
 
 void Player::manageInventory() {
+	TraceSpan span("Player::manageInventory", "inventory");
 	while (true) {
-		std::cout << "\n * * Menu * *\n";
-		std::cout << "1. Character Status\n";
-		std::cout << "2. Equip a weapon\n";
-		std::cout << "3. Equip armor\n";
-		std::cout << "4. Use a potion\n";
-		std::cout << "5. Drop an item\n";
-		std::cout << "\n - - - - - - - - - - - - - - - - - - -";
-		std::cout << "\nEnter your choice (0 to return): ";
+		Console::out() << tr(StringID::INVENTORY_MENU);
 
 		size_t input;
-		validateInput(input, 5);
+		validateInput(input, 5, INVENTORY_VERBS);
 
 		// Return
 		if (input == 0) break;
@@ -202,7 +401,7 @@ void Player::manageInventory() {
 			dropItem();
 			break;
 		default:
-			std::cout << "Invalid choice.\n";
+			Console::out() << tr(StringID::INVALID_CHOICE);
 			break;
 		}
 	}
@@ -210,118 +409,118 @@ void Player::manageInventory() {
 
 void Player::manageWeapon() {
 	if (weaponInventory.empty()) {
-		std::cout << "You have no equipment to equip.\n";
+		Console::out() << tr(StringID::NO_WEAPONS);
 		return;
 	}
 
-	std::cout << "\nSelect " << "weapon" << " to equip:\n";
+	Console::out() << tr(StringID::SELECT_WEAPON);
 
-	for (int i = 0; i < weaponInventory.size(); ++i) {
-		std::cout << i + 1 << ". " << weaponInventory[i]->getName();
+	for (size_t i = 0; i < weaponInventory.size(); ++i) {
+		Console::out() << i + 1 << ". " << weaponInventory[i].name.str();
 
 		// Show bonuses
-		std::cout << " [Attack: +" << weaponInventory[i]->getAttackBonus() << "]";
+		Console::out() << tr(StringID::TAG_ATTACK_BONUS, weaponInventory[i].bonus);
 
 		// Show if currently equipped
-		if (weaponInventory[i] == equippedWeapon) {
-			std::cout << " (Currently equipped)";
+		if (static_cast<int16_t>(i) == equippedWeapon) {
+			Console::out() << tr(StringID::TAG_CURRENTLY_EQUIPPED);
 		}
-		std::cout << "\n";
+		Console::out() << "\n";
 	}
 
-	std::cout << "\nEnter your choice: (0 to cancel): ";
+	Console::out() << tr(StringID::PROMPT_CANCEL);
 	size_t input;
 	validateInput(input, weaponInventory.size());
 
 	if (input == 0) {
-		std::cout << "Cancelled weapon equip.\n";
+		Console::out() << tr(StringID::WEAPON_EQUIP_CANCELLED);
 		return;
 	}
 
 	// Confirmation unequip if equipped
 	// weapon index starts from 0, choice starts from 1, hence minus 1
-	if (weaponInventory[input - 1] == equippedWeapon) {
-		std::cout << "This item is currently equipped. Would you like to unequip it? (1 = Yes, 0 = No): ";
+	if (static_cast<int16_t>(input - 1) == equippedWeapon) {
+		Console::out() << tr(StringID::CONFIRM_UNEQUIP);
 		size_t confirm;
 		validateInput(confirm, 1);
 
 		if (confirm != 1) {
-			std::cout << "Cancelled weapon equip.\n";
+			Console::out() << tr(StringID::WEAPON_EQUIP_CANCELLED);
 			return;
 		}
-		std::cout << equippedWeapon->getName() << " has been unequipped.\n";
-		equippedWeapon = nullptr;
+		Console::out() << tr(StringID::WEAPON_UNEQUIPPED, weaponInventory[equippedWeapon].name.str());
+		setEquippedWeapon(NOTHING);
+		if (journal) journal->recordEquip(ItemKind::WEAPON, -1);
 		return;
 	}
 
-	Weapon* selected = weaponInventory[input - 1];
-	equipWeapon(selected);
+	equipWeapon(input - 1);
 }
 
 void Player::manageArmor() {
 	if (armorInventory.empty()) {
-		std::cout << "You have no armor to equip.\n";
+		Console::out() << tr(StringID::NO_ARMOR);
 		return;
 	}
 
-	std::cout << "\nSelect " << "armor" << " to equip:\n";
+	Console::out() << tr(StringID::SELECT_ARMOR);
 
 	for (size_t i = 0; i < armorInventory.size(); ++i) {
-		std::cout << i + 1 << ". " << armorInventory[i]->getName();
+		Console::out() << i + 1 << ". " << armorInventory[i].name.str();
 
-		std::cout << " [Defense: +" << armorInventory[i]->getDefenseBonus() << "]";
+		Console::out() << tr(StringID::TAG_DEFENSE_BONUS, armorInventory[i].bonus);
 
-		if (armorInventory[i] == equippedArmor) {
-			std::cout << " (Currently equipped)";
+		if (static_cast<int16_t>(i) == equippedArmor) {
+			Console::out() << tr(StringID::TAG_CURRENTLY_EQUIPPED);
 		}
-		std::cout << "\n";
+		Console::out() << "\n";
 	}
 
-	std::cout << "\nEnter your choice: (0 to cancel): ";
+	Console::out() << tr(StringID::PROMPT_CANCEL);
 	size_t input;
 	validateInput(input, armorInventory.size());
 
 	if (input == 0) {
-		std::cout << "Cancelled armor equip.\n";
+		Console::out() << tr(StringID::ARMOR_EQUIP_CANCELLED);
 		return;
 	}
 
-	if (armorInventory[input - 1] == equippedArmor) {
-		std::cout << "This item is currently equipped. Would you like to unequip it? (1 = Yes, 0 = No): ";
+	if (static_cast<int16_t>(input - 1) == equippedArmor) {
+		Console::out() << tr(StringID::CONFIRM_UNEQUIP);
 		size_t confirm;
 		validateInput(confirm, 1);
 
 		if (confirm != 1) {
-			std::cout << "Cancelled armor equip.\n";
+			Console::out() << tr(StringID::ARMOR_EQUIP_CANCELLED);
 			return;
 		}
-		std::cout << "Unequipped armor:" << equippedArmor->getName() << "\n";
-		equippedArmor = nullptr;
+		Console::out() << tr(StringID::ARMOR_UNEQUIPPED, armorInventory[equippedArmor].name.str());
+		setEquippedArmor(NOTHING);
+		if (journal) journal->recordEquip(ItemKind::ARMOR, -1);
 		return;
 	}
 
-	Armor* selected = armorInventory[input - 1];
-	equipArmor(selected);
+	equipArmor(input - 1);
 }
 
 void Player::useInventoryPotion() {
 	if (potionInventory.empty()) {
-		std::cout << "You have no potions to use.\n";
+		Console::out() << tr(StringID::NO_POTIONS);
 		return;
 	}
 
-	std::cout << "\nSelect a potion to use:\n";
+	Console::out() << tr(StringID::SELECT_POTION);
 	for (size_t i = 0; i < potionInventory.size(); ++i) {
-		std::cout << i + 1 << ". " << potionInventory[i]->getName()
-			<< " (+" << potionInventory[i]->getHealAmount() << " HP)\n";
+		Console::out() << i + 1 << ". " << potionInventory[i].name.str()
+			<< tr(StringID::TAG_HEAL_AMOUNT, potionInventory[i].bonus) << "\n";
 	}
 
-	std::cout << "\nEnter your choice: (0 to cancel): ";
+	Console::out() << tr(StringID::PROMPT_CANCEL);
 	size_t input;
 	validateInput(input, potionInventory.size());
 
 	if (input == 0) {
-		std::cout << "Cancelled potion use.\n";
+		Console::out() << tr(StringID::POTION_CANCELLED);
 		return;
 	}
 
@@ -330,88 +529,85 @@ void Player::useInventoryPotion() {
 
 void Player::dropItem() {
 	if (weaponInventory.empty() && armorInventory.empty() && potionInventory.empty()) {
-		std::cout << "You have nothing to drop.\n";
+		Console::out() << tr(StringID::NOTHING_TO_DROP);
 		return;
 	}
-	std::cout << "\nSelect item to drop:\n";
+	Console::out() << tr(StringID::SELECT_DROP);
 	// Display all weapon
 	int itemIndex = 1;
-	for (const auto& weapon : weaponInventory) {
-		std::cout << itemIndex << ". " << weapon->getName() << " [Weapon]";
-		if (weapon == equippedWeapon) {
-			std::cout << " (Equipped)";
+	for (size_t i = 0; i < weaponInventory.size(); ++i) {
+		Console::out() << itemIndex << ". " << weaponInventory[i].name.str() << tr(StringID::TAG_WEAPON);
+		if (static_cast<int16_t>(i) == equippedWeapon) {
+			Console::out() << tr(StringID::TAG_EQUIPPED);
 		}
-		std::cout << "\n";
+		Console::out() << "\n";
 		itemIndex++;
 	}
 	// Display all armor
-	for (const auto& armor : armorInventory) {
-		std::cout << itemIndex << ". " << armor->getName() << " [Armor]";
-		if (armor == equippedArmor) {
-			std::cout << " (Equipped)";
+	for (size_t i = 0; i < armorInventory.size(); ++i) {
+		Console::out() << itemIndex << ". " << armorInventory[i].name.str() << tr(StringID::TAG_ARMOR);
+		if (static_cast<int16_t>(i) == equippedArmor) {
+			Console::out() << tr(StringID::TAG_EQUIPPED);
 		}
-		std::cout << "\n";
+		Console::out() << "\n";
 		itemIndex++;
 	}
 	// List all potions
-	for (const auto& potion : potionInventory) {
-		std::cout << itemIndex << ". " << potion->getName() << " [Recovery]";
-		std::cout << "\n";
+	for (const CarriedItem& potion : potionInventory) {
+		Console::out() << itemIndex << ". " << potion.name.str() << tr(StringID::TAG_RECOVERY);
+		Console::out() << "\n";
 		itemIndex++;
 	}
 
-	std::cout << "\nEnter your choice: (0 to cancel): ";
+	Console::out() << tr(StringID::PROMPT_CANCEL);
 	size_t input;
 	size_t totalItems = weaponInventory.size() + armorInventory.size() + potionInventory.size();
 	validateInput(input, totalItems);
 
 	if (input == 0) {
-		std::cout << "Cancelled dropping item.\n";
+		Console::out() << tr(StringID::DROP_CANCELLED);
 		return;
 	}
 
 	if (input <= weaponInventory.size()) {
 		size_t weaponIndex = input - 1;
-		Weapon* selectedItem = weaponInventory[weaponIndex];
-		if (selectedItem == equippedWeapon) {
-			std::cout << "This item is currently equipped. Are you sure? (1=Yes, 0=No): ";
+		if (static_cast<int16_t>(weaponIndex) == equippedWeapon) {
+			Console::out() << tr(StringID::CONFIRM_DROP_EQUIPPED);
 			size_t confirm;
 			validateInput(confirm, 1);
 
 			if (confirm != 1) {
-				std::cout << "Item kept.\n";
+				Console::out() << tr(StringID::ITEM_KEPT);
 				return;
 			}
-			equippedWeapon = nullptr;
+			setEquippedWeapon(NOTHING);
 		}
 		// Remove from inventory
-		std::cout << "Dropped " << selectedItem->getName() << ".\n";
-		weaponInventory.erase(weaponInventory.begin() + weaponIndex);
-		delete selectedItem;
+		Console::out() << tr(StringID::ITEM_DROPPED, weaponInventory[weaponIndex].name.str());
+		removeItem(weaponInventory, equippedWeapon, weaponIndex);
+		if (journal) journal->recordItemRemoved(ItemKind::WEAPON, weaponIndex);
 	}
 	else if (input <= weaponInventory.size() + armorInventory.size()) {
 		size_t armorIndex = input - weaponInventory.size() - 1;
-		Armor* selectedItem = armorInventory[armorIndex];
-		if (selectedItem == equippedArmor) {
-			std::cout << "This item is currently equipped. Are you sure? (1=Yes, 0=No): ";
+		if (static_cast<int16_t>(armorIndex) == equippedArmor) {
+			Console::out() << tr(StringID::CONFIRM_DROP_EQUIPPED);
 			size_t confirm;
 			validateInput(confirm, 1);
 
 			if (confirm != 1) {
-				std::cout << "Item kept.\n";
+				Console::out() << tr(StringID::ITEM_KEPT);
 				return;
 			}
-			equippedArmor = nullptr;
+			setEquippedArmor(NOTHING);
 		}
-		std::cout << "Dropped " << selectedItem->getName() << ".\n";
-		armorInventory.erase(armorInventory.begin() + armorIndex);
-		delete selectedItem;
+		Console::out() << tr(StringID::ITEM_DROPPED, armorInventory[armorIndex].name.str());
+		removeItem(armorInventory, equippedArmor, armorIndex);
+		if (journal) journal->recordItemRemoved(ItemKind::ARMOR, armorIndex);
 	}
 	else {
 		size_t potionIndex = input - weaponInventory.size() - armorInventory.size() - 1;
-		Potion* selectedPotion = potionInventory[potionIndex];
-		std::cout << "Dropped " << selectedPotion->getName() << ".\n";
-		potionInventory.erase(potionInventory.begin() + potionIndex);
-		delete selectedPotion;
+		Console::out() << tr(StringID::ITEM_DROPPED, potionInventory[potionIndex].name.str());
+		potionInventory.erase(potionIndex);
+		if (journal) journal->recordItemRemoved(ItemKind::POTION, potionIndex);
 	}
 }
\ No newline at end of file
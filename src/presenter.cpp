@@ -0,0 +1,113 @@
+#include "presenter.h"
+#include <iostream>
+#include "trace.h"
+
+namespace {
+
+constexpr size_t TEXT_FLUSH_SIZE = 4096;   // Text queued at once at the latest
+
+} // namespace
+
+PresentationHost::TextBuffer::int_type PresentationHost::TextBuffer::overflow(int_type c) {
+	if (!traits_type::eq_int_type(c, traits_type::eof())) {
+		pending.push_back(traits_type::to_char_type(c));
+	}
+	return traits_type::not_eof(c);
+}
+
+std::streamsize PresentationHost::TextBuffer::xsputn(const char* text, std::streamsize count) {
+	pending.append(text, static_cast<size_t>(count));
+	if (pending.size() >= TEXT_FLUSH_SIZE) {
+		host.flushText();
+	}
+	return count;
+}
+
+int PresentationHost::TextBuffer::sync() {
+	host.flushText();
+	return 0;
+}
+
+PresentationHost::PresentationHost() : textBuffer(*this), output(&textBuffer) {
+	presenter = std::thread([this] { present(); });
+}
+
+PresentationHost::~PresentationHost() {
+	drain();
+	stopping.store(true, std::memory_order_release);
+	// Wakes the presenter if it sleeps on an empty queue
+	queue.push(GameEvent{});
+	presenter.join();
+}
+
+std::istream& PresentationHost::in() {
+	drain();
+	return std::cin;
+}
+
+std::ostream& PresentationHost::out() {
+	return output;
+}
+
+void PresentationHost::pause(std::chrono::milliseconds duration) {
+	GameEvent event;
+	event.type = GameEventType::PAUSE;
+	event.value = static_cast<int>(duration.count());
+	publish(std::move(event));
+}
+
+void PresentationHost::publish(GameEvent&& event) {
+	flushText();
+	enqueue(std::move(event));
+}
+
+void PresentationHost::drain() {
+	flushText();
+	size_t done = presented.load(std::memory_order_acquire);
+	while (done != published) {
+		presented.wait(done, std::memory_order_acquire);
+		done = presented.load(std::memory_order_acquire);
+	}
+}
+
+void PresentationHost::enqueue(GameEvent&& event) {
+	queue.push(std::move(event));
+	published++;
+}
+
+void PresentationHost::flushText() {
+	if (textBuffer.pending.empty()) {
+		return;
+	}
+	GameEvent event;
+	event.text.swap(textBuffer.pending);
+	enqueue(std::move(event));
+}
+
+void PresentationHost::present() {
+	GameEvent event;
+	size_t done = 0;
+	while (true) {
+		if (!queue.tryPop(event)) {
+			// Caught up: the player sees everything before the game is told so
+			std::cout.flush();
+			presented.store(done, std::memory_order_release);
+			presented.notify_one();
+			if (stopping.load(std::memory_order_acquire)) {
+				return;
+			}
+			queue.waitWhileEmpty();
+			continue;
+		}
+
+		if (event.type == GameEventType::PAUSE) {
+			std::cout.flush();
+			TraceSpan span("pacing wait", "pacing");
+			std::this_thread::sleep_for(std::chrono::milliseconds(event.value));
+		}
+		else {
+			presentEvent(event, std::cout);
+		}
+		done++;
+	}
+}
\ No newline at end of file
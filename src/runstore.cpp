@@ -0,0 +1,611 @@
+#include "runstore.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+namespace {
+
+constexpr char DATA_MAGIC[4] = { 'L', 'W', 'R', 'S' };
+constexpr char INDEX_MAGIC[4] = { 'L', 'W', 'R', 'I' };
+constexpr uint32_t STORE_VERSION = 1;
+constexpr uint64_t DATA_HEADER = 8;     // Magic and version
+constexpr uint64_t INDEX_HEADER = 24;   // Magic, version, indexed record bytes and sorted entries
+constexpr uint64_t ENTRY_SIZE = sizeof(RunStore::IndexEntry);
+constexpr size_t RECORD_HEADER = 8;     // Body length and checksum
+constexpr size_t MAX_TEXT = 4096;
+constexpr uint32_t MAX_LIST = 1 << 20;
+constexpr size_t MIN_TAIL = 4096;       // Tail entries always allowed before a merge
+constexpr size_t MERGE_CHUNK = 8192;    // Sorted entries read at once while merging
+constexpr uint64_t VALUE_MASK = (uint64_t(1) << 56) - 1;
+constexpr uint64_t LOW_MASK = (uint64_t(1) << 24) - 1;
+
+static_assert(sizeof(RunStore::IndexEntry) == 16, "index entries are written to disk as they are");
+
+/**
+ * @brief FNV-1a hash, used both as checksum and for names in keys
+ */
+uint32_t fnv(const char* data, size_t size) {
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < size; ++i) {
+		hash = (hash ^ static_cast<unsigned char>(data[i])) * 16777619u;
+	}
+	return hash;
+}
+
+uint32_t nameHash(const std::string& name) {
+	return fnv(name.data(), name.size());
+}
+
+uint64_t makeKey(RunStore::Index kind, uint64_t value) {
+	return (static_cast<uint64_t>(kind) << 56) | (value & VALUE_MASK);
+}
+
+/**
+ * @brief Value of 32 bits followed by one of 24 bits, clamped, so keys sort by both
+ */
+uint64_t composite(uint32_t high, int low) {
+	return (static_cast<uint64_t>(high) << 24) | std::min<uint64_t>(static_cast<uint64_t>(std::max(low, 0)), LOW_MASK);
+}
+
+/**
+ * @brief Appends fixed-size values in host byte order, like the journal
+ */
+class Writer {
+private:
+	std::string& out;
+
+public:
+	explicit Writer(std::string& target) : out(target) {}
+
+	template <typename T>
+	void put(T value) {
+		char bytes[sizeof(T)];
+		std::memcpy(bytes, &value, sizeof(T));
+		out.append(bytes, sizeof(T));
+	}
+
+	void putText(const std::string& text) {
+		put(static_cast<uint32_t>(std::min(text.size(), MAX_TEXT)));
+		out.append(text, 0, MAX_TEXT);
+	}
+};
+
+class Reader {
+private:
+	const std::string& in;
+	size_t pos = 0;
+
+public:
+	explicit Reader(const std::string& source) : in(source) {}
+
+	template <typename T>
+	bool get(T& value) {
+		if (in.size() - pos < sizeof(T)) return false;
+		std::memcpy(&value, in.data() + pos, sizeof(T));
+		pos += sizeof(T);
+		return true;
+	}
+
+	bool getText(std::string& text) {
+		uint32_t length;
+		if (!get(length) || length > MAX_TEXT || in.size() - pos < length) return false;
+		text.assign(in, pos, length);
+		pos += length;
+		return true;
+	}
+};
+
+void encodeRun(std::string& out, const RunRecord& run) {
+	out.assign(RECORD_HEADER, '\0');
+	Writer writer(out);
+	writer.put(run.finishedAt);
+	writer.put(static_cast<uint8_t>(run.outcome));
+	writer.put(static_cast<int32_t>(run.ending));
+	writer.put(static_cast<int32_t>(run.hitPoints));
+	writer.put(static_cast<int32_t>(run.maxHitPoints));
+	writer.put(static_cast<int32_t>(run.turns));
+	writer.putText(run.player);
+	writer.putText(run.killer);
+	writer.put(static_cast<uint32_t>(run.route.size()));
+	for (int scene : run.route) {
+		writer.put(static_cast<int32_t>(scene));
+	}
+	writer.put(static_cast<uint32_t>(run.slain.size()));
+	for (const auto& [name, count] : run.slain) {
+		writer.putText(name);
+		writer.put(static_cast<int32_t>(count));
+	}
+	writer.put(static_cast<uint8_t>(run.resumed));
+
+	uint32_t length = static_cast<uint32_t>(out.size() - RECORD_HEADER);
+	uint32_t sum = fnv(out.data() + RECORD_HEADER, length);
+	std::memcpy(out.data(), &length, sizeof(length));
+	std::memcpy(out.data() + sizeof(length), &sum, sizeof(sum));
+}
+
+bool decodeRun(const std::string& body, RunRecord& run) {
+	Reader reader(body);
+	uint8_t outcome;
+	int32_t ending, hitPoints, maxHitPoints, turns;
+	uint32_t count;
+	if (!reader.get(run.finishedAt) || !reader.get(outcome) || !reader.get(ending) || !reader.get(hitPoints)
+		|| !reader.get(maxHitPoints) || !reader.get(turns) || !reader.getText(run.player) || !reader.getText(run.killer)
+		|| !reader.get(count) || count > MAX_LIST) {
+		return false;
+	}
+	run.outcome = static_cast<RunOutcome>(outcome);
+	run.ending = ending;
+	run.hitPoints = hitPoints;
+	run.maxHitPoints = maxHitPoints;
+	run.turns = turns;
+	run.route.resize(count);
+	for (int& scene : run.route) {
+		int32_t value;
+		if (!reader.get(value)) return false;
+		scene = value;
+	}
+	if (!reader.get(count) || count > MAX_LIST) return false;
+	run.slain.resize(count);
+	for (auto& [name, slain] : run.slain) {
+		int32_t value;
+		if (!reader.getText(name) || !reader.get(value)) return false;
+		slain = value;
+	}
+	// Runs written before the flag existed end here and were never resumed
+	uint8_t resumed = 0;
+	reader.get(resumed);
+	run.resumed = resumed != 0;
+	return true;
+}
+
+/**
+ * @brief Reads the record at offset of an open stream and moves past it
+ *
+ * @return bool False at the end of the file or at a torn or damaged record
+ */
+bool readRecord(std::istream& in, uint64_t& offset, RunRecord& run) {
+	uint32_t header[2];
+	in.clear();
+	in.seekg(static_cast<std::streamoff>(offset));
+	if (!in.read(reinterpret_cast<char*>(header), sizeof(header)) || header[0] > MAX_LIST * 4) {
+		return false;
+	}
+	std::string body(header[0], '\0');
+	if (!in.read(body.data(), static_cast<std::streamsize>(body.size())) || fnv(body.data(), body.size()) != header[1]
+		|| !decodeRun(body, run)) {
+		return false;
+	}
+	offset += RECORD_HEADER + header[0];
+	return true;
+}
+
+template <typename T>
+void writeValue(std::ostream& out, const T& value) {
+	out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+bool readValue(std::istream& in, T& value) {
+	return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+template <typename Key>
+void sortByCount(std::vector<std::pair<Key, size_t>>& counts) {
+	std::stable_sort(counts.begin(), counts.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+}
+
+} // namespace
+
+RunStore::~RunStore() {
+	close();
+}
+
+bool RunStore::open(const std::string& recordPath, std::string& error) {
+	std::lock_guard<std::mutex> lock(mutex);
+	path = recordPath;
+	indexPath = recordPath + ".idx";
+
+	std::error_code ec;
+	if (!std::filesystem::exists(path, ec) || std::filesystem::file_size(path, ec) == 0) {
+		std::ofstream create(path, std::ios::binary | std::ios::trunc);
+		create.write(DATA_MAGIC, sizeof(DATA_MAGIC));
+		writeValue(create, STORE_VERSION);
+		if (!create) {
+			error = "cannot create " + path;
+			return false;
+		}
+	}
+	data.open(path, std::ios::in | std::ios::out | std::ios::binary);
+	char magic[sizeof(DATA_MAGIC)];
+	uint32_t version;
+	if (!data.read(magic, sizeof(magic)) || std::memcmp(magic, DATA_MAGIC, sizeof(magic)) != 0
+		|| !readValue(data, version) || version != STORE_VERSION) {
+		error = path + " is not a run store";
+		data.close();
+		return false;
+	}
+	return openIndex(error) && catchUp(error);
+}
+
+void RunStore::close() {
+	std::lock_guard<std::mutex> lock(mutex);
+	// Leave a small tail, so the next open has little to read and sort
+	std::string error;
+	if (index.is_open() && tail.size() > MIN_TAIL && !merge(error)) {
+		std::cerr << "[runs] " << error << "\n";
+	}
+	data.close();
+	index.close();
+	tail.clear();
+	runs = 0;
+}
+
+bool RunStore::openIndex(std::string& error) {
+	index.open(indexPath, std::ios::in | std::ios::out | std::ios::binary);
+	char magic[sizeof(INDEX_MAGIC)];
+	uint32_t version;
+	bool valid = index && index.read(magic, sizeof(magic)) && std::memcmp(magic, INDEX_MAGIC, sizeof(magic)) == 0
+		&& readValue(index, version) && version == STORE_VERSION && readValue(index, dataEnd) && readValue(index, sortedCount);
+
+	std::error_code ec;
+	uint64_t size = valid ? std::filesystem::file_size(indexPath, ec) : 0;
+	// An index of more records than there are cannot be trusted either
+	if (!valid || ec || size < INDEX_HEADER + sortedCount * ENTRY_SIZE || dataEnd > std::filesystem::file_size(path, ec)) {
+		// No usable index: build it again from the records
+		index.close();
+		std::ofstream create(indexPath, std::ios::binary | std::ios::trunc);
+		dataEnd = DATA_HEADER;
+		sortedCount = 0;
+		tail.clear();
+		index.open(indexPath, std::ios::in | std::ios::out | std::ios::binary);
+		return writeHeader(error);
+	}
+
+	tail.resize((size - INDEX_HEADER - sortedCount * ENTRY_SIZE) / ENTRY_SIZE);
+	index.seekg(static_cast<std::streamoff>(INDEX_HEADER + sortedCount * ENTRY_SIZE));
+	if (!index.read(reinterpret_cast<char*>(tail.data()), static_cast<std::streamsize>(tail.size() * ENTRY_SIZE))) {
+		error = "cannot read " + indexPath;
+		return false;
+	}
+	std::sort(tail.begin(), tail.end());
+	return true;
+}
+
+bool RunStore::catchUp(std::string& error) {
+	// Entries of runs past the indexed end, or a torn entry, came from an interrupted append
+	size_t before = tail.size();
+	std::erase_if(tail, [this](const IndexEntry& entry) { return entry.offset >= dataEnd; });
+	std::error_code ec;
+	bool dirty = tail.size() != before
+		|| (std::filesystem::file_size(indexPath, ec) - INDEX_HEADER) % ENTRY_SIZE != 0;
+
+	uint64_t offset = dataEnd;
+	RunRecord run;
+	std::vector<IndexEntry> entries;
+	while (true) {
+		uint64_t start = offset;
+		if (!readRecord(data, offset, run)) break;
+		addEntries(run, start, entries);
+		dirty = true;
+	}
+	tail.insert(tail.end(), entries.begin(), entries.end());
+	std::sort(tail.begin(), tail.end());
+	dataEnd = offset;
+
+	uint64_t size = std::filesystem::file_size(path, ec);
+	if (!ec && size > dataEnd) {
+		// A torn record at the end; cut it off so the next run follows the last good one
+		data.close();
+		std::filesystem::resize_file(path, dataEnd, ec);
+		data.open(path, std::ios::in | std::ios::out | std::ios::binary);
+		if (ec || !data) {
+			error = "cannot repair " + path;
+			return false;
+		}
+	}
+
+	if (dirty && !merge(error)) {
+		return false;
+	}
+	runs = countRange(makeKey(Index::DATE, 0), makeKey(Index::DATE, VALUE_MASK));
+	return true;
+}
+
+bool RunStore::append(const RunRecord& run, std::string& error) {
+	std::lock_guard<std::mutex> lock(mutex);
+	if (!data.is_open()) {
+		error = "run store is not open";
+		return false;
+	}
+
+	std::string record;
+	encodeRun(record, run);
+	data.clear();
+	data.seekp(static_cast<std::streamoff>(dataEnd));
+	data.write(record.data(), static_cast<std::streamsize>(record.size()));
+	data.flush();
+	if (!data) {
+		error = "cannot write " + path;
+		return false;
+	}
+
+	std::vector<IndexEntry> entries;
+	addEntries(run, dataEnd, entries);
+	dataEnd += record.size();
+	if (!appendEntries(entries, error) || !writeHeader(error)) {
+		return false;
+	}
+	tail.insert(tail.end(), entries.begin(), entries.end());
+	tailSorted = false;
+	runs++;
+
+	if (tail.size() > std::max<size_t>(MIN_TAIL, static_cast<size_t>(sortedCount / 8))) {
+		return merge(error);
+	}
+	return true;
+}
+
+size_t RunStore::runCount() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return runs;
+}
+
+void RunStore::addEntries(const RunRecord& run, uint64_t offset, std::vector<IndexEntry>& entries) const {
+	uint32_t player = nameHash(run.player);
+	auto ending = static_cast<uint32_t>(run.ending);
+	entries.push_back({ makeKey(Index::PLAYER, player), offset });
+	entries.push_back({ makeKey(Index::DATE, static_cast<uint64_t>(std::max<int64_t>(run.finishedAt, 0))), offset });
+	if (run.outcome == RunOutcome::ENDING) {
+		entries.push_back({ makeKey(Index::PLAYER_ENDING, (static_cast<uint64_t>(player & LOW_MASK) << 32) | ending), offset });
+		entries.push_back({ makeKey(Index::ENDING_HP, composite(ending, run.hitPoints)), offset });
+		// A resumed run only counts the turns since the resume, so it cannot compete on speed
+		if (!run.resumed) {
+			entries.push_back({ makeKey(Index::ENDING_TURNS, composite(ending, run.turns)), offset });
+		}
+	}
+	if (run.outcome == RunOutcome::DIED) {
+		entries.push_back({ makeKey(Index::DEATH_SCENE, ending), offset });
+		if (!run.killer.empty()) {
+			entries.push_back({ makeKey(Index::KILLER, nameHash(run.killer)), offset });
+		}
+	}
+}
+
+bool RunStore::appendEntries(const std::vector<IndexEntry>& entries, std::string& error) {
+	index.clear();
+	index.seekp(0, std::ios::end);
+	index.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * ENTRY_SIZE));
+	index.flush();
+	if (!index) {
+		error = "cannot write " + indexPath;
+		return false;
+	}
+	return true;
+}
+
+bool RunStore::writeHeader(std::string& error) {
+	index.clear();
+	index.seekp(0);
+	index.write(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+	writeValue(index, STORE_VERSION);
+	writeValue(index, dataEnd);
+	writeValue(index, sortedCount);
+	index.flush();
+	if (!index) {
+		error = "cannot write " + indexPath;
+		return false;
+	}
+	return true;
+}
+
+void RunStore::sortTail() const {
+	if (!tailSorted) {
+		std::sort(tail.begin(), tail.end());
+		tailSorted = true;
+	}
+}
+
+bool RunStore::merge(std::string& error) {
+	sortTail();
+	// Write next to the target and rename so a crash never leaves a partial index
+	std::string tempPath = indexPath + ".tmp";
+	std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+	out.write(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+	writeValue(out, STORE_VERSION);
+	writeValue(out, dataEnd);
+	writeValue(out, sortedCount + tail.size());
+
+	std::vector<IndexEntry> chunk;
+	std::vector<IndexEntry> merged;
+	auto next = tail.begin();
+	index.clear();
+	for (uint64_t position = 0; position < sortedCount; position += chunk.size()) {
+		chunk.resize(static_cast<size_t>(std::min<uint64_t>(MERGE_CHUNK, sortedCount - position)));
+		index.seekg(static_cast<std::streamoff>(INDEX_HEADER + position * ENTRY_SIZE));
+		index.read(reinterpret_cast<char*>(chunk.data()), static_cast<std::streamsize>(chunk.size() * ENTRY_SIZE));
+		// Tail entries that sort before the end of this chunk go in with it
+		auto end = std::upper_bound(next, tail.end(), chunk.back());
+		merged.clear();
+		std::merge(chunk.begin(), chunk.end(), next, end, std::back_inserter(merged));
+		next = end;
+		out.write(reinterpret_cast<const char*>(merged.data()), static_cast<std::streamsize>(merged.size() * ENTRY_SIZE));
+	}
+	size_t rest = static_cast<size_t>(next - tail.begin());
+	out.write(reinterpret_cast<const char*>(tail.data() + rest), static_cast<std::streamsize>((tail.size() - rest) * ENTRY_SIZE));
+	out.close();
+	if (!index || !out) {
+		error = "cannot write " + tempPath;
+		return false;
+	}
+
+	index.close();
+	std::error_code ec;
+	std::filesystem::rename(tempPath, indexPath, ec);
+	index.open(indexPath, std::ios::in | std::ios::out | std::ios::binary);
+	if (ec || !index) {
+		error = "cannot replace " + indexPath;
+		return false;
+	}
+	sortedCount += tail.size();
+	tail.clear();
+	return true;
+}
+
+bool RunStore::readRun(uint64_t offset, RunRecord& run) const {
+	return readRecord(data, offset, run);
+}
+
+RunStore::IndexEntry RunStore::sortedEntry(uint64_t position) const {
+	IndexEntry entry{};
+	index.clear();
+	index.seekg(static_cast<std::streamoff>(INDEX_HEADER + position * ENTRY_SIZE));
+	readValue(index, entry);
+	return entry;
+}
+
+uint64_t RunStore::sortedLowerBound(uint64_t key) const {
+	uint64_t first = 0;
+	uint64_t count = sortedCount;
+	while (count > 0) {
+		uint64_t step = count / 2;
+		if (sortedEntry(first + step).key < key) {
+			first += step + 1;
+			count -= step + 1;
+		}
+		else {
+			count = step;
+		}
+	}
+	return first;
+}
+
+template <typename Fn>
+void RunStore::forEachInRange(uint64_t first, uint64_t last, Fn&& fn) const {
+	sortTail();
+	for (uint64_t position = sortedLowerBound(first); position < sortedCount; ++position) {
+		IndexEntry entry = sortedEntry(position);
+		if (entry.key > last) break;
+		if (!fn(entry.offset)) return;
+	}
+	auto it = std::lower_bound(tail.begin(), tail.end(), IndexEntry{ first, 0 });
+	for (; it != tail.end() && it->key <= last; ++it) {
+		if (!fn(it->offset)) return;
+	}
+}
+
+size_t RunStore::countRange(uint64_t first, uint64_t last) const {
+	sortTail();
+	auto tailFirst = std::lower_bound(tail.begin(), tail.end(), IndexEntry{ first, 0 });
+	auto tailLast = std::lower_bound(tail.begin(), tail.end(), IndexEntry{ last + 1, 0 });
+	return static_cast<size_t>(sortedLowerBound(last + 1) - sortedLowerBound(first)) + static_cast<size_t>(tailLast - tailFirst);
+}
+
+std::optional<RunStore::IndexEntry> RunStore::firstInRange(uint64_t first, uint64_t last) const {
+	sortTail();
+	std::optional<IndexEntry> found;
+	uint64_t position = sortedLowerBound(first);
+	if (position < sortedCount) {
+		IndexEntry entry = sortedEntry(position);
+		if (entry.key <= last) found = entry;
+	}
+	auto it = std::lower_bound(tail.begin(), tail.end(), IndexEntry{ first, 0 });
+	if (it != tail.end() && it->key <= last && (!found || *it < *found)) {
+		found = *it;
+	}
+	return found;
+}
+
+std::optional<RunStore::IndexEntry> RunStore::lastInRange(uint64_t first, uint64_t last) const {
+	sortTail();
+	std::optional<IndexEntry> found;
+	uint64_t position = sortedLowerBound(last + 1);
+	if (position > 0) {
+		IndexEntry entry = sortedEntry(position - 1);
+		if (entry.key >= first) found = entry;
+	}
+	auto it = std::lower_bound(tail.begin(), tail.end(), IndexEntry{ last + 1, 0 });
+	if (it != tail.begin() && (--it)->key >= first && (!found || *found < *it)) {
+		found = *it;
+	}
+	return found;
+}
+
+size_t RunStore::countRuns(const std::string& player) const {
+	std::lock_guard<std::mutex> lock(mutex);
+	uint64_t key = makeKey(Index::PLAYER, nameHash(player));
+	return countRange(key, key);
+}
+
+size_t RunStore::countBetween(int64_t from, int64_t to) const {
+	std::lock_guard<std::mutex> lock(mutex);
+	if (to < from || to < 0) return 0;
+	return countRange(makeKey(Index::DATE, static_cast<uint64_t>(std::max<int64_t>(from, 0))),
+		makeKey(Index::DATE, static_cast<uint64_t>(to)));
+}
+
+std::vector<int> RunStore::unseenEndings(const std::string& player, const std::vector<int>& endings) const {
+	std::lock_guard<std::mutex> lock(mutex);
+	std::vector<int> unseen;
+	uint64_t hash = nameHash(player) & LOW_MASK;
+	RunRecord run;
+	for (int ending : endings) {
+		uint64_t key = makeKey(Index::PLAYER_ENDING, (hash << 32) | static_cast<uint32_t>(ending));
+		bool seen = false;
+		// Another player's name may share the hash; the first run of the player settles it
+		forEachInRange(key, key, [&](uint64_t offset) {
+			seen = readRun(offset, run) && run.player == player;
+			return !seen;
+		});
+		if (!seen) {
+			unseen.push_back(ending);
+		}
+	}
+	return unseen;
+}
+
+std::optional<RunRecord> RunStore::bestHitPoints(int ending) const {
+	std::lock_guard<std::mutex> lock(mutex);
+	auto high = static_cast<uint32_t>(ending);
+	std::optional<IndexEntry> best = lastInRange(makeKey(Index::ENDING_HP, composite(high, 0)),
+		makeKey(Index::ENDING_HP, composite(high, static_cast<int>(LOW_MASK))));
+	RunRecord run;
+	if (!best || !readRun(best->offset, run)) return std::nullopt;
+	return run;
+}
+
+std::optional<RunRecord> RunStore::fastestRoute(int ending) const {
+	std::lock_guard<std::mutex> lock(mutex);
+	auto high = static_cast<uint32_t>(ending);
+	std::optional<IndexEntry> fastest = firstInRange(makeKey(Index::ENDING_TURNS, composite(high, 0)),
+		makeKey(Index::ENDING_TURNS, composite(high, static_cast<int>(LOW_MASK))));
+	RunRecord run;
+	if (!fastest || !readRun(fastest->offset, run)) return std::nullopt;
+	return run;
+}
+
+std::vector<std::pair<std::string, size_t>> RunStore::deathsByEnemy() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	std::vector<std::pair<std::string, size_t>> deaths;
+	uint64_t last = makeKey(Index::KILLER, VALUE_MASK);
+	RunRecord run;
+	// One lookup per distinct enemy, skipping over all deaths to the same one
+	for (auto entry = firstInRange(makeKey(Index::KILLER, 0), last); entry; entry = firstInRange(entry->key + 1, last)) {
+		if (readRun(entry->offset, run)) {
+			deaths.emplace_back(run.killer, countRange(entry->key, entry->key));
+		}
+	}
+	sortByCount(deaths);
+	return deaths;
+}
+
+std::vector<std::pair<int, size_t>> RunStore::deathsByScene() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	std::vector<std::pair<int, size_t>> deaths;
+	uint64_t last = makeKey(Index::DEATH_SCENE, VALUE_MASK);
+	for (auto entry = firstInRange(makeKey(Index::DEATH_SCENE, 0), last); entry; entry = firstInRange(entry->key + 1, last)) {
+		deaths.emplace_back(static_cast<int>(entry->key & VALUE_MASK), countRange(entry->key, entry->key));
+	}
+	sortByCount(deaths);
+	return deaths;
+}
\ No newline at end of file
@@ -1,16 +1,45 @@
+#include <cassert>
 #include <iostream>
-#include <chrono>
-#include <thread>
 #include "scene.h"
 #include "player.h"
-#include "enemy.h"
+#include "encounter.h"
 #include "weapon.h"
 #include "armor.h"
 #include "potion.h"
 #include "utility.h"
+#include "telemetry.h"
+#include "trace.h"
+#include "localization.h"
+#include "console.h"
+#include "journal.h"
+#include "combatlog.h"
+
+SceneRef::SceneRef(int sceneNumber, SceneDirectory* owner)
+	: number(sceneNumber), directory(owner) {
+}
+
+Scene* SceneRef::get() const {
+	if (scene || number == 0 || !directory) {
+		return scene;
+	}
+	Scene* target = directory->getScene(number);
+	if (directory->keepsScene(number)) {
+		scene = target;
+	}
+	return target;
+}
 
-Choice::Choice(const std::string& desc, Scene* next, int min, Scene* fail)
+int SceneRef::getNumber() const {
+	return number;
+}
+
+Choice::Choice(const std::string& desc, SceneRef next, int min, SceneRef fail)
 	: description(desc), nextScene(next), minRoll(min), failScene(fail) {
+	MemTracker::trackText(description);
+}
+
+Choice::~Choice() {
+	MemTracker::releaseText(description);
 }
 
 const std::string& Choice::getDescription() const {
@@ -18,7 +47,7 @@ const std::string& Choice::getDescription() const {
 }
 
 Scene* Choice::getNextScene() const {
-	return nextScene;
+	return nextScene.get();
 }
 
 int Choice::getMinRoll() const {
@@ -26,21 +55,21 @@ int Choice::getMinRoll() const {
 }
 
 Scene* Choice::getFailScene() const {
-	return failScene;
+	return failScene.get();
 }
 
 // Scene implementation
 Scene::Scene(int number, const std::string& desc)
 	: sceneNumber(number), description(desc) {
+	MemTracker::trackText(description);
 }
 
 Scene::~Scene() {
+	MemTracker::releaseText(description);
 	// Clean up choices
 	for (auto choice : choices) {
 		delete choice;
 	}
-	// Clean up enemy
-	delete enemy;
 	// Clean up unlooted equipment
 	for (Weapon* weapon : weaponLoot) {
 		delete weapon;
@@ -53,16 +82,16 @@ Scene::~Scene() {
 	}
 }
 
-void Scene::addChoice(const std::string& choiceDescription, Scene* nextScene, int minRoll, Scene* failScene) {
+void Scene::addChoice(const std::string& choiceDescription, SceneRef nextScene, int minRoll, SceneRef failScene) {
 	auto* newChoice = new Choice(choiceDescription, nextScene, minRoll, failScene);
 	choices.push_back(newChoice);
+	menuCache.clear();
 }
 
-void Scene::setEnemy(const std::string& name, int hp, int atk, int def) {
-	auto* newEnemy = new Enemy(name, hp, atk, def);
-	auto* oldEnemy = enemy;
-	enemy = newEnemy;
-	delete oldEnemy;
+void Scene::addCombatants(CreatureID creature, int count) {
+	for (int i = 0; i < count; ++i) {
+		encounter.addCombatant(creature);
+	}
 }
 
 void Scene::addNewWeapon(const std::string& name, int attackBonus) {
@@ -81,107 +110,184 @@ void Scene::addPotionLoot(const std::string& name, int healAmount) {
 }
 
 void Scene::display() const {
-	std::cout << "\n * * * * * * * * * *";
-	std::cout << "\n- - - Scene " << sceneNumber << " - - -\n";
-	std::cout << description;
-
-	// Display enemy if present
-	if (enemy && enemy->isAlive()) {
-		std::cout << "\n\nA " << enemy->getName() << " is here! (HP: "
-			<< enemy->getHitPoints() << ")";
+	size_t width = Layout::width();
+	const std::string& page = pageCache.get(width, [&](std::string& out) {
+		out += "\n * * * * * * * * * *";
+		out += tr(StringID::SCENE_TITLE, sceneNumber);
+		Layout::wrap(out, description, width);
+	});
+
+	// Compose the whole frame so it goes out in a single write
+	thread_local std::string frame;
+	frame.assign(page);
+
+	// Display enemies and allies if a fight is still ahead
+	if (hasEnemy()) {
+		frame += "\n";
+		for (size_t i = 0; i < encounter.size(); ++i) {
+			if (!encounter.isAlive(i)) continue;
+			if (encounter.getSide(i) == Side::ENEMY) {
+				frame += tr(StringID::ENEMY_PRESENT, encounter.getName(i), encounter.getHitPoints(i));
+			}
+			else {
+				frame += tr(StringID::ALLY_PRESENT, encounter.getName(i), encounter.getHitPoints(i));
+			}
+		}
 	}
 
-	std::cout << "\n\n * * * * * * * * * *\n";
+	frame += "\n\n * * * * * * * * * *\n";
+	Console::publish({ .type = GameEventType::SCENE_ENTERED, .text = frame, .value = sceneNumber });
 }
 
 void Scene::distributeLoot(Player* player) {
 	if (weaponLoot.empty() && armorLoot.empty() && potionLoot.empty()) {
 		return;
 	}
-	std::cout << "\nYou received :\n";
+	Console::publish({ .type = GameEventType::LOOT_RECEIVED });
+	looted = true;
+	if (JournalSession* journal = player->getJournal()) {
+		journal->recordLooted();
+	}
 
 	// Process weapons
 	while (!weaponLoot.empty()) {
 		Weapon* item = weaponLoot.back();
 		weaponLoot.pop_back();
-		std::cout << "- " << item->getName() << " (Attack: +" << item->getAttackBonus() << ")\n";
-		player->addWeapon(item);
+		Console::publish({ .type = GameEventType::ITEM_FOUND, .text = item->getName(), .value = item->getAttackBonus(), .kind = ItemKind::WEAPON });
+		player->addWeapon(*item);
+		delete item;
 	}
 
 	// Process armor
 	while (!armorLoot.empty()) {
 		Armor* item = armorLoot.back();
 		armorLoot.pop_back();
-		std::cout << "- " << item->getName() << " (Defense: +" << item->getDefenseBonus() << ")\n";
-		player->addArmor(item);
+		Console::publish({ .type = GameEventType::ITEM_FOUND, .text = item->getName(), .value = item->getDefenseBonus(), .kind = ItemKind::ARMOR });
+		player->addArmor(*item);
+		delete item;
 	}
 
 	// Process potions
 	while (!potionLoot.empty()) {
 		Potion* item = potionLoot.back();
 		potionLoot.pop_back();
-		std::cout << "- " << item->getName() << " (Heals: +" << item->getHealAmount() << " HP)\n";
-		player->addPotion(item);
+		Console::publish({ .type = GameEventType::ITEM_FOUND, .text = item->getName(), .value = item->getHealAmount(), .kind = ItemKind::POTION });
+		player->addPotion(*item);
+		delete item;
 	}
 }
 
-size_t Scene::getPlayerChoice(Player* player, const std::vector<Choice*>& listChoice) {
-	// Display choices
-	for (size_t i = 0; i < listChoice.size(); ++i) {
-		std::cout << i + 1 << ". " << listChoice[i]->getDescription() << "\n";
-	}
-	// Add inventory access option
-	std::cout << listChoice.size() + 1 << ". Open inventory\n";
-	std::cout << "\nEnter your choice (1-" << listChoice.size() + 1 << "): ";
+size_t Scene::getPlayerChoice(Player* player, const TrackedVector<Choice*, MemTag::STORY>& listChoice, bool offerRewind) {
+	// A loop rather than recursion: remote clients can queue any number of prompts in one line
+	while (true) {
+		size_t width = Layout::width();
+		const std::string& menu = menuCache.get(width, [&](std::string& out) {
+			// Display choices, continuation lines aligned with the label
+			for (size_t i = 0; i < listChoice.size(); ++i) {
+				std::string line = std::to_string(i + 1) + ". ";
+				size_t indent = line.size();
+				line += listChoice[i]->getDescription();
+				Layout::wrap(out, line, width, indent);
+				out += "\n";
+			}
+			// Add inventory access option
+			out += tr(StringID::OPEN_INVENTORY, listChoice.size() + 1);
+		});
+		Console::out().write(menu.data(), static_cast<std::streamsize>(menu.size()));
+
+		size_t options = listChoice.size() + 1;
+		if (offerRewind) {
+			Console::out() << tr(StringID::REWIND_OPTION, ++options);
+		}
+		Console::out() << tr(StringID::CHOICE_PROMPT, options);
+
+		// Inventory commands typed here open the inventory and run there
+		size_t inventory = listChoice.size() + 1;
+		const CommandVerb verbs[] = {
+			{ "go", 0, VerbUse::NUMBERED },
+			{ "inv", inventory },
+			{ "inventory", inventory },
+			{ "status", inventory, VerbUse::FORWARD },
+			{ "equip", inventory, VerbUse::FORWARD },
+			{ "wear", inventory, VerbUse::FORWARD },
+			{ "drink", inventory, VerbUse::FORWARD },
+			{ "drop", inventory, VerbUse::FORWARD },
+			{ "rewind", inventory + 1 }
+		};
 
-	size_t input;
-	validateInput(input, listChoice.size() + 1);
+		size_t input;
+		validateInput(input, options, verbs);
 
-	if (input == 0) {
-		return getPlayerChoice(player, listChoice);
-	}
-	// Handle inventory option
-	if (input == listChoice.size() + 1) {
-		player->manageInventory();
-		display();
-		return getPlayerChoice(player, listChoice);
+		if (input == 0) {
+			continue;
+		}
+		// Handle inventory option
+		if (input == listChoice.size() + 1) {
+			player->manageInventory();
+			display();
+			continue;
+		}
+
+		return input;
 	}
+}
+
+namespace {
 
-	return input;
+/**
+ * @brief Roll check of a choice; the choice's minimum roll is bound as "target"
+ */
+const DiceExpression& rollCheckDice() {
+	static const DiceExpression check = [] {
+		DiceExpression expression;
+		std::string error;
+		[[maybe_unused]] bool compiled = DiceExpression::compile("1d20>=target", { "target" }, expression, error);
+		assert(compiled && "the roll check must compile");
+		return expression;
+	}();
+	return check;
 }
 
-bool Scene::processRollCheck(const Choice* choice) const {
+} // namespace
+
+bool Scene::processRollCheck(const Choice* choice, Player* player) const {
 	int minRoll = choice->getMinRoll();
 
 	if (minRoll <= 0) {
 		return true;  // No roll check needed
 	}
 
-	std::cout << "Rolling check (D20)...\n";
-	int roll = rollDice(20);
-	std::this_thread::sleep_for(std::chrono::milliseconds(500));
-	std::cout << "You rolled: " << roll << "\n";
+	const DiceExpression& check = rollCheckDice();
+	Console::out() << tr(StringID::ROLL_CHECK);
+	int roll = check.roll(ThreadDice{}, { minRoll });
+	if (JournalSession* journal = player->getJournal()) {
+		journal->recordRoll(check.largestDie(), roll);
+	}
+	pacingDelay(500);
+	Console::out() << tr(StringID::YOU_ROLLED, roll);
 
-	if (roll >= minRoll) {
-		std::cout << "You succeeded in roll check!\n";
+	if (check.succeeds(roll, { minRoll })) {
+		Console::out() << tr(StringID::ROLL_CHECK_PASSED);
+		Telemetry::recordRollCheck(true);
 		return true;
 	}
 
-	std::cout << "You failed in roll check\n";
+	Console::out() << tr(StringID::ROLL_CHECK_FAILED);
+	Telemetry::recordRollCheck(false);
 	return false;
 }
 
-Scene* Scene::handleCombatOutcome(Player* player, Enemy* currentEnemy, Scene* currentScene) {
-	if (!currentEnemy || !currentEnemy->isAlive()) {
+Scene* Scene::handleCombatOutcome(Player* player, Scene* currentScene) {
+	if (!hasEnemy()) {
 		return nullptr;  // No combat needed
 	}
 
-	if (!combat(player, currentEnemy)) {
+	if (!combat(player, encounter)) {
 		if (!player->isAlive()) {
-			std::cout << "\nGAME OVER - You died.\n";
+			Console::out() << tr(StringID::GAME_OVER_DIED);
 			return nullptr;
 		}
-		std::cout << "You fled, but the enemy will remain there upon your return.\n";
+		Console::out() << tr(StringID::FLED_ENEMY_REMAINS);
 		return currentScene;
 	}
 
@@ -189,31 +295,42 @@ Scene* Scene::handleCombatOutcome(Player* player, Enemy* currentEnemy, Scene* cu
 	return nullptr;  // Combat successfully completed
 }
 
-Scene* Scene::processInput(Player* player) {
-	// Handle initial loot if there's no enemy or enemy is dead
-	if (!enemy || !enemy->isAlive()) {
+Scene* Scene::processInput(Player* player, bool* rewindRequested) {
+	TraceSpan span("Scene::processInput", "engine");
+	Telemetry::recordSceneVisit(sceneNumber);
+
+	// Handle initial loot if there's no enemy or all enemies are dead
+	if (!hasEnemy()) {
 		distributeLoot(player);
 	}
 
 	// Check if game should end
 	if (choices.empty()) {
-		std::cout << "\nGame over!\n - The End - \n";
+		Console::out() << tr(StringID::THE_END);
 		return nullptr;
 	}
 
 	// Get player's choice
-	std::cout << "\n";
-	size_t input = getPlayerChoice(player, choices);
+	Console::out() << "\n";
+	size_t input = getPlayerChoice(player, choices, rewindRequested != nullptr);
+	if (input == choices.size() + 2) {
+		*rewindRequested = true;
+		return nullptr;
+	}
 	const Choice* selectedChoice = choices[input - 1];
+	Telemetry::recordChoice(sceneNumber, input - 1);
+	if (JournalSession* journal = player->getJournal()) {
+		journal->recordChoice(sceneNumber, input - 1);
+	}
 
 	// Handle roll check if needed
-	if (!processRollCheck(selectedChoice)) {
+	if (!processRollCheck(selectedChoice, player)) {
 		return selectedChoice->getFailScene();
 	}
 
 	// Handle combat if needed
-	if (enemy && enemy->isAlive() && input == 1) {
-		Scene* combatResult = handleCombatOutcome(player, enemy, this);
+	if (hasEnemy() && input == 1) {
+		Scene* combatResult = handleCombatOutcome(player, this);
 		if (combatResult != nullptr) {
 			return combatResult;
 		}
@@ -222,119 +339,430 @@ Scene* Scene::processInput(Player* player) {
 	return selectedChoice->getNextScene();
 }
 
+bool Scene::hasEnemy() const {
+	return encounter.countLiving(Side::ENEMY) > 0;
+}
+
+int Scene::getSceneNumber() const {
+	return sceneNumber;
+}
+
+const Encounter& Scene::getEncounter() const {
+	return encounter;
+}
+
+void Scene::takeStateFrom(Scene& previous) {
+	// Swap so the previous scene cleans up the fresh loot
+	std::swap(encounter, previous.encounter);
+	std::swap(weaponLoot, previous.weaponLoot);
+	std::swap(armorLoot, previous.armorLoot);
+	std::swap(potionLoot, previous.potionLoot);
+	std::swap(looted, previous.looted);
+}
+
+void Scene::restoreState(const SceneState& state) {
+	for (size_t i = 0; i < encounter.size(); ++i) {
+		int hp = i < state.hitPoints.size() ? state.hitPoints[i] : -1;
+		encounter.setHitPoints(i, hp >= 0 ? hp : encounter.getMaxHitPoints(i));
+	}
+	if (state.looted) {
+		for (Weapon* weapon : weaponLoot) {
+			delete weapon;
+		}
+		for (Armor* armor : armorLoot) {
+			delete armor;
+		}
+		for (Potion* potion : potionLoot) {
+			delete potion;
+		}
+		weaponLoot.clear();
+		armorLoot.clear();
+		potionLoot.clear();
+	}
+	looted = state.looted;
+}
+
+bool Scene::captureState(SceneState& state) const {
+	state.hitPoints.clear();
+	bool changed = looted;
+	for (size_t i = 0; i < encounter.size(); ++i) {
+		int hp = encounter.getHitPoints(i);
+		bool untouched = hp == encounter.getMaxHitPoints(i);
+		state.hitPoints.push_back(untouched ? -1 : hp);
+		changed = changed || !untouched;
+	}
+	if (!changed) {
+		state.hitPoints.clear();
+	}
+	state.looted = looted;
+	return changed;
+}
+
+bool Scene::isLooted() const {
+	return looted;
+}
+
+bool Scene::isEnding() const {
+	return choices.empty();
+}
+
+namespace {
+
+// Inventory commands typed in combat open the inventory and run there
+constexpr CommandVerb COMBAT_VERBS[] = {
+	{ "attack", 1 },
+	{ "status", 2 },
+	{ "inv", 3 },
+	{ "inventory", 3 },
+	{ "flee", 4 },
+	{ "equip", 3, VerbUse::FORWARD },
+	{ "wear", 3, VerbUse::FORWARD },
+	{ "drink", 3, VerbUse::FORWARD },
+	{ "drop", 3, VerbUse::FORWARD }
+};
+
+void recordDamage(const Encounter& encounter, size_t index, JournalSession* journal) {
+	if (journal) journal->recordCombatantHitPoints(index, encounter.getHitPoints(index));
+}
+
 /**
- * @brief Check enemy existence and whether its alive
+ * @brief Lets the player pick which enemy to attack
  *
- * @return bool True if player won, false if player lost or fled
+ * @return size_t Combatant index, or encounter.size() if cancelled
  */
-bool Scene::hasEnemy() const {
-	return enemy != nullptr && enemy->isAlive();
+size_t chooseTarget(const Encounter& encounter) {
+	std::vector<size_t> targets;
+	for (size_t i = 0; i < encounter.size(); ++i) {
+		if (encounter.getSide(i) == Side::ENEMY && encounter.isAlive(i)) {
+			targets.push_back(i);
+		}
+	}
+	if (targets.size() == 1) {
+		return targets[0];
+	}
+
+	Console::out() << tr(StringID::CHOOSE_TARGET);
+	for (size_t i = 0; i < targets.size(); ++i) {
+		Console::out() << tr(StringID::TARGET_ENTRY, i + 1, encounter.getName(targets[i]), encounter.getHitPoints(targets[i]));
+	}
+	Console::out() << tr(StringID::TARGET_PROMPT);
+
+	size_t input;
+	validateInput(input, targets.size());
+	if (input == 0) {
+		return encounter.size();
+	}
+	return targets[input - 1];
+}
+
+std::string describeFoes(const Encounter& encounter) {
+	size_t foe = encounter.size();
+	for (size_t i = 0; i < encounter.size(); ++i) {
+		if (encounter.getSide(i) != Side::ENEMY) continue;
+		if (foe != encounter.size()) {
+			return std::string(tr(StringID::ENEMIES));
+		}
+		foe = i;
+	}
+	return foe != encounter.size() ? encounter.getName(foe) : std::string(tr(StringID::ENEMIES));
+}
+
+void recordOutcome(const Encounter& encounter, int rounds, CombatOutcome outcome) {
+	for (size_t i = 0; i < encounter.size(); ++i) {
+		if (encounter.getSide(i) == Side::ENEMY) {
+			Telemetry::recordCombat(encounter.getName(i), rounds, outcome);
+		}
+	}
 }
 
 /**
- * @brief Manages a turn-based combat encounter between player and enemy
+ * @brief Tells the player what happens in a fight, with dramatic pauses
+ */
+class CombatText : public CombatSink {
+private:
+	const Player& player;
+	const Encounter& encounter;
+
+	void printDamage(const CombatEvent& event) const {
+		if (event.target == CombatEvent::PLAYER) {
+			Console::publish({ .type = GameEventType::DAMAGE_TAKEN, .text = std::string(player.getName()), .value = event.value,
+				.hitPoints = event.remaining, .maxHitPoints = player.getMaxHitPoints() });
+			return;
+		}
+		Console::out() << tr(StringID::TAKES_DAMAGE, encounter.getName(event.target), event.value);
+		Console::out() << tr(encounter.getSide(event.target) == Side::ENEMY ? StringID::ENEMY_HP : StringID::ALLY_HP,
+			event.remaining, encounter.getMaxHitPoints(event.target));
+	}
+
+	void printAttack(const CombatEvent& event) const {
+		bool hit = event.type == CombatEventType::HIT;
+		if (event.actor == CombatEvent::PLAYER) {
+			Console::out() << tr(StringID::ROLL_ATTACK);
+			pacingDelay(500);
+			Console::out() << tr(StringID::YOU_ROLLED, event.roll);
+			if (!hit) {
+				Console::out() << tr(StringID::CRITICAL_MISS);
+				return;
+			}
+			Console::out() << tr(StringID::YOU_STRIKE, encounter.getName(event.target));
+			printDamage(event);
+			return;
+		}
+
+		const std::string& attacker = encounter.getName(event.actor);
+		if (encounter.getSide(event.actor) == Side::ALLY) {
+			Console::out() << tr(StringID::ALLY_ATTACKS, attacker, encounter.getName(event.target));
+			if (hit) {
+				printDamage(event);
+			}
+			else {
+				Console::out() << tr(StringID::ALLY_MISSES, attacker);
+			}
+			return;
+		}
+
+		bool targetsPlayer = event.target == CombatEvent::PLAYER;
+		pacingDelay(500);
+		Console::out() << tr(StringID::ENEMY_TURN);
+		Console::out() << (targetsPlayer ? tr(StringID::ENEMY_ATTACKS_YOU, attacker)
+			: tr(StringID::ENEMY_ATTACKS, attacker, encounter.getName(event.target)));
+		Console::out() << tr(StringID::ROLL_ENEMY_ATTACK);
+		pacingDelay(500);
+		Console::out() << tr(StringID::ENEMY_ROLLED, event.roll);
+		if (!hit) {
+			Console::out() << tr(StringID::ENEMY_MISSES, attacker);
+			return;
+		}
+		Console::out() << (targetsPlayer ? tr(StringID::ENEMY_HITS_YOU, attacker)
+			: tr(StringID::ENEMY_HITS, attacker, encounter.getName(event.target)));
+		printDamage(event);
+	}
+
+public:
+	// Constructor
+	CombatText(const Player& reader, const Encounter& fight) : player(reader), encounter(fight) {}
+
+	void onEvent(const CombatEvent& event) override {
+		switch (event.type) {
+		case CombatEventType::BEGIN:
+			Console::out() << tr(StringID::COMBAT_BEGINS);
+			break;
+		case CombatEventType::JOIN:
+			Console::out() << tr(encounter.getSide(event.actor) == Side::ENEMY ? StringID::FACE_ENEMY : StringID::ALLY_JOINS,
+				encounter.getName(event.actor), event.value);
+			break;
+		case CombatEventType::MINDBLAST:
+			Console::out() << tr(StringID::MINDBLAST_USED, event.value, event.remaining);
+			break;
+		case CombatEventType::MIND_ATTACK:
+			if (event.value == 0) {
+				Console::out() << tr(StringID::MIND_ATTACK_BLOCKED, encounter.getName(event.actor));
+			}
+			else {
+				Console::out() << tr(StringID::MIND_ATTACK, encounter.getName(event.actor), event.value);
+			}
+			break;
+		case CombatEventType::HIT:
+		case CombatEventType::MISS:
+			printAttack(event);
+			break;
+		case CombatEventType::FLED:
+		case CombatEventType::FLEE_FAILED:
+			Console::out() << tr(StringID::ROLL_ESCAPE);
+			pacingDelay(500);
+			Console::out() << tr(StringID::YOU_ROLLED, event.roll);
+			Console::out() << (event.type == CombatEventType::FLED ? tr(StringID::ESCAPED, describeFoes(encounter))
+				: tr(StringID::ESCAPE_FAILED));
+			break;
+		case CombatEventType::VICTORY:
+			Console::out() << tr(StringID::VICTORY, describeFoes(encounter));
+			break;
+		case CombatEventType::DEFEAT:
+			Console::out() << tr(StringID::DEFEATED_BY, describeFoes(encounter));
+			break;
+		default:
+			break;
+		}
+	}
+};
+
+/**
+ * @brief Effects that last for one fight: the player's Mindblast and the foes' mind attack
+ *
+ * Applied when the fight begins and removed however it ends.
+ */
+class FightEffects {
+private:
+	Player* player;
+
+public:
+	// Constructor
+	FightEffects(Player* fighter, const Encounter& encounter, CombatStream& events) : player(fighter) {
+		if (player->hasSkill(Skill::MINDBLAST)) {
+			player->addEffect(Stat::ATTACK, MINDBLAST_BONUS, std::string(tr(StringID::SKILL_MINDBLAST)), MINDBLAST_ROUNDS);
+			events.emit({ CombatEventType::MINDBLAST, CombatEvent::PLAYER, 0, 0, MINDBLAST_BONUS, MINDBLAST_ROUNDS });
+		}
+		size_t attacker = encounter.mindAttacker();
+		if (attacker == encounter.size()) return;
+		int penalty = player->hasSkill(Skill::MINDSHIELD) ? 0 : encounter.getMindAttack(attacker);
+		if (penalty > 0) {
+			player->addEffect(Stat::ATTACK, -penalty, tr(StringID::MIND_ATTACK_EFFECT, encounter.getName(attacker)));
+		}
+		events.emit({ CombatEventType::MIND_ATTACK, CombatStream::actorOf(attacker), CombatEvent::PLAYER, 0, static_cast<int16_t>(penalty) });
+	}
+
+	// Destructor
+	~FightEffects() {
+		player->endCombat();
+	}
+
+	// Delete Copy Constructor - prevent copying
+	FightEffects(const FightEffects&) = delete;
+
+	// Delete Copy Assignment Operator - prevent assignment
+	FightEffects& operator=(const FightEffects&) = delete;
+};
+
+} // namespace
+
+/**
+ * @brief Manages a turn-based combat encounter between the player's side and the enemies
  *
  * @param player Pointer to the player object
- * @param enemy Pointer to the enemy object
+ * @param encounter Combatants fighting with and against the player
  * @return bool True if player won, false if player lost or fled
  */
-bool combat(Player* player, Enemy* enemy) {
-	std::cout << "\n- - - COMBAT BEGINS - - -\n";
-	std::cout << "You face a " << enemy->getName() << " (HP: " << enemy->getHitPoints() << ")\n";
-
-	while (player->isAlive() && enemy->isAlive()) {
-		std::cout << "\nYour turn:\n";
-		std::cout << "1. Attack\n";
-		std::cout << "2. Check status\n";
-		std::cout << "3. Manage inventory\n";
-		std::cout << "4. Try to flee\n";
-		std::cout << "\nEnter your choice: ";
+bool combat(Player* player, Encounter& encounter) {
+	JournalSession* journal = player->getJournal();
+	const CombatDice& rules = Encounter::dice();
+	CombatText text(*player, encounter);
+	CombatStream events(encounter, &text);
+	FightEffects effects(player, encounter, events);
+
+	int rounds = 0;
+	while (player->isAlive() && encounter.countLiving(Side::ENEMY) > 0) {
+		TraceSpan roundSpan("combat round", "combat");
+		// The last round is on disk before the player decides the next one
+		if (journal) journal->sync();
+		Console::out() << tr(StringID::COMBAT_MENU);
 
 		size_t input;
-		validateInput(input, 4);
+		validateInput(input, 4, COMBAT_VERBS);
 
 		switch (input) {
 		case 1: {
-			std::cout << "Rolling attack dice (D20)...\n";
-			int roll = rollDice(20);
-			std::this_thread::sleep_for(std::chrono::milliseconds(500));
-			std::cout << "You rolled: " << roll << "\n";
-
-			if (roll >= 5) { // Hit threshold
-				int damage = player->getTotalAttack() + rollDice(6);
-				std::cout << "You strike the " << enemy->getName() << "!\n";
-				enemy->takeDamage(damage);
+			size_t target = chooseTarget(encounter);
+			if (target == encounter.size()) {
+				continue;
+			}
+			rounds++;
+			int roll = rules.playerHit.roll(ThreadDice{});
+			if (journal) journal->recordRoll(rules.playerHit.largestDie(), roll);
+
+			if (rules.playerHit.succeeds(roll)) {
+				int damage = rules.playerDamage.roll(ThreadDice{}, { player->getTotalAttack() });
+				damage = encounter.takeDamage(target, damage);
+				recordDamage(encounter, target, journal);
+				events.attack(CombatEvent::PLAYER, CombatStream::actorOf(target), roll, true, damage, encounter.getHitPoints(target));
 			}
 			else {
-				std::cout << "Critical miss! You missed your attack\n";
+				events.attack(CombatEvent::PLAYER, CombatStream::actorOf(target), roll, false);
 			}
 			break;
 		}
 
 		case 2:
 			player->displayStatus();
-			std::cout << enemy->getName() << " HP: " << enemy->getHitPoints()
-				<< "/" << enemy->getMaxHitPoints() << "\n";
+			for (size_t i = 0; i < encounter.size(); ++i) {
+				Console::out() << tr(StringID::COMBATANT_HP, encounter.getName(i), encounter.getHitPoints(i), encounter.getMaxHitPoints(i));
+			}
 			continue;
 
 		case 3:
-			std::cout << "\nNote: Potions cannot be used during combat.\n";
+			Console::out() << tr(StringID::NO_POTIONS_IN_COMBAT);
 			player->manageInventory();
 			continue;
 
 		case 4: {
-			std::cout << "Rolling escape dice (D20)...\n";
-			int roll = rollDice(20);
-			std::this_thread::sleep_for(std::chrono::milliseconds(500));
-			std::cout << "You rolled: " << roll << "\n";
-
-			if (roll >= 12) {
-				std::cout << "You successfully escape from the " << enemy->getName() << "!\n";
+			rounds++;
+			int roll = rules.flee.roll(ThreadDice{});
+			if (journal) journal->recordRoll(rules.flee.largestDie(), roll);
+			bool escaped = rules.flee.succeeds(roll);
+			events.flee(roll, escaped);
+
+			if (escaped) {
+				recordOutcome(encounter, rounds, CombatOutcome::FLEE);
 				return false; // Combat ends, player escaped
 			}
-			else {
-				std::cout << "You failed to escape!\n";
-			}
 			break;
 		}
 
 		case 0:
-			std::cout << "Cannot cancel during combat.\n";
+			Console::out() << tr(StringID::CANNOT_CANCEL_COMBAT);
 			continue;
 
 		default:
-			std::cout << "Invalid choice. Please try again.\n";
+			Console::out() << tr(StringID::INVALID_CHOICE_RETRY);
 			continue;
 		}
 
-		// Enemy's turn
-		if (enemy->isAlive()) {
-			std::this_thread::sleep_for(std::chrono::milliseconds(500));
-			std::cout << "\nEnemy's turn:\n";
-			std::cout << "The " << enemy->getName() << " attacks you!\n";
-			std::cout << "Rolling enemy attack dice (D20)...\n";
-			int roll = rollDice(20);
-			std::this_thread::sleep_for(std::chrono::milliseconds(500));
-			std::cout << "Enemy rolled: " << roll << "\n";
-
-			if (roll >= 8) { // Hit atk threshold
-				int damage = enemy->getAttackValue() + rollDice(4); // randomize attack value
-				std::cout << "HIT! The " << enemy->getName() << " strikes you!\n";
-				player->takeDamage(damage);
+		// Allies' turn
+		for (size_t i = 0; i < encounter.size(); ++i) {
+			if (encounter.getSide(i) != Side::ALLY || !encounter.isAlive(i)) continue;
+			size_t target = encounter.weakestEnemy();
+			if (target == encounter.size()) break;
+
+			int roll = rules.playerHit.roll(ThreadDice{});
+			if (rules.playerHit.succeeds(roll)) {
+				int damage = rules.playerDamage.roll(ThreadDice{}, { encounter.getAttackValue(i) });
+				damage = encounter.takeDamage(target, damage);
+				recordDamage(encounter, target, journal);
+				events.attack(CombatStream::actorOf(i), CombatStream::actorOf(target), roll, true, damage, encounter.getHitPoints(target));
+			}
+			else {
+				events.attack(CombatStream::actorOf(i), CombatStream::actorOf(target), roll, false);
+			}
+		}
+
+		// Enemies' turn
+		for (size_t i = 0; i < encounter.size() && player->isAlive(); ++i) {
+			if (encounter.getSide(i) != Side::ENEMY || !encounter.isAlive(i)) continue;
+
+			size_t target = encounter.enemyTarget(i);
+			bool targetsPlayer = target == encounter.size();
+			uint8_t targetActor = targetsPlayer ? CombatEvent::PLAYER : CombatStream::actorOf(target);
+			int roll = rules.enemyHit.roll(ThreadDice{});
+			if (journal) journal->recordRoll(rules.enemyHit.largestDie(), roll);
+
+			if (rules.enemyHit.succeeds(roll)) { // Hit atk threshold
+				int damage = rules.enemyDamage.roll(ThreadDice{}, { encounter.getAttackValue(i) }); // randomize attack value
+				if (targetsPlayer) {
+					damage = player->takeDamage(damage);
+				}
+				else {
+					damage = encounter.takeDamage(target, damage);
+					recordDamage(encounter, target, journal);
+				}
+				int remaining = targetsPlayer ? player->getHitPoints() : encounter.getHitPoints(target);
+				events.attack(CombatStream::actorOf(i), targetActor, roll, true, damage, remaining);
 			}
 			else {
-				std::cout << "MISS! The " << enemy->getName() << " fails to hit you.\n";
+				events.attack(CombatStream::actorOf(i), targetActor, roll, false);
 			}
 		}
 
+		player->endCombatRound();
+
 		// Check if combat is over
 		if (!player->isAlive()) {
-			std::cout << "\nYou have been defeated by the " << enemy->getName() << ".\n";
+			events.end(false);
+			recordOutcome(encounter, rounds, CombatOutcome::DEATH);
 			return false;
 		}
 
-		if (!enemy->isAlive()) {
-			std::cout << "\nVictory! You defeated the " << enemy->getName() << ".\n";
+		if (encounter.countLiving(Side::ENEMY) == 0) {
+			events.end(true);
+			recordOutcome(encounter, rounds, CombatOutcome::WIN);
 			return true;
 		}
 	}
@@ -0,0 +1,946 @@
+#include "server.h"
+#include <iostream>
+
+#ifdef __linux__
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <queue>
+#include <streambuf>
+#include <thread>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <ucontext.h>
+#include <unistd.h>
+#include "console.h"
+#include "layout.h"
+
+namespace {
+
+constexpr size_t FIBER_STACK_SIZE = 256 * 1024;
+constexpr size_t MAX_PENDING_INPUT = 64 * 1024;   // Clients sending more without a newline are dropped
+constexpr size_t OUTPUT_FLUSH_SIZE = 64 * 1024;
+constexpr size_t READ_CHUNK_SIZE = 16 * 1024;
+constexpr int MAX_EVENTS = 256;
+constexpr int LISTEN_BACKLOG = 4096;
+
+int supervisorWakeFd = -1;   // Wakes the supervising process when a worker process ends
+
+void wakeSupervisor(int) {
+	int savedErrno = errno;
+	uint64_t one = 1;
+	[[maybe_unused]] ssize_t written = write(supervisorWakeFd, &one, sizeof(one));
+	errno = savedErrno;
+}
+
+/**
+ * @brief Thrown into a session's game when its client has disconnected
+ */
+struct SessionClosed {};
+
+struct Address {
+	bool isUnix = false;
+	std::string path;
+	int port = 0;
+};
+
+bool parseAddress(const std::string& text, Address& address, std::string& error) {
+	if (text.rfind("unix:", 0) == 0) {
+		address.isUnix = true;
+		address.path = text.substr(5);
+		if (address.path.empty() || address.path.size() >= sizeof(sockaddr_un::sun_path)) {
+			error = "invalid unix socket path";
+			return false;
+		}
+		return true;
+	}
+	std::string port = text.rfind("tcp:", 0) == 0 ? text.substr(4) : text;
+	char* end = nullptr;
+	long value = std::strtol(port.c_str(), &end, 10);
+	if (port.empty() || *end != '\0' || value <= 0 || value > 65535) {
+		error = "address must be unix:<path>, tcp:<port> or <port>";
+		return false;
+	}
+	address.port = static_cast<int>(value);
+	return true;
+}
+
+/**
+ * @brief Opens a socket bound to (listen) or connected to (!listen) an address
+ *
+ * @return int File descriptor, or -1 on failure
+ */
+int openSocket(const Address& address, bool listen, std::string& error) {
+	int fd = socket(address.isUnix ? AF_UNIX : AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (fd < 0) {
+		error = std::string("socket: ") + std::strerror(errno);
+		return -1;
+	}
+
+	sockaddr_storage storage{};
+	socklen_t length;
+	if (address.isUnix) {
+		auto* unixAddress = reinterpret_cast<sockaddr_un*>(&storage);
+		unixAddress->sun_family = AF_UNIX;
+		std::strncpy(unixAddress->sun_path, address.path.c_str(), sizeof(unixAddress->sun_path) - 1);
+		length = sizeof(sockaddr_un);
+		if (listen) {
+			unlink(address.path.c_str());
+		}
+	}
+	else {
+		// Loopback only: the protocol has no authentication or encryption
+		auto* inetAddress = reinterpret_cast<sockaddr_in*>(&storage);
+		inetAddress->sin_family = AF_INET;
+		inetAddress->sin_port = htons(static_cast<uint16_t>(address.port));
+		inetAddress->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		length = sizeof(sockaddr_in);
+		int on = 1;
+		setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+	}
+
+	const auto* socketAddress = reinterpret_cast<const sockaddr*>(&storage);
+	bool ok = listen ? (bind(fd, socketAddress, length) == 0 && ::listen(fd, LISTEN_BACKLOG) == 0)
+		: connect(fd, socketAddress, length) == 0;
+	if (!ok) {
+		error = std::string(listen ? "bind: " : "connect: ") + std::strerror(errno);
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+void setNonBlocking(int fd) {
+	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+}
+
+} // namespace
+
+/**
+ * @brief Runs session fibers pinned to one thread
+ */
+struct GameServer::Worker {
+	using Timer = std::pair<std::chrono::steady_clock::time_point, Session*>;
+
+	std::mutex mutex;
+	std::condition_variable wakeup;
+	std::deque<Session*> ready;
+	std::priority_queue<Timer, std::vector<Timer>, std::greater<>> timers;
+	bool stopping = false;
+	ucontext_t schedulerContext;
+	size_t width = 0;
+	std::thread thread;
+
+	void schedule(Session* session) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			ready.push_back(session);
+		}
+		wakeup.notify_one();
+	}
+
+	void run();
+	void resume(Session* session);
+};
+
+/**
+ * @brief One connected client and the fiber playing its game
+ */
+struct GameServer::Session : public ConsoleHost {
+	/**
+	 * @brief Hands the game the bytes the event loop received, yielding while there are none
+	 */
+	class InputBuffer : public std::streambuf {
+	private:
+		Session& session;
+		std::string chunk;
+
+	public:
+		explicit InputBuffer(Session& owner) : session(owner) {
+		}
+
+	protected:
+		int_type underflow() override {
+			if (gptr() < egptr()) {
+				return traits_type::to_int_type(*gptr());
+			}
+			chunk.clear();
+			session.takeInput(chunk);
+			setg(chunk.data(), chunk.data(), chunk.data() + chunk.size());
+			return traits_type::to_int_type(*gptr());
+		}
+	};
+
+	/**
+	 * @brief Collects game output until the fiber yields
+	 */
+	class OutputBuffer : public std::streambuf {
+	private:
+		Session& session;
+
+	public:
+		std::string pending;
+
+		explicit OutputBuffer(Session& owner) : session(owner) {
+		}
+
+	protected:
+		int_type overflow(int_type c) override {
+			if (!traits_type::eq_int_type(c, traits_type::eof())) {
+				pending.push_back(traits_type::to_char_type(c));
+			}
+			return traits_type::not_eof(c);
+		}
+
+		std::streamsize xsputn(const char* text, std::streamsize count) override {
+			pending.append(text, static_cast<size_t>(count));
+			if (pending.size() >= OUTPUT_FLUSH_SIZE) {
+				session.flushOutput();
+			}
+			return count;
+		}
+	};
+
+	GameServer& server;
+	Worker& worker;
+	int fd;
+	InputBuffer inputBuffer;
+	OutputBuffer outputBuffer;
+	std::istream input;
+	std::ostream output;
+	ucontext_t context;
+	char* stack = nullptr;
+	bool fiberDone = false;   // Worker thread only
+
+	std::mutex mutex;   // Guards the fields below, shared with the event loop
+	std::string inbox;
+	std::string outbox;
+	bool waitingForInput = false;
+	bool peerClosed = false;
+	bool finished = false;
+	bool queuedForWrite = false;
+
+	std::string writeBuffer;   // Event loop only
+	size_t writeOffset = 0;
+	bool writeInterest = false;
+
+	Session(GameServer& owner, Worker& pinned, int socket)
+		: server(owner), worker(pinned), fd(socket), inputBuffer(*this), outputBuffer(*this),
+		input(&inputBuffer), output(&outputBuffer) {
+		// Report a vanished client to the game as an exception instead of endless EOF
+		input.exceptions(std::ios::badbit);
+
+		// Stacks are reserved lazily, so idle sessions only hold the pages they touched
+		void* memory = mmap(nullptr, FIBER_STACK_SIZE, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_STACK, -1, 0);
+		if (memory == MAP_FAILED) {
+			return;
+		}
+		stack = static_cast<char*>(memory);
+		mprotect(stack, static_cast<size_t>(sysconf(_SC_PAGESIZE)), PROT_NONE);   // Guard page
+
+		getcontext(&context);
+		context.uc_stack.ss_sp = stack;
+		context.uc_stack.ss_size = FIBER_STACK_SIZE;
+		context.uc_link = &worker.schedulerContext;
+		auto address = reinterpret_cast<uintptr_t>(this);
+		makecontext(&context, reinterpret_cast<void (*)()>(&Session::fiberMain), 2,
+			static_cast<unsigned>(address >> 32), static_cast<unsigned>(address & 0xFFFFFFFFu));
+	}
+
+	~Session() override {
+		if (stack) {
+			munmap(stack, FIBER_STACK_SIZE);
+		}
+	}
+
+	static void fiberMain(unsigned high, unsigned low) {
+		auto* session = reinterpret_cast<Session*>((static_cast<uintptr_t>(high) << 32) | low);
+		try {
+			session->server.sessionMain();
+		}
+		catch (const SessionClosed&) {
+			// Client left; unwinding has cleaned up the game
+		}
+		catch (const std::exception& e) {
+			std::cerr << "[server] session ended by error: " << e.what() << "\n";
+		}
+		session->output.flush();
+		session->fiberDone = true;
+	}
+
+	std::istream& in() override {
+		return input;
+	}
+
+	std::ostream& out() override {
+		return output;
+	}
+
+	void pause(std::chrono::milliseconds duration) override {
+		flushOutput();
+		{
+			std::lock_guard<std::mutex> lock(worker.mutex);
+			worker.timers.emplace(std::chrono::steady_clock::now() + duration, this);
+		}
+		yield();
+	}
+
+	bool sharesThread() const override {
+		return true;
+	}
+
+	/**
+	 * @brief Moves all received input into chunk, yielding until there is some
+	 */
+	void takeInput(std::string& chunk) {
+		while (true) {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				if (!inbox.empty()) {
+					chunk.swap(inbox);
+					return;
+				}
+				if (peerClosed) {
+					throw SessionClosed();
+				}
+				waitingForInput = true;
+			}
+			flushOutput();
+			yield();
+		}
+	}
+
+	void flushOutput() {
+		if (outputBuffer.pending.empty()) {
+			return;
+		}
+		bool notify;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			outbox.append(outputBuffer.pending);
+			notify = !queuedForWrite;
+			queuedForWrite = true;
+		}
+		outputBuffer.pending.clear();
+		if (notify) {
+			server.queueWrite(this);
+		}
+	}
+
+	/**
+	 * @brief Hands the last output to the event loop; the worker must not touch the session afterwards
+	 */
+	void finish() {
+		bool notify;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			outbox.append(outputBuffer.pending);
+			finished = true;
+			notify = !queuedForWrite;
+			queuedForWrite = true;
+		}
+		if (notify) {
+			server.queueWrite(this);
+		}
+	}
+
+	void yield() {
+		swapcontext(&context, &worker.schedulerContext);
+	}
+};
+
+void GameServer::Worker::run() {
+	while (true) {
+		Session* session = nullptr;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			while (!session) {
+				// Due timers first so pacing is not starved by busy sessions
+				if (!timers.empty() && timers.top().first <= std::chrono::steady_clock::now()) {
+					session = timers.top().second;
+					timers.pop();
+				}
+				else if (!ready.empty()) {
+					session = ready.front();
+					ready.pop_front();
+				}
+				else if (stopping && timers.empty()) {
+					return;
+				}
+				else if (timers.empty()) {
+					wakeup.wait(lock);
+				}
+				else {
+					wakeup.wait_until(lock, timers.top().first);
+				}
+			}
+		}
+		resume(session);
+	}
+}
+
+void GameServer::Worker::resume(Session* session) {
+	Console::setHost(session);
+	Layout::setThreadWidth(width);
+	swapcontext(&schedulerContext, &session->context);
+	Console::setHost(nullptr);
+
+	// The fiber has returned to this stack, so the event loop may now free it
+	if (session->fiberDone) {
+		session->finish();
+	}
+}
+
+GameServer::GameServer(const ServerConfig& serverConfig, SessionMain main)
+	: config(serverConfig), sessionMain(std::move(main)) {
+}
+
+GameServer::~GameServer() {
+	for (auto& worker : workers) {
+		{
+			std::lock_guard<std::mutex> lock(worker->mutex);
+			worker->stopping = true;
+		}
+		worker->wakeup.notify_one();
+		if (worker->thread.joinable()) {
+			worker->thread.join();
+		}
+	}
+	for (auto& [fd, session] : sessions) {
+		close(fd);
+	}
+	if (listenFd >= 0) close(listenFd);
+	if (epollFd >= 0) close(epollFd);
+	if (wakeFd >= 0) close(wakeFd);
+	if (spareFd >= 0) close(spareFd);
+	if (!workerProcess && config.address.rfind("unix:", 0) == 0) {
+		unlink(config.address.substr(5).c_str());
+	}
+}
+
+bool GameServer::start(std::string& error) {
+	Address address;
+	if (!parseAddress(config.address, address, error)) {
+		return false;
+	}
+
+	// Every connection is a descriptor; allow as many as the hard limit permits
+	rlimit limit;
+	if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+		limit.rlim_cur = limit.rlim_max;
+		setrlimit(RLIMIT_NOFILE, &limit);
+	}
+
+	listenFd = openSocket(address, true, error);
+	if (listenFd < 0) {
+		return false;
+	}
+	setNonBlocking(listenFd);
+	isUnixSocket = address.isUnix;
+
+	if (config.processes > 0) {
+		// Worker processes are forked by run(), after the caller has set up its signal handlers
+		wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		if (wakeFd < 0) {
+			error = std::string("eventfd: ") + std::strerror(errno);
+			return false;
+		}
+		std::cerr << "[server] listening on " << config.address << " with " << config.processes << " worker processes\n";
+		return true;
+	}
+	return startWorkers(error);
+}
+
+bool GameServer::startWorkers(std::string& error) {
+	spareFd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+	epollFd = epoll_create1(EPOLL_CLOEXEC);
+	wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (epollFd < 0 || wakeFd < 0) {
+		error = std::string("epoll: ") + std::strerror(errno);
+		return false;
+	}
+	epoll_event event{};
+	event.events = EPOLLIN;
+	if (workerProcess) {
+		event.events |= EPOLLEXCLUSIVE;   // Only one worker process is woken per connection
+	}
+	event.data.fd = listenFd;
+	epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+	event.events = EPOLLIN;
+	event.data.fd = wakeFd;
+	epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+
+	int cores = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+	int count = config.workers > 0 ? config.workers : std::max(1, cores / std::max(1, config.processes));
+	for (int i = 0; i < count; ++i) {
+		auto worker = std::make_unique<Worker>();
+		worker->width = config.width;
+		Worker* raw = worker.get();
+		worker->thread = std::thread([raw] { raw->run(); });
+		workers.push_back(std::move(worker));
+	}
+
+	if (!workerProcess) {
+		std::cerr << "[server] listening on " << config.address << " with " << count << " workers\n";
+	}
+	return true;
+}
+
+void GameServer::spawnProcess() {
+	pid_t pid = fork();
+	if (pid < 0) {
+		std::cerr << "[server] fork: " << std::strerror(errno) << "\n";
+		return;
+	}
+	if (pid > 0) {
+		processes.push_back(pid);
+		return;
+	}
+
+	// Worker process: an event loop of its own on the inherited listening socket
+	std::signal(SIGCHLD, SIG_DFL);
+	close(wakeFd);
+	wakeFd = -1;
+	processes.clear();
+	workerProcess = true;
+	std::string error;
+	if (!startWorkers(error)) {
+		std::cerr << "[server] worker process " << getpid() << ": " << error << "\n";
+		_exit(1);
+	}
+	if (stopRequested.load()) {
+		wake();   // Stopped before the event loop could be woken
+	}
+	run();
+	std::cout.flush();
+	_exit(0);
+}
+
+void GameServer::superviseProcesses() {
+	supervisorWakeFd = wakeFd;
+	struct sigaction action {};
+	action.sa_handler = wakeSupervisor;
+	sigemptyset(&action.sa_mask);
+	action.sa_flags = SA_RESTART | SA_NOCLDSTOP;
+	sigaction(SIGCHLD, &action, nullptr);
+
+	for (int i = 0; i < config.processes; ++i) {
+		spawnProcess();
+	}
+
+	bool stopping = false;
+	while (!(stopping && processes.empty())) {
+		pollfd wakeup{ wakeFd, POLLIN, 0 };
+		if (poll(&wakeup, 1, -1) < 0 && errno != EINTR) {
+			std::cerr << "[server] poll: " << std::strerror(errno) << "\n";
+			break;
+		}
+		uint64_t value;
+		while (read(wakeFd, &value, sizeof(value)) > 0) {
+		}
+
+		int status;
+		pid_t pid;
+		while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+			std::erase(processes, pid);
+			if (stopRequested.load()) {
+				continue;
+			}
+			if (WIFEXITED(status) && WEXITSTATUS(status) != 0) {
+				// Could not even start; forking again would fail the same way
+				std::cerr << "[server] worker process " << pid << " failed to start\n";
+				continue;
+			}
+			if (WIFSIGNALED(status)) {
+				std::cerr << "[server] worker process " << pid << " killed by signal " << WTERMSIG(status) << ", restarting\n";
+			}
+			spawnProcess();
+		}
+
+		if (stopRequested.load() && !stopping) {
+			stopping = true;
+			for (int worker : processes) {
+				kill(worker, SIGTERM);
+			}
+		}
+		if (processes.empty() && !stopping) {
+			std::cerr << "[server] no worker process left\n";
+			break;
+		}
+	}
+	std::signal(SIGCHLD, SIG_DFL);
+	supervisorWakeFd = -1;
+}
+
+void GameServer::run() {
+	if (config.processes > 0 && !workerProcess) {
+		superviseProcesses();
+		return;
+	}
+
+	epoll_event events[MAX_EVENTS];
+	bool draining = false;
+
+	while (!(draining && sessions.empty())) {
+		int ready = epoll_wait(epollFd, events, MAX_EVENTS, -1);
+		if (ready < 0) {
+			if (errno == EINTR) continue;
+			std::cerr << "[server] epoll_wait: " << std::strerror(errno) << "\n";
+			break;
+		}
+
+		for (int i = 0; i < ready; ++i) {
+			int fd = events[i].data.fd;
+			if (fd == listenFd) {
+				acceptClients();
+				continue;
+			}
+			if (fd == wakeFd) {
+				uint64_t value;
+				while (read(wakeFd, &value, sizeof(value)) > 0) {
+				}
+				processWriteQueue();
+				continue;
+			}
+
+			auto it = sessions.find(fd);
+			if (it == sessions.end()) continue;
+			Session& session = *it->second;
+			if (events[i].events & EPOLLOUT) {
+				writeClient(session);
+				if (sessions.find(fd) == sessions.end()) continue;
+			}
+			if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+				readClient(session);
+			}
+		}
+
+		if (stopRequested.load() && !draining) {
+			// Disconnect everyone; games unwind at their next read
+			draining = true;
+			epoll_ctl(epollFd, EPOLL_CTL_DEL, listenFd, nullptr);
+			std::vector<Session*> open;
+			for (auto& [fd, session] : sessions) {
+				open.push_back(session.get());
+			}
+			for (Session* session : open) {
+				shutdown(session->fd, SHUT_RDWR);
+				markClosed(*session);
+			}
+		}
+	}
+
+	for (auto& worker : workers) {
+		{
+			std::lock_guard<std::mutex> lock(worker->mutex);
+			worker->stopping = true;
+		}
+		worker->wakeup.notify_one();
+		worker->thread.join();
+	}
+}
+
+void GameServer::requestStop() {
+	stopRequested.store(true);
+	wake();
+}
+
+void GameServer::wake() {
+	uint64_t one = 1;
+	[[maybe_unused]] ssize_t written = write(wakeFd, &one, sizeof(one));
+}
+
+void GameServer::queueWrite(Session* session) {
+	{
+		std::lock_guard<std::mutex> lock(writeMutex);
+		writeQueue.push_back(session);
+	}
+	wake();
+}
+
+void GameServer::acceptClients() {
+	while (true) {
+		int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (fd < 0) {
+			if (errno == EMFILE || errno == ENFILE) {
+				// Out of descriptors: use the spare one to accept and drop the client,
+				// otherwise the pending connection keeps the listener readable forever
+				std::cerr << "[server] out of file descriptors, refusing connection\n";
+				close(spareFd);
+				int refused = accept(listenFd, nullptr, nullptr);
+				if (refused >= 0) close(refused);
+				spareFd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+				continue;
+			}
+			return;   // EAGAIN: no more pending connections
+		}
+		if (!isUnixSocket) {
+			int on = 1;
+			setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+		}
+
+		Worker& worker = *workers[nextWorker++ % workers.size()];
+		auto session = std::make_unique<Session>(*this, worker, fd);
+		if (!session->stack) {
+			std::cerr << "[server] cannot allocate a session stack, refusing connection\n";
+			close(fd);
+			continue;
+		}
+		epoll_event event{};
+		event.events = EPOLLIN;
+		event.data.fd = fd;
+		epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+		Session* raw = session.get();
+		sessions.emplace(fd, std::move(session));
+		worker.schedule(raw);
+	}
+}
+
+void GameServer::readClient(Session& session) {
+	char buffer[READ_CHUNK_SIZE];
+	bool closed = false;
+	std::string received;
+	while (true) {
+		ssize_t count = read(session.fd, buffer, sizeof(buffer));
+		if (count > 0) {
+			// Accept CRLF line endings from telnet-style clients
+			for (ssize_t i = 0; i < count; ++i) {
+				if (buffer[i] != '\r') received += buffer[i];
+			}
+			continue;
+		}
+		if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+		if (count < 0 && errno == EINTR) continue;
+		closed = true;
+		break;
+	}
+
+	if (!received.empty()) {
+		bool wakeGame = false;
+		{
+			std::lock_guard<std::mutex> lock(session.mutex);
+			session.inbox += received;
+			if (session.inbox.size() > MAX_PENDING_INPUT) {
+				closed = true;
+			}
+			// Line-based protocol: only wake the game once a full line is there
+			else if (session.waitingForInput && received.find('\n') != std::string::npos) {
+				session.waitingForInput = false;
+				wakeGame = true;
+			}
+		}
+		if (wakeGame) {
+			session.worker.schedule(&session);
+		}
+	}
+	if (closed) {
+		markClosed(session);
+	}
+}
+
+void GameServer::markClosed(Session& session) {
+	epoll_ctl(epollFd, EPOLL_CTL_DEL, session.fd, nullptr);
+	session.writeBuffer.clear();
+	session.writeOffset = 0;
+
+	bool wakeGame = false;
+	bool done = false;
+	{
+		std::lock_guard<std::mutex> lock(session.mutex);
+		if (session.peerClosed) return;
+		session.peerClosed = true;
+		if (session.waitingForInput) {
+			session.waitingForInput = false;
+			wakeGame = true;
+		}
+		done = session.finished && !session.queuedForWrite;
+	}
+	if (wakeGame) {
+		session.worker.schedule(&session);
+	}
+	if (done) {
+		closeSession(session);
+	}
+}
+
+void GameServer::processWriteQueue() {
+	std::deque<Session*> pending;
+	{
+		std::lock_guard<std::mutex> lock(writeMutex);
+		pending.swap(writeQueue);
+	}
+	for (Session* session : pending) {
+		bool done;
+		bool gone;
+		{
+			std::lock_guard<std::mutex> lock(session->mutex);
+			gone = session->peerClosed;
+			if (!gone) {
+				session->writeBuffer += session->outbox;
+			}
+			session->outbox.clear();
+			session->queuedForWrite = false;
+			done = session->finished;
+		}
+		if (gone) {
+			if (done) closeSession(*session);
+			continue;
+		}
+		writeClient(*session);
+	}
+}
+
+void GameServer::writeClient(Session& session) {
+	while (session.writeOffset < session.writeBuffer.size()) {
+		ssize_t count = send(session.fd, session.writeBuffer.data() + session.writeOffset,
+			session.writeBuffer.size() - session.writeOffset, MSG_NOSIGNAL);
+		if (count > 0) {
+			session.writeOffset += static_cast<size_t>(count);
+			continue;
+		}
+		if (count < 0 && errno == EINTR) continue;
+		if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+			if (!session.writeInterest) {
+				// Slow client: wait until the socket drains
+				epoll_event event{};
+				event.events = EPOLLIN | EPOLLOUT;
+				event.data.fd = session.fd;
+				epoll_ctl(epollFd, EPOLL_CTL_MOD, session.fd, &event);
+				session.writeInterest = true;
+			}
+			return;
+		}
+		markClosed(session);
+		return;
+	}
+
+	session.writeBuffer.clear();
+	session.writeOffset = 0;
+	if (session.writeInterest) {
+		epoll_event event{};
+		event.events = EPOLLIN;
+		event.data.fd = session.fd;
+		epoll_ctl(epollFd, EPOLL_CTL_MOD, session.fd, &event);
+		session.writeInterest = false;
+	}
+
+	bool done;
+	{
+		std::lock_guard<std::mutex> lock(session.mutex);
+		// A queued session is closed by processWriteQueue instead
+		done = session.finished && !session.queuedForWrite;
+	}
+	if (done) {
+		closeSession(session);
+	}
+}
+
+void GameServer::closeSession(Session& session) {
+	int fd = session.fd;
+	epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+	close(fd);
+	sessions.erase(fd);
+}
+
+int connectToServer(const std::string& addressText, std::string& error) {
+	Address address;
+	if (!parseAddress(addressText, address, error)) {
+		return -1;
+	}
+	return openSocket(address, false, error);
+}
+
+int runClient(const std::string& addressText) {
+	std::string error;
+	int fd = connectToServer(addressText, error);
+	if (fd < 0) {
+		std::cerr << "Could not connect to " << addressText << ": " << error << "\n";
+		return 1;
+	}
+
+	pollfd fds[2] = { { STDIN_FILENO, POLLIN, 0 }, { fd, POLLIN, 0 } };
+	bool inputOpen = true;
+	char buffer[READ_CHUNK_SIZE];
+	while (true) {
+		if (poll(fds, 2, -1) < 0) {
+			if (errno == EINTR) continue;
+			break;
+		}
+		if (fds[1].revents & (POLLIN | POLLHUP | POLLERR)) {
+			ssize_t count = read(fd, buffer, sizeof(buffer));
+			if (count <= 0) break;   // Server ended the session
+			for (ssize_t written = 0; written < count;) {
+				ssize_t part = write(STDOUT_FILENO, buffer + written, static_cast<size_t>(count - written));
+				if (part <= 0) break;
+				written += part;
+			}
+		}
+		if (inputOpen && (fds[0].revents & (POLLIN | POLLHUP))) {
+			ssize_t count = read(STDIN_FILENO, buffer, sizeof(buffer));
+			if (count <= 0) {
+				// Keep printing server output after our input ends
+				shutdown(fd, SHUT_WR);
+				inputOpen = false;
+				fds[0].fd = -1;
+			}
+			else if (send(fd, buffer, static_cast<size_t>(count), MSG_NOSIGNAL) < 0) {
+				break;
+			}
+		}
+	}
+	close(fd);
+	return 0;
+}
+
+#else
+
+struct GameServer::Worker {
+};
+
+struct GameServer::Session {
+};
+
+GameServer::GameServer(const ServerConfig& serverConfig, SessionMain main)
+	: config(serverConfig), sessionMain(std::move(main)) {
+}
+
+GameServer::~GameServer() = default;
+
+bool GameServer::start(std::string& error) {
+	error = "server mode is only available on Linux";
+	return false;
+}
+
+void GameServer::run() {
+}
+
+void GameServer::requestStop() {
+}
+
+int connectToServer(const std::string&, std::string& error) {
+	error = "client mode is only available on Linux";
+	return -1;
+}
+
+int runClient(const std::string& address) {
+	std::cerr << "Could not connect to " << address << ": client mode is only available on Linux\n";
+	return 1;
+}
+
+#endif
\ No newline at end of file
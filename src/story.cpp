@@ -0,0 +1,148 @@
+#include <algorithm>
+#include "story.h"
+#include "bestiary.h"
+
+void SceneDef::addChoice(const std::string& choiceDescription, int nextScene, int minRoll, int failScene) {
+	choices.push_back(ChoiceDef{ choiceDescription, nextScene, minRoll, failScene });
+}
+
+bool SceneDef::addEnemy(const std::string& enemyName, int hp, int atk, int def, int count, int mindAttack) {
+	CreatureID creature = Bestiary::define(enemyName, hp, atk, def, Side::ENEMY, mindAttack);
+	if (creature == Bestiary::NONE) return false;
+	combatants.push_back(CombatantDef{ creature, count });
+	return true;
+}
+
+bool SceneDef::addAlly(const std::string& allyName, int hp, int atk, int def) {
+	CreatureID creature = Bestiary::define(allyName, hp, atk, def, Side::ALLY);
+	if (creature == Bestiary::NONE) return false;
+	combatants.push_back(CombatantDef{ creature, 1 });
+	return true;
+}
+
+void SceneDef::addNewWeapon(const std::string& itemName, int attackBonus) {
+	loot.push_back(LootDef{ ItemKind::WEAPON, itemName, attackBonus });
+}
+
+void SceneDef::addNewArmor(const std::string& itemName, int defenseBonus) {
+	loot.push_back(LootDef{ ItemKind::ARMOR, itemName, defenseBonus });
+}
+
+void SceneDef::addPotionLoot(const std::string& itemName, int healAmount) {
+	loot.push_back(LootDef{ ItemKind::POTION, itemName, healAmount });
+}
+
+std::shared_ptr<const SceneDef> makeSceneDef(SceneDef&& def) {
+	return std::allocate_shared<SceneDef>(TrackingAllocator<SceneDef, MemTag::STORY>(), std::move(def));
+}
+
+const SceneDef* Story::find(int number) const {
+	if (number <= 0) {
+		return nullptr;
+	}
+	size_t chunk = static_cast<size_t>(number) / CHUNK_SIZE;
+	if (chunk >= chunks.size() || !chunks[chunk]) {
+		return nullptr;
+	}
+	return (*chunks[chunk])[static_cast<size_t>(number) % CHUNK_SIZE].get();
+}
+
+std::shared_ptr<const SceneDef> Story::findShared(int number) const {
+	if (number <= 0) {
+		return nullptr;
+	}
+	size_t chunk = static_cast<size_t>(number) / CHUNK_SIZE;
+	if (chunk >= chunks.size() || !chunks[chunk]) {
+		return nullptr;
+	}
+	return (*chunks[chunk])[static_cast<size_t>(number) % CHUNK_SIZE];
+}
+
+int Story::getStartScene() const {
+	return startScene;
+}
+
+size_t Story::size() const {
+	return sceneCount;
+}
+
+uint64_t Story::getVersion() const {
+	return version;
+}
+
+std::vector<int> Story::sceneNumbers() const {
+	std::vector<int> numbers;
+	numbers.reserve(sceneCount);
+	for (size_t c = 0; c < chunks.size(); ++c) {
+		if (!chunks[c]) continue;
+		for (size_t i = 0; i < CHUNK_SIZE; ++i) {
+			if ((*chunks[c])[i]) {
+				numbers.push_back(static_cast<int>(c * CHUNK_SIZE + i));
+			}
+		}
+	}
+	return numbers;
+}
+
+std::shared_ptr<const Story> Story::update(const std::vector<std::shared_ptr<const SceneDef>>& changed,
+	const std::vector<int>& removed, int newStartScene) const {
+	auto next = std::make_shared<Story>(*this);
+	next->version = version + 1;
+	next->startScene = newStartScene;
+
+	// Chunks copied for this version; every other chunk stays shared with the previous one
+	std::map<size_t, std::shared_ptr<Chunk>> copied;
+	auto writableSlot = [&](int number) -> std::shared_ptr<const SceneDef>& {
+		size_t chunk = static_cast<size_t>(number) / CHUNK_SIZE;
+		if (chunk >= next->chunks.size()) {
+			next->chunks.resize(chunk + 1);
+		}
+		auto it = copied.find(chunk);
+		if (it == copied.end()) {
+			auto fresh = next->chunks[chunk] ? std::make_shared<Chunk>(*next->chunks[chunk]) : std::make_shared<Chunk>();
+			it = copied.emplace(chunk, fresh).first;
+			next->chunks[chunk] = fresh;
+		}
+		return (*it->second)[static_cast<size_t>(number) % CHUNK_SIZE];
+	};
+
+	for (int number : removed) {
+		if (!find(number)) continue;
+		writableSlot(number).reset();
+		next->sceneCount--;
+	}
+	for (const auto& def : changed) {
+		if (!def || def->number <= 0) continue;
+		auto& slot = writableSlot(def->number);
+		if (!slot) {
+			next->sceneCount++;
+		}
+		slot = def;
+	}
+	return next;
+}
+
+SceneDef& StoryBuilder::createScene(int number, const std::string& description) {
+	SceneDef& def = scenes[number];
+	def.number = number;
+	def.description = description;
+	return def;
+}
+
+SceneDef& StoryBuilder::scene(int number) {
+	return scenes.at(number);
+}
+
+void StoryBuilder::setStartScene(int number) {
+	startScene = number;
+}
+
+std::shared_ptr<const Story> StoryBuilder::build() const {
+	std::vector<std::shared_ptr<const SceneDef>> defs;
+	defs.reserve(scenes.size());
+	for (const auto& [number, def] : scenes) {
+		SceneDef copy = def;
+		defs.push_back(makeSceneDef(std::move(copy)));
+	}
+	return Story().update(defs, {}, startScene);
+}
\ No newline at end of file
@@ -0,0 +1,439 @@
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include "storyfile.h"
+#include "bestiary.h"
+#include "endless.h"
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr auto WATCH_TIMEOUT = std::chrono::milliseconds(200);
+constexpr auto RELOAD_DEBOUNCE = std::chrono::milliseconds(50);
+
+std::string_view trim(std::string_view text) {
+	while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+	while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r')) text.remove_suffix(1);
+	return text;
+}
+
+/**
+ * @brief Calls visit(line) for every line of the text, without line terminators
+ */
+template <typename Visit>
+bool forEachLine(std::string_view text, Visit visit) {
+	while (!text.empty()) {
+		size_t end = text.find('\n');
+		std::string_view line = text.substr(0, end);
+		if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+		if (!visit(line)) return false;
+		if (end == std::string_view::npos) break;
+		text.remove_prefix(end + 1);
+	}
+	return true;
+}
+
+bool parseInt(std::string_view token, int& value) {
+	auto [end, ec] = std::from_chars(token.data(), token.data() + token.size(), value);
+	return ec == std::errc() && end == token.data() + token.size();
+}
+
+std::vector<std::string_view> splitWords(std::string_view text) {
+	std::vector<std::string_view> words;
+	while (true) {
+		text = trim(text);
+		if (text.empty()) break;
+		size_t end = text.find_first_of(" \t");
+		words.push_back(text.substr(0, end));
+		if (end == std::string_view::npos) break;
+		text.remove_prefix(end);
+	}
+	return words;
+}
+
+/**
+ * @brief Splits "numbers | text" into its numeric fields and trimmed text
+ */
+bool splitFields(std::string_view value, std::vector<std::string_view>& numbers, std::string& text) {
+	size_t bar = value.find('|');
+	if (bar == std::string_view::npos) {
+		return false;
+	}
+	numbers = splitWords(value.substr(0, bar));
+	text = std::string(trim(value.substr(bar + 1)));
+	return !text.empty();
+}
+
+bool parseHeaderBlock(std::string_view block, int& startScene, std::string& error) {
+	return forEachLine(block, [&](std::string_view line) {
+		std::string_view content = trim(line);
+		if (content.empty() || content.front() == '#') return true;
+		if (content.substr(0, 6) == "start:" && parseInt(trim(content.substr(6)), startScene)) return true;
+		error = "unexpected line before the first scene: " + std::string(content);
+		return false;
+	});
+}
+
+bool isSceneHeader(std::string_view line) {
+	return !line.empty() && line.front() == '[';
+}
+
+} // namespace
+
+bool parseSceneBlock(std::string_view block, SceneDef& def, std::string& error) {
+	bool headerSeen = false;
+	std::vector<std::string> textLines;
+
+	bool ok = forEachLine(block, [&](std::string_view line) {
+		if (!headerSeen) {
+			size_t close = line.find(']');
+			std::vector<std::string_view> words = splitWords(line.substr(1, close == std::string_view::npos ? 0 : close - 1));
+			if (close == std::string_view::npos || words.empty() || !parseInt(words[0], def.number)
+				|| def.number <= 0 || def.number >= EndlessRealm::FIRST_SCENE) {
+				error = "invalid scene header: " + std::string(line);
+				return false;
+			}
+			def.name = words.size() > 1 ? std::string(words[1]) : std::string();
+			headerSeen = true;
+			return true;
+		}
+
+		std::string_view content = trim(line);
+		if (content.empty() || content.front() == '#') return true;
+
+		size_t colon = line.find(':');
+		if (colon == std::string_view::npos) {
+			error = "missing ':' in scene " + std::to_string(def.number) + ": " + std::string(content);
+			return false;
+		}
+		std::string_view key = trim(line.substr(0, colon));
+		std::string_view value = line.substr(colon + 1);
+
+		if (key == "text") {
+			// Keep the text verbatim apart from the single space after the colon
+			if (!value.empty() && value.front() == ' ') value.remove_prefix(1);
+			textLines.emplace_back(value);
+			return true;
+		}
+
+		std::vector<std::string_view> numbers;
+		std::string name;
+		std::vector<int> values;
+		int count = 1;         // "x<n>" repeat marker
+		int mindAttack = 0;    // "m<n>" mind attack marker
+		bool marked = false;   // Markers are only valid on enemies
+		if (splitFields(value, numbers, name)) {
+			for (std::string_view token : numbers) {
+				int number = 0;
+				if (!token.empty() && token.front() == 'x' && parseInt(token.substr(1), number)) {
+					count = number;
+					marked = true;
+				}
+				else if (!token.empty() && token.front() == 'm' && parseInt(token.substr(1), number)) {
+					mindAttack = number;
+					marked = true;
+				}
+				else if (parseInt(token, number)) {
+					values.push_back(number);
+				}
+				else {
+					values.clear();
+					break;
+				}
+			}
+		}
+
+		bool valid = false;
+		if (key == "choice" && !marked && (values.size() == 1 || values.size() == 3)) {
+			def.addChoice(name, values[0], values.size() == 3 ? values[1] : 0, values.size() == 3 ? values[2] : 0);
+			valid = true;
+		}
+		else if (key == "enemy" && values.size() == 3) {
+			valid = count > 0 && mindAttack >= 0 && def.addEnemy(name, values[0], values[1], values[2], count, mindAttack);
+		}
+		else if (key == "ally" && !marked && values.size() == 3) {
+			valid = def.addAlly(name, values[0], values[1], values[2]);
+		}
+		else if (!marked && values.size() == 1 && (key == "weapon" || key == "armor" || key == "potion")) {
+			if (key == "weapon") def.addNewWeapon(name, values[0]);
+			if (key == "armor") def.addNewArmor(name, values[0]);
+			if (key == "potion") def.addPotionLoot(name, values[0]);
+			valid = true;
+		}
+
+		if (!valid) {
+			error = "invalid line in scene " + std::to_string(def.number) + ": " + std::string(content);
+		}
+		return valid;
+	});
+
+	if (!ok) {
+		return false;
+	}
+	if (!headerSeen) {
+		error = "empty scene block";
+		return false;
+	}
+
+	def.description.clear();
+	for (size_t i = 0; i < textLines.size(); ++i) {
+		if (i > 0) def.description += '\n';
+		def.description += textLines[i];
+	}
+	return true;
+}
+
+void writeStory(const Story& story, std::ostream& out) {
+	out << "# LoneWolf story file\n";
+	out << "start: " << story.getStartScene() << "\n";
+
+	for (int number : story.sceneNumbers()) {
+		const SceneDef* def = story.find(number);
+		out << "\n[" << def->number;
+		if (!def->name.empty()) out << " " << def->name;
+		out << "]\n";
+
+		forEachLine(def->description, [&](std::string_view line) {
+			out << "text:" << (line.empty() ? "" : " ") << line << "\n";
+			return true;
+		});
+		for (const CombatantDef& combatant : def->combatants) {
+			const Creature& creature = Bestiary::get(combatant.creature);
+			out << (creature.side == Side::ENEMY ? "enemy: " : "ally: ")
+				<< creature.hitPoints << " " << creature.attack << " " << creature.defense;
+			if (combatant.count > 1) out << " x" << combatant.count;
+			if (creature.mindAttack > 0) out << " m" << creature.mindAttack;
+			out << " | " << creature.name << "\n";
+		}
+		for (const LootDef& item : def->loot) {
+			const char* key = item.kind == ItemKind::WEAPON ? "weapon" : item.kind == ItemKind::ARMOR ? "armor" : "potion";
+			out << key << ": " << item.bonus << " | " << item.name << "\n";
+		}
+		for (const ChoiceDef& choice : def->choices) {
+			out << "choice: " << choice.next;
+			if (choice.minRoll > 0) out << " " << choice.minRoll << " " << choice.fail;
+			out << " | " << choice.label << "\n";
+		}
+	}
+}
+
+StoryFile::StoryFile(const std::string& filePath)
+	: path(filePath), blocks{ Block{ 0, 0, 0 } }, latest(std::make_shared<Story>()) {
+}
+
+StoryFile::~StoryFile() {
+	stopWatching();
+}
+
+std::shared_ptr<const Story> StoryFile::current() const {
+	return published.load();
+}
+
+bool StoryFile::reload(std::string& error, ReloadStats* stats) {
+	auto started = std::chrono::steady_clock::now();
+
+	std::ifstream file(path, std::ios::binary);
+	if (!file) {
+		error = "cannot open " + path;
+		return false;
+	}
+	file.seekg(0, std::ios::end);
+	std::string newText(static_cast<size_t>(std::max<std::streamoff>(file.tellg(), 0)), '\0');
+	file.seekg(0, std::ios::beg);
+	file.read(newText.data(), static_cast<std::streamsize>(newText.size()));
+	newText.resize(static_cast<size_t>(file.gcount()));
+	if (newText == text && published.load()) {
+		if (stats) *stats = ReloadStats{};
+		return true;
+	}
+
+	// Locate the changed region: everything before prefix and after suffix is identical
+	size_t common = std::min(text.size(), newText.size());
+	size_t prefix = std::mismatch(text.begin(), text.begin() + static_cast<std::ptrdiff_t>(common), newText.begin()).first - text.begin();
+	size_t suffix = std::mismatch(text.rbegin(), text.rbegin() + static_cast<std::ptrdiff_t>(common - prefix), newText.rbegin()).first - text.rbegin();
+	size_t oldEnd = text.size() - suffix;
+	std::ptrdiff_t delta = static_cast<std::ptrdiff_t>(newText.size()) - static_cast<std::ptrdiff_t>(text.size());
+
+	// Blocks touching the changed region (closed intervals also take in the neighbours
+	// at its edges, so edited header lines and line breaks are always re-split)
+	auto touches = [&](const Block& b) { return b.offset <= oldEnd && b.offset + b.length >= prefix; };
+	auto firstIt = std::partition_point(blocks.begin(), blocks.end(),
+		[&](const Block& b) { return b.offset + b.length < prefix; });
+	size_t first = static_cast<size_t>(firstIt - blocks.begin());
+	size_t last = first;
+	while (last + 1 < blocks.size() && touches(blocks[last + 1])) last++;
+
+	size_t rangeStart = blocks[first].offset;
+	size_t rangeEnd = static_cast<size_t>(static_cast<std::ptrdiff_t>(blocks[last].offset + blocks[last].length) + delta);
+
+	// Split the new text of the affected range into blocks
+	std::vector<Block> pieces;
+	size_t lineStart = rangeStart;
+	if (first == 0) {
+		pieces.push_back(Block{ 0, 0, 0 });
+	}
+	while (lineStart < rangeEnd) {
+		size_t lineEnd = newText.find('\n', lineStart);
+		lineEnd = (lineEnd == std::string::npos || lineEnd >= rangeEnd) ? rangeEnd : lineEnd + 1;
+		if (isSceneHeader(std::string_view(newText).substr(lineStart, lineEnd - lineStart))) {
+			pieces.push_back(Block{ lineStart, 0, -1 });
+		}
+		else if (pieces.empty()) {
+			error = "internal error: reload range does not start at a scene";
+			return false;
+		}
+		pieces.back().length = lineEnd - pieces.back().offset;
+		lineStart = lineEnd;
+	}
+
+	// Reuse definitions whose text did not change, parse the rest
+	std::map<int, const Block*> oldByNumber;
+	for (size_t i = first; i <= last; ++i) {
+		if (blocks[i].number > 0) oldByNumber[blocks[i].number] = &blocks[i];
+	}
+
+	int startScene = latest->getStartScene();
+	std::vector<std::shared_ptr<const SceneDef>> changed;
+	std::set<int> seen;
+	size_t parsed = 0;
+	for (Block& piece : pieces) {
+		std::string_view pieceText = std::string_view(newText).substr(piece.offset, piece.length);
+		if (piece.number == 0) {
+			startScene = 0;
+			if (!parseHeaderBlock(pieceText, startScene, error)) return false;
+			continue;
+		}
+
+		SceneDef def;
+		if (!parseSceneBlock(pieceText, def, error)) return false;
+		piece.number = def.number;
+		if (!seen.insert(def.number).second || (latest->find(def.number) && !oldByNumber.count(def.number))) {
+			error = "scene " + std::to_string(def.number) + " is defined twice";
+			return false;
+		}
+
+		auto old = oldByNumber.find(def.number);
+		if (old != oldByNumber.end() && std::string_view(text).substr(old->second->offset, old->second->length) == pieceText) {
+			continue;   // Unchanged scene keeps its definition
+		}
+		changed.push_back(makeSceneDef(std::move(def)));
+		parsed++;
+	}
+
+	std::vector<int> removed;
+	for (const auto& [number, block] : oldByNumber) {
+		if (!seen.count(number)) removed.push_back(number);
+	}
+
+	auto next = latest->update(changed, removed, startScene);
+	if (!next->find(next->getStartScene())) {
+		error = "start scene " + std::to_string(next->getStartScene()) + " is not defined";
+		return false;
+	}
+
+	// Commit: splice the new blocks in and shift the ones after the edit
+	std::vector<Block> newBlocks;
+	newBlocks.reserve(blocks.size() - (last - first + 1) + pieces.size());
+	newBlocks.insert(newBlocks.end(), blocks.begin(), blocks.begin() + static_cast<std::ptrdiff_t>(first));
+	newBlocks.insert(newBlocks.end(), pieces.begin(), pieces.end());
+	for (size_t i = last + 1; i < blocks.size(); ++i) {
+		Block shifted = blocks[i];
+		shifted.offset = static_cast<size_t>(static_cast<std::ptrdiff_t>(shifted.offset) + delta);
+		newBlocks.push_back(shifted);
+	}
+
+	text = std::move(newText);
+	blocks = std::move(newBlocks);
+	latest = next;
+	published.store(next);
+
+	if (stats) {
+		stats->scenesParsed = parsed;
+		stats->scenesRemoved = removed.size();
+		stats->microseconds = std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now() - started).count();
+	}
+	return true;
+}
+
+void StoryFile::watch() {
+	stopWatching();
+	watcher = std::jthread([this](std::stop_token stopToken) {
+		auto reloadAndReport = [this] {
+			std::string error;
+			ReloadStats stats;
+			if (reload(error, &stats)) {
+				if (stats.scenesParsed > 0 || stats.scenesRemoved > 0) {
+					std::cerr << "[story] version " << current()->getVersion() << ": " << stats.scenesParsed
+						<< " scenes parsed, " << stats.scenesRemoved << " removed in " << stats.microseconds << " us\n";
+				}
+			}
+			else {
+				std::cerr << "[story] reload failed, keeping version " << current()->getVersion() << ": " << error << "\n";
+			}
+		};
+
+#ifdef __linux__
+		// Watch the directory: editors often replace the file instead of writing in place
+		std::filesystem::path filePath(path);
+		std::string directory = filePath.has_parent_path() ? filePath.parent_path().string() : ".";
+		std::string fileName = filePath.filename().string();
+
+		int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (fd >= 0 && inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) >= 0) {
+			alignas(inotify_event) char buffer[4096];
+			while (!stopToken.stop_requested()) {
+				pollfd pfd{ fd, POLLIN, 0 };
+				if (poll(&pfd, 1, static_cast<int>(WATCH_TIMEOUT.count())) <= 0) continue;
+
+				bool relevant = false;
+				ssize_t length;
+				while ((length = read(fd, buffer, sizeof(buffer))) > 0) {
+					for (char* p = buffer; p < buffer + length;) {
+						auto* event = reinterpret_cast<inotify_event*>(p);
+						if (event->len > 0 && fileName == event->name) relevant = true;
+						p += sizeof(inotify_event) + event->len;
+					}
+				}
+				if (relevant) {
+					std::this_thread::sleep_for(RELOAD_DEBOUNCE);
+					reloadAndReport();
+				}
+			}
+			close(fd);
+			return;
+		}
+		if (fd >= 0) close(fd);
+#endif
+
+		// Portable fallback: poll the modification time
+		std::error_code ec;
+		auto lastWrite = std::filesystem::last_write_time(path, ec);
+		while (!stopToken.stop_requested()) {
+			std::this_thread::sleep_for(WATCH_TIMEOUT);
+			auto writeTime = std::filesystem::last_write_time(path, ec);
+			if (!ec && writeTime != lastWrite) {
+				lastWrite = writeTime;
+				std::this_thread::sleep_for(RELOAD_DEBOUNCE);
+				reloadAndReport();
+			}
+		}
+	});
+}
+
+void StoryFile::stopWatching() {
+	if (watcher.joinable()) {
+		watcher.request_stop();
+		watcher.join();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,381 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stop_token>
+#include <thread>
+#include <vector>
+#include "telemetry.h"
+
+namespace {
+
+constexpr size_t MAX_CHOICES = 8;
+constexpr size_t OUTCOME_COUNT = 3;
+
+// Upper bounds of the combat rounds histogram, last bucket is +Inf
+constexpr std::array<int, 11> ROUND_BOUNDS = { 1, 2, 3, 4, 5, 6, 8, 10, 12, 16, 20 };
+
+// Turn latency buckets are powers of two in microseconds (1us .. ~8s), last bucket is +Inf
+constexpr size_t LATENCY_BUCKETS = 24;
+
+const char* OUTCOME_NAMES[OUTCOME_COUNT] = { "win", "flee", "death" };
+
+using Counter = std::atomic<uint64_t>;
+
+/**
+ * @brief Visits of one scene and the choices taken there
+ */
+struct SceneCounts {
+	uint64_t visits = 0;
+	std::array<uint64_t, MAX_CHOICES> choices{};
+};
+
+/**
+ * @brief Counters owned by a single recording thread
+ *
+ * Only the owning thread writes; the exporter reads with relaxed loads.
+ * The scene and enemy maps are guarded by mutexes that are only contended
+ * during export; scenes are keyed by their number, since story files and the
+ * endless lands use numbers far beyond the built-in story.
+ */
+struct Shard {
+	std::mutex sceneMutex;
+	std::map<int, SceneCounts> scenes;
+	Counter rollPassed{ 0 };
+	Counter rollFailed{ 0 };
+	std::array<Counter, ROUND_BOUNDS.size() + 1> combatRounds{};
+	Counter combatRoundsSum{ 0 };
+	std::array<Counter, LATENCY_BUCKETS + 1> turnLatency{};
+	Counter turnLatencySumNs{ 0 };
+
+	std::mutex enemyMutex;
+	std::map<std::string, std::array<uint64_t, OUTCOME_COUNT>> enemyOutcomes;
+};
+
+/**
+ * @brief Plain merged copy of every shard used for exporting
+ */
+struct Snapshot {
+	std::map<int, SceneCounts> scenes;
+	uint64_t rollPassed = 0;
+	uint64_t rollFailed = 0;
+	std::array<uint64_t, ROUND_BOUNDS.size() + 1> combatRounds{};
+	uint64_t combatRoundsSum = 0;
+	std::array<uint64_t, LATENCY_BUCKETS + 1> turnLatency{};
+	uint64_t turnLatencySumNs = 0;
+	std::map<std::string, std::array<uint64_t, OUTCOME_COUNT>> enemyOutcomes;
+};
+
+struct Registry {
+	std::mutex mutex;
+	std::vector<std::shared_ptr<Shard>> shards;
+
+	std::mutex exportMutex;
+	std::string pathPrefix;
+	std::jthread exporter;
+};
+
+Registry& registry() {
+	static Registry instance;
+	return instance;
+}
+
+Shard& localShard() {
+	// Shards are owned by the registry so counts survive their thread
+	thread_local Shard* shard = [] {
+		auto created = std::make_shared<Shard>();
+		Registry& reg = registry();
+		std::lock_guard lock(reg.mutex);
+		reg.shards.push_back(created);
+		return created.get();
+	}();
+	return *shard;
+}
+
+void bump(Counter& counter, uint64_t amount = 1) {
+	counter.fetch_add(amount, std::memory_order_relaxed);
+}
+
+uint64_t read(const Counter& counter) {
+	return counter.load(std::memory_order_relaxed);
+}
+
+Snapshot collect() {
+	Snapshot snap;
+	Registry& reg = registry();
+	std::lock_guard lock(reg.mutex);
+
+	for (const auto& shard : reg.shards) {
+		{
+			std::lock_guard sceneLock(shard->sceneMutex);
+			for (const auto& [number, counts] : shard->scenes) {
+				SceneCounts& merged = snap.scenes[number];
+				merged.visits += counts.visits;
+				for (size_t c = 0; c < MAX_CHOICES; ++c) {
+					merged.choices[c] += counts.choices[c];
+				}
+			}
+		}
+		snap.rollPassed += read(shard->rollPassed);
+		snap.rollFailed += read(shard->rollFailed);
+		for (size_t b = 0; b < snap.combatRounds.size(); ++b) {
+			snap.combatRounds[b] += read(shard->combatRounds[b]);
+		}
+		snap.combatRoundsSum += read(shard->combatRoundsSum);
+		for (size_t b = 0; b < snap.turnLatency.size(); ++b) {
+			snap.turnLatency[b] += read(shard->turnLatency[b]);
+		}
+		snap.turnLatencySumNs += read(shard->turnLatencySumNs);
+
+		std::lock_guard enemyLock(shard->enemyMutex);
+		for (const auto& [name, outcomes] : shard->enemyOutcomes) {
+			auto& merged = snap.enemyOutcomes[name];
+			for (size_t o = 0; o < OUTCOME_COUNT; ++o) {
+				merged[o] += outcomes[o];
+			}
+		}
+	}
+	return snap;
+}
+
+std::string escapeJson(const std::string& text) {
+	std::string escaped;
+	for (char c : text) {
+		if (c == '"' || c == '\\') {
+			escaped += '\\';
+		}
+		escaped += c;
+	}
+	return escaped;
+}
+
+double latencyBound(size_t bucket) {
+	// Upper bound in seconds of the given power-of-two microsecond bucket
+	return static_cast<double>(uint64_t{ 1 } << bucket) / 1e6;
+}
+
+std::string toJson(const Snapshot& snap) {
+	std::ostringstream out;
+	out << "{\n  \"scene_visits\": {";
+	const char* separator = "";
+	for (const auto& [number, counts] : snap.scenes) {
+		if (counts.visits == 0) continue;
+		out << separator << "\"" << number << "\": " << counts.visits;
+		separator = ", ";
+	}
+
+	out << "},\n  \"choices\": {";
+	separator = "";
+	for (const auto& [number, counts] : snap.scenes) {
+		for (size_t c = 0; c < MAX_CHOICES; ++c) {
+			if (counts.choices[c] == 0) continue;
+			out << separator << "\"" << number << "." << c + 1 << "\": " << counts.choices[c];
+			separator = ", ";
+		}
+	}
+
+	out << "},\n  \"roll_checks\": { \"passed\": " << snap.rollPassed
+		<< ", \"failed\": " << snap.rollFailed << " },\n";
+
+	out << "  \"combat_rounds\": { \"buckets\": [";
+	for (size_t b = 0; b < snap.combatRounds.size(); ++b) {
+		out << (b ? ", " : "") << snap.combatRounds[b];
+	}
+	out << "], \"bounds\": [";
+	for (size_t b = 0; b < ROUND_BOUNDS.size(); ++b) {
+		out << (b ? ", " : "") << ROUND_BOUNDS[b];
+	}
+	out << "], \"sum\": " << snap.combatRoundsSum << " },\n";
+
+	out << "  \"enemies\": {";
+	separator = "";
+	for (const auto& [name, outcomes] : snap.enemyOutcomes) {
+		out << separator << "\"" << escapeJson(name) << "\": {";
+		for (size_t o = 0; o < OUTCOME_COUNT; ++o) {
+			out << (o ? ", " : " ") << "\"" << OUTCOME_NAMES[o] << "\": " << outcomes[o];
+		}
+		out << " }";
+		separator = ", ";
+	}
+
+	out << "},\n  \"turn_latency_us\": { \"buckets\": [";
+	for (size_t b = 0; b < snap.turnLatency.size(); ++b) {
+		out << (b ? ", " : "") << snap.turnLatency[b];
+	}
+	out << "], \"sum_ns\": " << snap.turnLatencySumNs << " }\n}\n";
+	return out.str();
+}
+
+std::string toPrometheus(const Snapshot& snap) {
+	std::ostringstream out;
+	out << "# TYPE lonewolf_scene_visits_total counter\n";
+	for (const auto& [number, counts] : snap.scenes) {
+		if (counts.visits == 0) continue;
+		out << "lonewolf_scene_visits_total{scene=\"" << number << "\"} " << counts.visits << "\n";
+	}
+
+	out << "# TYPE lonewolf_choices_total counter\n";
+	for (const auto& [number, counts] : snap.scenes) {
+		for (size_t c = 0; c < MAX_CHOICES; ++c) {
+			if (counts.choices[c] == 0) continue;
+			out << "lonewolf_choices_total{scene=\"" << number << "\",choice=\"" << c + 1 << "\"} "
+				<< counts.choices[c] << "\n";
+		}
+	}
+
+	out << "# TYPE lonewolf_roll_checks_total counter\n";
+	out << "lonewolf_roll_checks_total{result=\"passed\"} " << snap.rollPassed << "\n";
+	out << "lonewolf_roll_checks_total{result=\"failed\"} " << snap.rollFailed << "\n";
+
+	out << "# TYPE lonewolf_combat_outcomes_total counter\n";
+	for (const auto& [name, outcomes] : snap.enemyOutcomes) {
+		for (size_t o = 0; o < OUTCOME_COUNT; ++o) {
+			out << "lonewolf_combat_outcomes_total{enemy=\"" << escapeJson(name)
+				<< "\",outcome=\"" << OUTCOME_NAMES[o] << "\"} " << outcomes[o] << "\n";
+		}
+	}
+
+	// Prometheus buckets are cumulative
+	out << "# TYPE lonewolf_combat_rounds histogram\n";
+	uint64_t cumulative = 0;
+	for (size_t b = 0; b < snap.combatRounds.size(); ++b) {
+		cumulative += snap.combatRounds[b];
+		out << "lonewolf_combat_rounds_bucket{le=\"";
+		if (b < ROUND_BOUNDS.size()) {
+			out << ROUND_BOUNDS[b];
+		}
+		else {
+			out << "+Inf";
+		}
+		out << "\"} " << cumulative << "\n";
+	}
+	out << "lonewolf_combat_rounds_sum " << snap.combatRoundsSum << "\n";
+	out << "lonewolf_combat_rounds_count " << cumulative << "\n";
+
+	out << "# TYPE lonewolf_turn_latency_seconds histogram\n";
+	cumulative = 0;
+	for (size_t b = 0; b < snap.turnLatency.size(); ++b) {
+		cumulative += snap.turnLatency[b];
+		out << "lonewolf_turn_latency_seconds_bucket{le=\"";
+		if (b < LATENCY_BUCKETS) {
+			out << latencyBound(b);
+		}
+		else {
+			out << "+Inf";
+		}
+		out << "\"} " << cumulative << "\n";
+	}
+	out << "lonewolf_turn_latency_seconds_sum " << static_cast<double>(snap.turnLatencySumNs) / 1e9 << "\n";
+	out << "lonewolf_turn_latency_seconds_count " << cumulative << "\n";
+	return out.str();
+}
+
+void writeFileAtomically(const std::string& path, const std::string& content) {
+	// Write next to the target and rename so scrapers never see a partial file
+	std::string tempPath = path + ".tmp";
+	{
+		std::ofstream file(tempPath, std::ios::trunc);
+		if (!file) return;
+		file << content;
+	}
+	std::error_code ec;
+	std::filesystem::rename(tempPath, path, ec);
+}
+
+} // namespace
+
+void Telemetry::recordSceneVisit(int sceneNumber) {
+	Shard& shard = localShard();
+	std::lock_guard lock(shard.sceneMutex);
+	shard.scenes[sceneNumber].visits++;
+}
+
+void Telemetry::recordChoice(int sceneNumber, size_t choiceIndex) {
+	if (choiceIndex >= MAX_CHOICES) {
+		return;
+	}
+	Shard& shard = localShard();
+	std::lock_guard lock(shard.sceneMutex);
+	shard.scenes[sceneNumber].choices[choiceIndex]++;
+}
+
+void Telemetry::recordRollCheck(bool passed) {
+	Shard& shard = localShard();
+	bump(passed ? shard.rollPassed : shard.rollFailed);
+}
+
+void Telemetry::recordCombat(const std::string& enemyName, int rounds, CombatOutcome outcome) {
+	Shard& shard = localShard();
+
+	size_t bucket = 0;
+	while (bucket < ROUND_BOUNDS.size() && rounds > ROUND_BOUNDS[bucket]) {
+		bucket++;
+	}
+	bump(shard.combatRounds[bucket]);
+	bump(shard.combatRoundsSum, static_cast<uint64_t>(std::max(0, rounds)));
+
+	std::lock_guard lock(shard.enemyMutex);
+	shard.enemyOutcomes[enemyName][static_cast<size_t>(outcome)]++;
+}
+
+void Telemetry::recordTurnLatency(std::chrono::nanoseconds elapsed) {
+	Shard& shard = localShard();
+	uint64_t ns = static_cast<uint64_t>(std::max<int64_t>(0, elapsed.count()));
+	uint64_t us = ns / 1000;
+
+	size_t bucket = 0;
+	while (bucket < LATENCY_BUCKETS && us > (uint64_t{ 1 } << bucket)) {
+		bucket++;
+	}
+	bump(shard.turnLatency[bucket]);
+	bump(shard.turnLatencySumNs, ns);
+}
+
+void Telemetry::start(const std::string& pathPrefix, std::chrono::seconds interval) {
+	stop();
+	Registry& reg = registry();
+	{
+		std::lock_guard lock(reg.exportMutex);
+		reg.pathPrefix = pathPrefix;
+	}
+
+	reg.exporter = std::jthread([interval](std::stop_token stopToken) {
+		std::mutex waitMutex;
+		std::condition_variable_any wakeup;
+		std::unique_lock lock(waitMutex);
+		while (!stopToken.stop_requested()) {
+			wakeup.wait_for(lock, stopToken, interval, [] { return false; });
+			if (!stopToken.stop_requested()) {
+				exportNow();
+			}
+		}
+	});
+}
+
+void Telemetry::stop() {
+	Registry& reg = registry();
+	if (reg.exporter.joinable()) {
+		reg.exporter.request_stop();
+		reg.exporter.join();
+		exportNow();
+	}
+}
+
+void Telemetry::exportNow() {
+	Registry& reg = registry();
+	std::lock_guard lock(reg.exportMutex);
+	if (reg.pathPrefix.empty()) {
+		return;
+	}
+
+	Snapshot snap = collect();
+	writeFileAtomically(reg.pathPrefix + ".json", toJson(snap));
+	writeFileAtomically(reg.pathPrefix + ".prom", toPrometheus(snap));
+}
\ No newline at end of file
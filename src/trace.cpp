@@ -0,0 +1,199 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+#include "trace.h"
+
+namespace {
+
+constexpr size_t RING_CAPACITY = 4096;   // Must be a power of two
+constexpr auto FLUSH_INTERVAL = std::chrono::milliseconds(100);
+
+struct Event {
+	const char* name;
+	const char* category;
+	int64_t startNs;
+	int64_t endNs;
+};
+
+/**
+ * @brief Single-producer/single-consumer event ring of one thread
+ *
+ * The owning thread advances head, the flusher advances tail.
+ * Events are dropped (and counted) when the flusher falls behind.
+ */
+struct Ring {
+	uint32_t threadId = 0;
+	std::array<Event, RING_CAPACITY> events{};
+	std::atomic<uint64_t> head{ 0 };
+	std::atomic<uint64_t> tail{ 0 };
+	std::atomic<uint64_t> dropped{ 0 };
+};
+
+struct Tracer {
+	std::atomic<bool> enabled{ false };
+	std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+
+	std::mutex ringsMutex;
+	std::vector<std::shared_ptr<Ring>> rings;
+
+	std::mutex fileMutex;
+	std::ofstream file;
+	bool firstEvent = true;
+
+	std::jthread flusher;
+};
+
+Tracer& tracer() {
+	static Tracer instance;
+	return instance;
+}
+
+Ring& localRing() {
+	thread_local Ring* ring = [] {
+		auto created = std::make_shared<Ring>();
+		Tracer& t = tracer();
+		std::lock_guard lock(t.ringsMutex);
+		created->threadId = static_cast<uint32_t>(t.rings.size() + 1);
+		t.rings.push_back(created);
+		return created.get();
+	}();
+	return *ring;
+}
+
+void writeEvent(Tracer& t, const Event& event, uint32_t threadId) {
+	// Chrome trace timestamps are microseconds
+	char line[256];
+	std::snprintf(line, sizeof(line),
+		"{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+		event.name, event.category,
+		static_cast<double>(event.startNs) / 1000.0,
+		static_cast<double>(event.endNs - event.startNs) / 1000.0,
+		threadId);
+
+	if (!t.firstEvent) {
+		t.file << ",\n";
+	}
+	t.firstEvent = false;
+	t.file << line;
+}
+
+void drainRings() {
+	Tracer& t = tracer();
+	std::vector<std::shared_ptr<Ring>> rings;
+	{
+		std::lock_guard lock(t.ringsMutex);
+		rings = t.rings;
+	}
+
+	std::lock_guard fileLock(t.fileMutex);
+	if (!t.file.is_open()) {
+		return;
+	}
+	for (const auto& ring : rings) {
+		uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+		uint64_t head = ring->head.load(std::memory_order_acquire);
+		for (; tail != head; ++tail) {
+			writeEvent(t, ring->events[tail & (RING_CAPACITY - 1)], ring->threadId);
+		}
+		ring->tail.store(tail, std::memory_order_release);
+	}
+	t.file.flush();
+}
+
+} // namespace
+
+bool Trace::start(const std::string& path) {
+	stop();
+	Tracer& t = tracer();
+	{
+		std::lock_guard lock(t.fileMutex);
+		t.file.open(path, std::ios::trunc);
+		if (!t.file) {
+			return false;
+		}
+		t.file << "[\n";
+		t.firstEvent = true;
+	}
+
+	t.flusher = std::jthread([](std::stop_token stopToken) {
+		std::mutex waitMutex;
+		std::condition_variable_any wakeup;
+		std::unique_lock lock(waitMutex);
+		while (!stopToken.stop_requested()) {
+			wakeup.wait_for(lock, stopToken, FLUSH_INTERVAL, [] { return false; });
+			drainRings();
+		}
+	});
+
+	t.enabled.store(true, std::memory_order_relaxed);
+	return true;
+}
+
+void Trace::stop() {
+	Tracer& t = tracer();
+	if (!t.flusher.joinable()) {
+		return;
+	}
+	t.enabled.store(false, std::memory_order_relaxed);
+	t.flusher.request_stop();
+	t.flusher.join();
+	drainRings();
+
+	std::lock_guard lock(t.fileMutex);
+	uint64_t dropped = 0;
+	{
+		std::lock_guard ringsLock(t.ringsMutex);
+		for (const auto& ring : t.rings) {
+			dropped += ring->dropped.load(std::memory_order_relaxed);
+		}
+	}
+	if (dropped > 0) {
+		// Record lost events as a metadata entry so gaps are not mistaken for idle time
+		t.file << (t.firstEvent ? "" : ",\n")
+			<< "{\"name\":\"dropped_events\",\"ph\":\"M\",\"pid\":1,\"args\":{\"count\":" << dropped << "}}";
+	}
+	t.file << "\n]\n";
+	t.file.close();
+}
+
+bool Trace::enabled() {
+	return tracer().enabled.load(std::memory_order_relaxed);
+}
+
+int64_t Trace::now() {
+	auto elapsed = std::chrono::steady_clock::now() - tracer().origin;
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
+void Trace::complete(const char* name, const char* category, int64_t startNs, int64_t endNs) {
+	if (!enabled()) {
+		return;
+	}
+
+	Ring& ring = localRing();
+	uint64_t head = ring.head.load(std::memory_order_relaxed);
+	if (head - ring.tail.load(std::memory_order_acquire) >= RING_CAPACITY) {
+		ring.dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	ring.events[head & (RING_CAPACITY - 1)] = Event{ name, category, startNs, endNs };
+	ring.head.store(head + 1, std::memory_order_release);
+}
+
+TraceSpan::TraceSpan(const char* spanName, const char* spanCategory)
+	: name(spanName), category(spanCategory), startNs(Trace::enabled() ? Trace::now() : -1) {
+}
+
+TraceSpan::~TraceSpan() {
+	if (startNs >= 0) {
+		Trace::complete(name, category, startNs, Trace::now());
+	}
+}
\ No newline at end of file
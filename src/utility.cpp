@@ -1,64 +1,99 @@
 #include "utility.h"
+#include <algorithm>
 #include <iostream>
 #include <random>
+#include <chrono>
+#include "trace.h"
+#include "localization.h"
+#include "console.h"
+#include "layout.h"
 
 void printBorderedText(const std::vector<std::string>& content) {
 	char verticalBorderChar = '-';
+	size_t width = Layout::width();
 
-	// Find the longest line
+	// Wrap to fit the leading space, measuring the longest line in the same pass
+	std::string body;
+	std::string wrapped;
 	size_t maxLength = 0;
 	for (const auto& line : content) {
-		if (line.length() > maxLength) {
-			maxLength = line.length();
+		wrapped.clear();
+		Layout::wrap(wrapped, line, width > 1 ? width - 1 : 0);
+		for (const std::string& part : splitLines(wrapped)) {
+			maxLength = std::max(maxLength, Layout::displayWidth(part));
+			body += " ";
+			body += part;
+			body += '\n';
 		}
 	}
 
-	std::string verticalBorder(maxLength + 2, verticalBorderChar);
-	std::cout << verticalBorder << '\n';
+	size_t borderLength = width > 0 ? std::min(maxLength + 2, width) : maxLength + 2;
+	std::string verticalBorder(borderLength, verticalBorderChar);
+	std::string output = verticalBorder + '\n' + body + verticalBorder + '\n';
+	Console::out().write(output.data(), static_cast<std::streamsize>(output.size()));
+}
 
-	for (const auto& line : content) {
-		std::cout << " " << line << '\n';
+std::vector<std::string> splitLines(std::string_view text) {
+	std::vector<std::string> lines;
+	size_t start = 0;
+	while (start <= text.size()) {
+		size_t end = text.find('\n', start);
+		if (end == std::string_view::npos) end = text.size();
+		lines.emplace_back(text.substr(start, end - start));
+		start = end + 1;
 	}
-
-	std::cout << verticalBorder << '\n';
+	return lines;
 }
 
 int rollDice(int max) {
-	std::random_device rd;
-	std::mt19937 gen(rd());
+	// Seed once per thread instead of opening the random device for every roll
+	thread_local std::mt19937 gen(std::random_device{}());
 	std::uniform_int_distribution<> dist(1, max);
 	return dist(gen);
 }
 
-void validateInput(size_t& choice, size_t maxSize) {
+FastRng::FastRng(uint64_t seed) {
+	// splitmix64 spreads low-entropy seeds; xorshift must never start at zero
+	uint64_t z = seed + 0x9E3779B97F4A7C15ULL;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	state = (z ^ (z >> 31)) | 1;
+}
+
+void validateInput(size_t& choice, size_t maxSize, std::span<const CommandVerb> verbs) {
+	TraceSpan span("input wait", "input");
+	CommandReader& reader = Console::commands();
 	int maxAttempts = 5;
 	int attempts = 0;
 
 	while (attempts < maxAttempts) {
-		// Get and assign input and is valid
-		if (std::cin >> choice && (choice <= maxSize || choice == 0)) {
-			// Valid input, check for spacing
-			char nextChar;
-			if (std::cin.get(nextChar) && nextChar != '\n') {
-				// Has spacing invalid input
-				std::cout << "Invalid choice. Please try again: ";
-				std::cin.clear();
-				std::cin.ignore(10000, '\n');
-				attempts++;
+		Command command;
+		bool malformed;
+		if (reader.next(Console::in(), command, malformed)) {
+			if (command.argument && !verbs.empty()) {
+				continue;
 			}
-			else {
+			size_t option;
+			if (resolveCommand(reader, command, verbs, option) && option <= maxSize) {
+				choice = option;
 				return;
 			}
 		}
-		else {
-			// Invalid input
-			std::cout << "Invalid choice. Please try again: ";
-			std::cin.clear();
-			std::cin.ignore(10000, '\n');
-			attempts++;
+		else if (!malformed) {
+			// End of input
+			Console::in().clear();
 		}
+		// Invalid input, the rest of the line goes with it
+		Console::out() << tr(StringID::INVALID_INPUT);
+		reader.discard();
+		attempts++;
 	}
-	std::cout << "\nToo many invalid attempts. Defaulting to 0.\n\n";
+	Console::out() << tr(StringID::TOO_MANY_ATTEMPTS);
 	choice = 0;
 	return;
+}
+
+void pacingDelay(int milliseconds) {
+	TraceSpan span("pacing wait", "pacing");
+	Console::pause(std::chrono::milliseconds(milliseconds));
 }
\ No newline at end of file